@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2023 The Xaya developers
+// Copyright (C) 2021-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -8,21 +8,79 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <utility>
+
 namespace ethutils
 {
 
 /* ************************************************************************** */
 
+namespace
+{
+
+/**
+ * Converts 0x-prefixed hex data to a binary buffer for AbiDecoder.
+ * The data may come from untrusted sources (e.g. RPC results), so it is
+ * not logged on errors.
+ */
+std::shared_ptr<const std::string>
+DecodeHexData (const std::string& str)
+{
+  CHECK_EQ (str.substr (0, 2), "0x") << "Missing 0x prefix on ABI data";
+
+  auto res = std::make_shared<std::string> ();
+  CHECK (UnhexlifyAnyCase (std::string_view (str).substr (2), *res))
+      << "Invalid hex data of size " << str.size ();
+
+  return res;
+}
+
+/**
+ * Charges the given cost against the remaining decoding budget (see
+ * AbiCodec), CHECK-failing if it is exhausted.
+ */
+void
+ChargeBudget (size_t& budget, const size_t cost)
+{
+  CHECK_LE (cost, budget)
+      << "Decoded data exceeds the payload size (overlapping tail data?)";
+  budget -= cost;
+}
+
+/**
+ * Returns a 0x-prefixed hex string for the given binary data.
+ */
+std::string
+HexWithPrefix (const std::string_view bin)
+{
+  std::string res(2 + 2 * bin.size (), '\0');
+  res[0] = '0';
+  res[1] = 'x';
+  Hexlify (reinterpret_cast<const unsigned char*> (bin.data ()), bin.size (),
+           &res[2]);
+  return res;
+}
+
+} // anonymous namespace
+
+AbiDecoder::AbiDecoder (std::shared_ptr<const std::string> o,
+                        const std::string_view d)
+  : owned(std::move (o)), data(d)
+{}
+
 AbiDecoder::AbiDecoder (const std::string& str)
-  : data(str.substr (2)), in(data), parent(nullptr), parentOffset(0)
+  : AbiDecoder(DecodeHexData (str), std::string_view ())
 {
-  CHECK_EQ (str.substr (0, 2), "0x") << "Missing 0x prefix:\n" << str;
+  data = *owned;
 }
 
 AbiDecoder::AbiDecoder (AbiDecoder& other, const size_t start)
-  : data(other.data.substr (2 * start)), in(data),
-    parent(&other), parentOffset(start)
-{}
+  : owned(other.owned), parent(&other), parentOffset(start)
+{
+  CHECK_LE (start, other.data.size ()) << "Dynamic data offset out of range";
+  data = other.data.substr (start);
+}
 
 AbiDecoder::~AbiDecoder ()
 {
@@ -33,16 +91,190 @@ AbiDecoder::~AbiDecoder ()
     }
 }
 
-std::string
+AbiDecoder
+AbiDecoder::FromBinary (const std::string_view bin)
+{
+  return AbiDecoder (nullptr, bin);
+}
+
+std::string_view
 AbiDecoder::ReadBytes (const size_t len)
 {
-  std::string res(2 * len, '\0');
-  in.read (&res[0], res.size ());
-  CHECK (in) << "Error reading data, EOF?";
+  CHECK_LE (len, data.size () - headEnd) << "Error reading data, EOF?";
+  const std::string_view res = data.substr (headEnd, len);
   headEnd += len;
   return res;
 }
 
+size_t
+AbiDecoder::ReadSize ()
+{
+  size_t end = 0;
+  const size_t res = SizeAt (data, headEnd, end);
+  headEnd += 32;
+  return res;
+}
+
+std::string_view
+AbiDecoder::WordAt (const std::string_view d, const size_t pos, size_t& end)
+{
+  CHECK (pos <= d.size () && d.size () - pos >= 32)
+      << "Error reading data, EOF?";
+  end = std::max (end, pos + 32);
+  return d.substr (pos, 32);
+}
+
+uint64_t
+AbiDecoder::UintAt (const std::string_view d, const size_t pos,
+                    const unsigned bits, size_t& end)
+{
+  const std::string_view word = WordAt (d, pos, end);
+  const size_t pad = 32 - bits / 8;
+
+  uint64_t res = 0;
+  for (size_t i = 0; i < word.size (); ++i)
+    {
+      const unsigned char b = word[i];
+      if (i < pad)
+        CHECK_EQ (b, 0) << "Value exceeds " << bits << " bits";
+      else
+        res = (res << 8) | b;
+    }
+
+  return res;
+}
+
+int64_t
+AbiDecoder::IntAt (const std::string_view d, const size_t pos,
+                   const unsigned bits, size_t& end)
+{
+  const std::string_view word = WordAt (d, pos, end);
+  const size_t pad = 32 - bits / 8;
+  const unsigned char fill = (word[pad] & 0x80) ? 0xFF : 0;
+
+  uint64_t res = 0;
+  for (size_t i = 0; i < word.size (); ++i)
+    {
+      const unsigned char b = word[i];
+      if (i < pad)
+        CHECK_EQ (b, fill) << "Value exceeds " << bits << " bits";
+      else
+        res = (res << 8) | b;
+    }
+
+  /* If the value has less than 64 bits, the sign extension is part
+     of the low 64 bits already.  */
+  if (bits < 64 && fill != 0)
+    res |= ~static_cast<uint64_t> (0) << bits;
+
+  return static_cast<int64_t> (res);
+}
+
+Uint256
+AbiDecoder::Uint256At (const std::string_view d, const size_t pos,
+                       const unsigned bits, size_t& end)
+{
+  const std::string_view word = WordAt (d, pos, end);
+  for (size_t i = 0; i < 32 - bits / 8; ++i)
+    CHECK_EQ (word[i], '\0') << "Value exceeds " << bits << " bits";
+
+  return Uint256::FromBinary (word);
+}
+
+bool
+AbiDecoder::BoolAt (const std::string_view d, const size_t pos, size_t& end)
+{
+  const uint64_t val = UintAt (d, pos, 8, end);
+  CHECK_LE (val, 1) << "Invalid bool value";
+  return val != 0;
+}
+
+Address
+AbiDecoder::AddressAt (const std::string_view d, const size_t pos,
+                       size_t& end)
+{
+  const std::string_view word = WordAt (d, pos, end);
+  for (size_t i = 0; i < 32 - Address::BINARY_SIZE; ++i)
+    CHECK_EQ (word[i], '\0') << "Value exceeds 160 bits";
+
+  return Address (HexWithPrefix (word.substr (32 - Address::BINARY_SIZE)));
+}
+
+std::string_view
+AbiDecoder::FixedBytesAt (const std::string_view d, const size_t pos,
+                          const size_t n, size_t& end)
+{
+  const std::string_view word = WordAt (d, pos, end);
+  for (size_t i = n; i < word.size (); ++i)
+    CHECK_EQ (word[i], '\0') << "Padding is not just zeros";
+
+  return word.substr (0, n);
+}
+
+size_t
+AbiDecoder::SizeAt (const std::string_view d, const size_t pos, size_t& end)
+{
+  const std::string_view word = WordAt (d, pos, end);
+
+  uint64_t res = 0;
+  for (size_t i = 0; i < word.size (); ++i)
+    {
+      const unsigned char b = word[i];
+      if (i < 24)
+        CHECK_EQ (b, 0) << "Integer overflow?";
+      else
+        res = (res << 8) | b;
+    }
+  CHECK_LE (res, static_cast<uint64_t> (INT64_MAX)) << "Integer overflow?";
+
+  return res;
+}
+
+size_t
+AbiDecoder::OffsetAt (const std::string_view d, const size_t base,
+                      const size_t slot, size_t& end)
+{
+  const size_t ptr = SizeAt (d, slot, end);
+  CHECK (base <= d.size () && ptr <= d.size () - base)
+      << "Dynamic data offset out of range";
+  return base + ptr;
+}
+
+size_t
+AbiDecoder::ArrayLengthAt (const std::string_view d, const size_t pos,
+                           const size_t elemHead, size_t& end, size_t& budget)
+{
+  const size_t len = SizeAt (d, pos, end);
+
+  /* Each element takes up at least its head size after the length word.
+     Even elements without any data (empty tuples) are limited by the
+     data size, so that a bogus length cannot make us allocate
+     arbitrary amounts of memory.  */
+  const size_t remaining = d.size () - (pos + 32);
+  CHECK_LE (len, remaining / std::max<size_t> (elemHead, 1))
+      << "Array length exceeds the data";
+  ChargeBudget (budget, 32 + len * std::max<size_t> (elemHead, 1));
+
+  return len;
+}
+
+std::string_view
+AbiDecoder::BytesAt (const std::string_view d, const size_t pos, size_t& end,
+                     size_t& budget)
+{
+  const size_t len = SizeAt (d, pos, end);
+  const size_t start = pos + 32;
+  const size_t padded = (len + 31) / 32 * 32;
+  CHECK_LE (padded, d.size () - start) << "Error reading data, EOF?";
+
+  for (size_t i = len; i < padded; ++i)
+    CHECK_EQ (d[start + i], '\0') << "Padding is not just zeros";
+  end = std::max (end, start + padded);
+  ChargeBudget (budget, 32 + padded);
+
+  return d.substr (start, len);
+}
+
 std::string
 AbiDecoder::ReadUint (const int bits)
 {
@@ -50,12 +282,23 @@ AbiDecoder::ReadUint (const int bits)
   const size_t numBytes = bits / 8;
   CHECK_LE (numBytes, 32) << "Max uint size is 256 bits";
 
-  const std::string data256 = ReadBytes (32);
-  const size_t expectedZeros = 2 * (32 - numBytes);
-  CHECK_EQ (data256.substr (0, expectedZeros),
-            std::string (expectedZeros, '0'));
+  const std::string_view data256 = ReadBytes (32);
+  const size_t expectedZeros = 32 - numBytes;
+  for (size_t i = 0; i < expectedZeros; ++i)
+    CHECK_EQ (data256[i], '\0') << "Value exceeds " << bits << " bits";
 
-  return "0x" + data256.substr (expectedZeros);
+  return HexWithPrefix (data256.substr (expectedZeros));
+}
+
+void
+AbiDecoder::ReadUint (const int bits, Uint256& out)
+{
+  CHECK_EQ (bits % 8, 0) << "Invalid bit size: " << bits;
+  CHECK (bits > 0 && bits <= 256) << "Invalid bit size: " << bits;
+
+  size_t end = 0;
+  out = Uint256At (data, headEnd, bits, end);
+  headEnd += 32;
 }
 
 AbiDecoder
@@ -63,7 +306,7 @@ AbiDecoder::ReadDynamic ()
 {
   /* In the actual data stream we have just a pointer to the tail data
      where the real data for the dynamic entity is.  */
-  const size_t ptr = ParseInt (ReadUint (256));
+  const size_t ptr = ReadSize ();
 
   return AbiDecoder (*this, ptr);
 }
@@ -71,31 +314,53 @@ AbiDecoder::ReadDynamic ()
 std::string
 AbiDecoder::ReadString ()
 {
-  AbiDecoder dec = ReadDynamic ();
-  const size_t len = ParseInt (dec.ReadUint (256));
+  return std::string (ReadStringView ());
+}
 
-  const std::string hexData = dec.ReadBytes (len);
-  /* The data is padded on the right with zero bytes to make up
-     for the total length being a multiple of 32 bytes.  */
-  if (len % 32 != 0)
-    {
-      const size_t skipped = 32 - (len % 32);
-      const std::string zeros = dec.ReadBytes (skipped);
-      CHECK_EQ (zeros, std::string (2 * skipped, '0'))
-          << "Padding is not just zeros";
-    }
+std::string_view
+AbiDecoder::ReadStringView ()
+{
+  /* The string data is read directly with an explicit position, which
+     avoids the overhead of constructing a child decoder.  */
+  const size_t pos = OffsetAt (data, 0, headEnd, tailEnd);
+  headEnd += 32;
 
-  std::string res;
-  CHECK (Unhexlify (hexData, res));
+  size_t budget = data.size ();
+  return BytesAt (data, pos, tailEnd, budget);
+}
 
-  return res;
+size_t
+AbiDecoder::HeadSlot (const size_t index) const
+{
+  CHECK_LT (index, data.size () / 32) << "Error reading data, EOF?";
+  return 32 * index;
+}
+
+void
+AbiDecoder::CheckIndex (const size_t index, const size_t len)
+{
+  CHECK_LT (index, len) << "Array index out of range";
+}
+
+void
+AbiDecoder::Skip (const size_t words)
+{
+  CHECK_LE (words, (data.size () - headEnd) / 32)
+      << "Error reading data, EOF?";
+  headEnd += 32 * words;
+}
+
+void
+AbiDecoder::SkipBytes ()
+{
+  ReadStringView ();
 }
 
 AbiDecoder
 AbiDecoder::ReadArray (size_t& len)
 {
   AbiDecoder dec = ReadDynamic ();
-  len = ParseInt (dec.ReadUint (256));
+  len = dec.ReadSize ();
 
   /* When the elements contain dynamic data, tail pointers in them
      are actually relative to the start of the elements data, not including
@@ -111,38 +376,219 @@ AbiDecoder::ReadArray (size_t& len)
 std::string
 AbiDecoder::GetAllDataRead () const
 {
-  return "0x" + data.substr (0, 2 * std::max (headEnd, tailEnd));
+  return HexWithPrefix (GetAllDataReadBinary ());
+}
+
+std::string_view
+AbiDecoder::GetAllDataReadBinary () const
+{
+  return data.substr (0, std::max (headEnd, tailEnd));
 }
 
 int64_t
 AbiDecoder::ParseInt (const std::string& str)
 {
-  const bool isHex = (str.substr (0, 2) == "0x");
-  const std::string baseIn = str.substr (isHex ? 2 : 0);
-  std::istringstream in(baseIn);
-
-  int64_t res;
-  if (isHex)
-    in >> std::hex;
-  in >> res;
-
-  /* Verify that we did not overflow by encoding back to a string
-     (perhaps with zero paddings) and checking it against the input.  */
-  std::ostringstream out;
-  if (isHex)
-    out << std::hex;
-  out << res;
-  std::ostringstream fullOut;
-  if (isHex)
-    fullOut << "0x";
-  if (out.str ().size () < baseIn.size ())
-    fullOut << std::string (baseIn.size () - out.str ().size (), '0');
-  fullOut << out.str ();
-  CHECK_EQ (fullOut.str (), str) << "Integer overflow?";
+  /* Negative numbers are only supported in decimal.  */
+  const bool negative = (!str.empty () && str[0] == '-');
+  const std::string_view digits
+      = std::string_view (str).substr (negative ? 1 : 0);
+
+  Uint256 val;
+  const bool ok = negative ? Uint256::FromDecimal (digits, val)
+                           : Uint256::Parse (digits, val);
+  CHECK (ok) << "Invalid integer: " << str;
+
+  const uint64_t limit
+      = static_cast<uint64_t> (INT64_MAX) + (negative ? 1 : 0);
+  CHECK (val <= Uint256 (limit)) << "Integer overflow?";
+
+  const uint64_t abs = val.GetLow64 ();
+  if (!negative)
+    return static_cast<int64_t> (abs);
+  if (abs == limit)
+    return INT64_MIN;
+  return -static_cast<int64_t> (abs);
+}
+
+/* ************************************************************************** */
+
+AbiWriter::AbiWriter (const size_t headSize, const size_t capacity)
+  : AbiWriter ("", headSize, capacity)
+{}
+
+AbiWriter::AbiWriter (const std::string_view prefix, const size_t headSize,
+                      const size_t capacity)
+{
+  CHECK_EQ (headSize % 32, 0) << "Invalid head size: " << headSize;
+
+  const size_t base = prefix.size ();
+  buf.reserve (std::max (base + headSize, capacity));
+  buf.append (prefix);
+  buf.resize (base + headSize, '\0');
+  frames.push_back ({base, base, base + headSize, true});
+}
+
+size_t
+AbiWriter::NextSlot (const size_t size)
+{
+  CHECK (!frames.empty ());
+  Frame& top = frames.back ();
+  CHECK_LE (size, top.end - top.next) << "Too many values written";
 
+  const size_t res = top.next;
+  top.next += size;
   return res;
 }
 
+void
+AbiWriter::StartDynamic ()
+{
+  const size_t slot = NextSlot (32);
+  const Frame& top = frames.back ();
+  CHECK (top.dynamic) << "Dynamic value inside static tuple";
+  PutLow64 (slot, buf.size () - top.base);
+}
+
+void
+AbiWriter::PutLow64 (const size_t pos, uint64_t val)
+{
+  for (size_t i = 0; i < 8; ++i)
+    {
+      buf[pos + 31 - i] = static_cast<char> (val & 0xFF);
+      val >>= 8;
+    }
+}
+
+size_t
+AbiWriter::Append (const size_t n)
+{
+  const size_t res = buf.size ();
+  buf.resize (res + n, '\0');
+  return res;
+}
+
+void
+AbiWriter::CheckComplete () const
+{
+  CHECK_EQ (frames.size (), 1) << "Not all tuples and arrays are finished";
+  CHECK_EQ (frames.back ().next, frames.back ().end)
+      << "Not all values have been written";
+}
+
+void
+AbiWriter::WriteUint (const uint64_t val)
+{
+  PutLow64 (NextSlot (32), val);
+}
+
+void
+AbiWriter::WriteUint (const Uint256& val)
+{
+  val.ToBinary (reinterpret_cast<unsigned char*> (&buf[NextSlot (32)]));
+}
+
+void
+AbiWriter::WriteInt (const int64_t val)
+{
+  const size_t slot = NextSlot (32);
+  if (val < 0)
+    std::fill (&buf[slot], &buf[slot] + 24, '\xFF');
+  PutLow64 (slot, static_cast<uint64_t> (val));
+}
+
+void
+AbiWriter::WriteBool (const bool val)
+{
+  PutLow64 (NextSlot (32), val ? 1 : 0);
+}
+
+void
+AbiWriter::WriteAddress (const Address& addr)
+{
+  const auto& bin = addr.GetBinary ();
+  const size_t slot = NextSlot (32);
+  std::copy (bin.begin (), bin.end (),
+             &buf[slot + 32 - Address::BINARY_SIZE]);
+}
+
+void
+AbiWriter::WriteFixedBytes (const std::string_view data)
+{
+  CHECK (!data.empty () && data.size () <= 32)
+      << "Invalid size for bytesN: " << data.size ();
+  std::copy (data.begin (), data.end (), &buf[NextSlot (32)]);
+}
+
+void
+AbiWriter::WriteBytes (const std::string_view data)
+{
+  StartDynamic ();
+  PutLow64 (Append (32), data.size ());
+  const size_t pos = Append ((data.size () + 31) / 32 * 32);
+  std::copy (data.begin (), data.end (), &buf[pos]);
+}
+
+void
+AbiWriter::BeginTuple (const size_t headSize, const bool dynamic)
+{
+  CHECK_EQ (headSize % 32, 0) << "Invalid head size: " << headSize;
+
+  if (dynamic)
+    {
+      StartDynamic ();
+      const size_t base = Append (headSize);
+      frames.push_back ({base, base, base + headSize, true});
+    }
+  else
+    {
+      const size_t start = NextSlot (headSize);
+      frames.push_back ({start, start, start + headSize, false});
+    }
+}
+
+void
+AbiWriter::BeginArray (const size_t len, const size_t elemHeadSize)
+{
+  CHECK_EQ (elemHeadSize % 32, 0) << "Invalid head size: " << elemHeadSize;
+
+  StartDynamic ();
+  PutLow64 (Append (32), len);
+
+  /* Offsets of dynamic elements are relative to the start of the elements,
+     i.e. after the length word.  */
+  const size_t base = Append (len * elemHeadSize);
+  frames.push_back ({base, base, base + len * elemHeadSize, true});
+}
+
+void
+AbiWriter::End ()
+{
+  CHECK_GT (frames.size (), 1) << "No tuple or array to end";
+  CHECK_EQ (frames.back ().next, frames.back ().end)
+      << "Not all values have been written";
+  frames.pop_back ();
+}
+
+const std::string&
+AbiWriter::GetBinary () const
+{
+  CheckComplete ();
+  return buf;
+}
+
+std::string
+AbiWriter::ReleaseBinary ()
+{
+  CheckComplete ();
+  return std::move (buf);
+}
+
+std::string
+AbiWriter::GetHex () const
+{
+  return HexWithPrefix (GetBinary ());
+}
+
 /* ************************************************************************** */
 
 namespace
@@ -184,6 +630,12 @@ AbiEncoder::WriteWord (const std::string& data)
   head << std::string (zeros, '0') << plainData;
 }
 
+void
+AbiEncoder::WriteWord (const Uint256& val)
+{
+  head << Hexlify (val.ToBinary ());
+}
+
 void
 AbiEncoder::WriteDynamic (const std::string& tailData)
 {
@@ -230,18 +682,13 @@ AbiEncoder::ConcatHex (const std::string& a, const std::string& b)
 std::string
 AbiEncoder::FormatInt (const uint64_t val)
 {
-  std::ostringstream out;
-  out << std::hex << val;
-  const std::string hexStr = out.str ();
+  std::string res = Uint256 (val).ToHex ();
 
   /* Make sure there is a full number of bytes at least in the string.  */
-  std::ostringstream res;
-  res << "0x";
-  if (hexStr.size () % 2 > 0)
-    res << '0';
-  res << hexStr;
+  if (res.size () % 2 > 0)
+    res.insert (2, 1, '0');
 
-  return res.str ();
+  return res;
 }
 
 /* ************************************************************************** */
@@ -1,38 +1,99 @@
-// Copyright (C) 2021-2023 The Xaya developers
+// Copyright (C) 2021-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #ifndef ETHUTILS_ABI_HPP
 #define ETHUTILS_ABI_HPP
 
+#include "address.hpp"
+#include "parallel.hpp"
+#include "uint256.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace ethutils
 {
 
 /**
- * Helper class for decoding data from an ABI-encoded hex string.
+ * Describes how values of the C++ type T are decoded from ABI data with
+ * AbiDecoder::Decode and encoded with AbiWriter.  Specialisations are
+ * provided for these types:
+ *
+ *  - bool and the fixed-size integer types (for uintN and intN, with N up
+ *    to the width of the C++ type)
+ *  - Uint256 (for uintN of any size)
+ *  - Address (for address)
+ *  - std::array<unsigned char, N> (for bytesN)
+ *  - std::string and std::string_view (for bytes and string)
+ *  - std::vector<T> (for dynamic arrays T[])
+ *  - std::tuple<Ts...> (for tuples)
+ *
+ * Each specialisation defines DYNAMIC (whether the type is dynamic in the
+ * ABI), HEAD_SIZE (the number of bytes it takes up in the head part of an
+ * enclosing tuple) and static Read and Write functions.  Read decodes the
+ * value whose encoding starts at pos in the data, and raises end to the end
+ * of all data it accessed.  Write writes a value as the next member of the
+ * tuple or array that is being written by an AbiWriter.
+ *
+ * Dynamic arrays and bytes values read are charged with the size of their
+ * encoding against a budget, which starts out as the size of the data.
+ * This is never exceeded if the tail data of different values does not
+ * overlap, but it makes decoding CHECK-fail for crafted data that points
+ * many offsets at the same tail data (which could otherwise expand to
+ * a huge number of values).
+ */
+template <typename T, typename Enable = void>
+  struct AbiCodec;
+
+template <typename T>
+  class AbiArrayView;
+
+/**
+ * Helper class for decoding data from an ABI-encoded blob.  The data is held
+ * in binary form, and decoders for dynamic parts (created by ReadDynamic or
+ * ReadArray) share the underlying buffer with their parent and just refer
+ * to a different offset in it, so that decoding nested data does not
+ * copy it around.
  */
 class AbiDecoder
 {
 
 private:
 
-  /** The input data being read (as hex string).  */
-  std::string data;
+  /**
+   * The buffer holding the data, if it is owned by the decoder (i.e. it
+   * was constructed from hex).  It is shared with child decoders.
+   */
+  std::shared_ptr<const std::string> owned;
 
-  /** The stream of input data.  */
-  std::istringstream in;
+  /**
+   * The binary data of this decoder, from its start to the end of the
+   * underlying buffer.
+   */
+  std::string_view data;
 
-  /* The data string passed may not end exactly at the end of this decoder's
+  /* The data may not end exactly at the end of this decoder's actual
      data (for instance, when ReadDynamic is used to construct it).  We keep
      track of the actual data accessed (both in the heads and tail parts),
      so that after reading all, we can then extract the exact data,
      as that can be useful.  */
 
-  /** End pointer in the heads part (first byte not yet accessed).  */
+  /**
+   * End pointer in the heads part (first byte not yet accessed).  This is
+   * also the position from where the next head value is read.
+   */
   size_t headEnd = 0;
 
   /** End pointer in the tail part.  */
@@ -43,29 +104,136 @@ private:
    * this points to the parent decoder.  In this situation, the tailEnd
    * of the parent decoder will be updated when this instance is destructed.
    */
-  AbiDecoder* parent;
+  AbiDecoder* parent = nullptr;
 
   /**
    * If we have a parent, the offset into the parent's data for where our
    * own data starts.
    */
-  size_t parentOffset;
+  size_t parentOffset = 0;
+
+  /**
+   * Constructs a decoder directly on the given buffer.
+   */
+  explicit AbiDecoder (std::shared_ptr<const std::string> o,
+                       std::string_view d);
+
+  /**
+   * Reads the given number of raw bytes from the heads part and returns
+   * them as view into the buffer.
+   */
+  std::string_view ReadBytes (size_t len);
+
+  /**
+   * Reads a 256-bit word that is used as a size or offset, and returns it.
+   * CHECK-fails if the value does not fit into int64_t.
+   */
+  size_t ReadSize ();
+
+  /* The following functions do the actual reading of values for the
+     AbiCodec specialisations.  They work directly on a buffer with
+     explicit positions, CHECK-fail for invalid data like the other read
+     methods, and raise end to the end of the data they access.  */
+
+  /**
+   * Returns the word at pos.
+   */
+  static std::string_view WordAt (std::string_view d, size_t pos,
+                                  size_t& end);
+
+  /**
+   * Reads an unsigned integer of the given bit size (at most 64).
+   */
+  static uint64_t UintAt (std::string_view d, size_t pos, unsigned bits,
+                          size_t& end);
+
+  /**
+   * Reads a signed integer of the given bit size (at most 64).
+   */
+  static int64_t IntAt (std::string_view d, size_t pos, unsigned bits,
+                        size_t& end);
+
+  /**
+   * Reads an unsigned integer of up to 256 bits.
+   */
+  static Uint256 Uint256At (std::string_view d, size_t pos, unsigned bits,
+                            size_t& end);
+
+  static bool BoolAt (std::string_view d, size_t pos, size_t& end);
+  static Address AddressAt (std::string_view d, size_t pos, size_t& end);
+
+  /**
+   * Reads the first n bytes of the word at pos (for bytesN), and verifies
+   * that the remaining bytes are zero.
+   */
+  static std::string_view FixedBytesAt (std::string_view d, size_t pos,
+                                        size_t n, size_t& end);
 
   /**
-   * Reads the given number of bytes as hex characters (i.e. 2n characters)
-   * from the input stream and returns them as hex string.
+   * Reads a word used as size or offset.
    */
-  std::string ReadBytes (size_t len);
+  static size_t SizeAt (std::string_view d, size_t pos, size_t& end);
+
+  /**
+   * Reads the offset in the head slot at slot, and returns the position
+   * of the dynamic data it points to (relative to base).
+   */
+  static size_t OffsetAt (std::string_view d, size_t base, size_t slot,
+                          size_t& end);
+
+  /**
+   * Reads the length of a dynamic array at pos, and checks it against the
+   * remaining data based on the head size of each element.  The size of
+   * the array's encoding is charged against budget.
+   */
+  static size_t ArrayLengthAt (std::string_view d, size_t pos,
+                               size_t elemHead, size_t& end, size_t& budget);
+
+  /**
+   * Reads dynamic bytes or string data (length and padded content) at pos,
+   * and charges its size against budget.
+   */
+  static std::string_view BytesAt (std::string_view d, size_t pos,
+                                   size_t& end, size_t& budget);
+
+  /**
+   * Reads a member of a tuple or array, whose head slot is at slot.
+   * For dynamic types, the slot holds the offset of the actual data
+   * relative to base.
+   */
+  template <typename T>
+    static T ReadMember (std::string_view d, size_t base, size_t slot,
+                         size_t& end, size_t& budget);
+
+  /**
+   * Returns the position of the head slot with the given word index,
+   * CHECK-failing if it is beyond the data.
+   */
+  size_t HeadSlot (size_t index) const;
+
+  /**
+   * CHECK-fails if an index into an array view is out of range.
+   */
+  static void CheckIndex (size_t index, size_t len);
+
+  template <typename T, typename Enable>
+    friend struct AbiCodec;
+  template <typename T>
+    friend class AbiArrayView;
 
 public:
 
+  /**
+   * Constructs a decoder from hex data with 0x prefix.  The hex string is
+   * converted to binary once here, and must be valid hex (in either case).
+   */
   explicit AbiDecoder (const std::string& str);
 
   /**
    * Constructs a decoder based on the data of the given other decoder,
-   * starting at a given index (by bytes, not hex characters).  If this
-   * method is used, then the end-mark of the underlying decoder will be
-   * updated based on data read from here once this decoder is destructed.
+   * starting at a given index (by bytes).  If this method is used, then
+   * the end-mark of the underlying decoder will be updated based on data
+   * read from here once this decoder is destructed.
    */
   explicit AbiDecoder (AbiDecoder& other, size_t start);
 
@@ -77,12 +245,25 @@ public:
   AbiDecoder (AbiDecoder&&) = default;
   AbiDecoder& operator= (AbiDecoder&&) = default;
 
+  /**
+   * Constructs a decoder directly on raw binary data, without copying it.
+   * The data must remain valid while the decoder and any decoders or views
+   * obtained from it are in use.
+   */
+  static AbiDecoder FromBinary (std::string_view bin);
+
   /**
    * Reads a blob of fixed bit size (e.g. uint256 or address/uint160).
    * It is returned as hex string with 0x prefix again.
    */
   std::string ReadUint (int bits);
 
+  /**
+   * Reads an unsigned integer of the given bit size directly into
+   * a Uint256 value.
+   */
+  void ReadUint (int bits, Uint256& out);
+
   /**
    * Reads a generic dynamic piece of data.  This returns a new AbiDecoder
    * instance that is based on the tail data.
@@ -94,18 +275,74 @@ public:
    */
   std::string ReadString ();
 
+  /**
+   * Reads a string value like ReadString, but returns it as view into
+   * the underlying buffer instead of copying it.
+   */
+  std::string_view ReadStringView ();
+
   /**
    * Reads a dynamic array.  It sets the length in the output argument,
    * and returns a new decoder that will return the elements one by one.
    */
   AbiDecoder ReadArray (size_t& len);
 
+  /**
+   * Reads a dynamic array T[] (with T as for Decode) as a view, which
+   * decodes the elements on demand instead of all at once.  The length
+   * is validated against the data here, and the element heads count as
+   * read for GetAllDataRead (but not any tail data of the elements).
+   */
+  template <typename T>
+    AbiArrayView<T> ReadArrayView ();
+
+  /**
+   * Decodes values of the given C++ types (see AbiCodec) as if they were
+   * members of a tuple whose head part starts at the current read position.
+   * The head offsets of all members are computed at compile time, and only
+   * dynamic members follow their tail offset (which is relative to the
+   * start of this decoder's data, as for ReadDynamic).  For instance,
+   * Decode<std::string, Address, uint64_t> () reads a string, an address
+   * and an integer.
+   */
+  template <typename... Ts>
+    std::tuple<Ts...> Decode ();
+
+  /**
+   * Reads a value of type T (see AbiCodec) whose head is at the given word
+   * index in the heads part, independently of the current read position
+   * (which is not changed).  This allows reading just the fields that are
+   * needed from a large blob.  The data accessed counts as read for
+   * GetAllDataRead as with sequential reads.
+   */
+  template <typename T>
+    T ReadAt (size_t index);
+
+  /**
+   * Skips the given number of words in the heads part (e.g. for static
+   * values that are not needed).  The words must be present in the data.
+   */
+  void Skip (size_t words = 1);
+
+  /**
+   * Skips a dynamic bytes or string value.  Its bounds and padding are
+   * validated and it counts as read for GetAllDataRead, but the data itself
+   * is not copied.
+   */
+  void SkipBytes ();
+
   /**
    * Returns the full data (as hex string) actually read so far from
    * this decoder, based on our tracked end positions.
    */
   std::string GetAllDataRead () const;
 
+  /**
+   * Returns the data actually read so far like GetAllDataRead, but as view
+   * of the raw binary data.
+   */
+  std::string_view GetAllDataReadBinary () const;
+
   /**
    * Parses a string (hex or decimal) as integer, verifying that
    * it fits into int64_t.
@@ -114,6 +351,686 @@ public:
 
 };
 
+
+/**
+ * A view of a dynamic array T[] in ABI data, as returned by
+ * AbiDecoder::ReadArrayView.  It just references the elements in the
+ * underlying buffer (which it keeps alive if owned by the decoder), so that
+ * its memory usage is independent of the array length.  The head slot of
+ * each element is at a fixed position, so any element can be decoded
+ * in constant time, without going through the ones before it.
+ *
+ * Elements are decoded as AbiCodec<T>, and invalid element data CHECK-fails
+ * when the element is accessed.
+ */
+template <typename T>
+  class AbiArrayView
+{
+
+private:
+
+  /** The buffer holding the data, if owned (see AbiDecoder).  */
+  std::shared_ptr<const std::string> owned;
+
+  /** The data that offsets of elements are resolved in.  */
+  std::string_view data;
+
+  /** Position of the first element's head slot (after the length).  */
+  size_t base = 0;
+
+  /** Number of elements.  */
+  size_t len = 0;
+
+  explicit AbiArrayView (std::shared_ptr<const std::string> o,
+                         const std::string_view d,
+                         const size_t b, const size_t l)
+    : owned(std::move (o)), data(d), base(b), len(l)
+  {}
+
+  friend class AbiDecoder;
+
+public:
+
+  /**
+   * Iterator over the elements, which decodes each element when it is
+   * dereferenced.
+   */
+  class Iterator
+  {
+
+  private:
+
+    const AbiArrayView* view;
+    size_t index;
+
+    explicit Iterator (const AbiArrayView& v, const size_t i)
+      : view(&v), index(i)
+    {}
+
+    friend class AbiArrayView;
+
+  public:
+
+    using iterator_category = std::input_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = T;
+
+    T
+    operator* () const
+    {
+      return (*view)[index];
+    }
+
+    Iterator&
+    operator++ ()
+    {
+      ++index;
+      return *this;
+    }
+
+    Iterator
+    operator++ (int)
+    {
+      Iterator res = *this;
+      ++index;
+      return res;
+    }
+
+    friend bool
+    operator== (const Iterator& a, const Iterator& b)
+    {
+      return a.view == b.view && a.index == b.index;
+    }
+
+    friend bool
+    operator!= (const Iterator& a, const Iterator& b)
+    {
+      return !(a == b);
+    }
+
+  };
+
+  /**
+   * Constructs an empty view.
+   */
+  AbiArrayView () = default;
+
+  AbiArrayView (const AbiArrayView&) = default;
+  AbiArrayView (AbiArrayView&&) = default;
+  AbiArrayView& operator= (const AbiArrayView&) = default;
+  AbiArrayView& operator= (AbiArrayView&&) = default;
+
+  size_t
+  size () const
+  {
+    return len;
+  }
+
+  bool
+  empty () const
+  {
+    return len == 0;
+  }
+
+  /**
+   * Decodes the element with the given index.  CHECK-fails if the index
+   * is out of range.
+   */
+  T operator[] (size_t index) const;
+
+  Iterator
+  begin () const
+  {
+    return Iterator (*this, 0);
+  }
+
+  Iterator
+  end () const
+  {
+    return Iterator (*this, len);
+  }
+
+  /**
+   * Decodes all elements in parallel on up to the given number of threads
+   * (zero means to use the hardware concurrency), calling fcn(index, value)
+   * for each of them.  The element range is split into contiguous chunks,
+   * and fcn is called concurrently from multiple threads (but each
+   * thread processes the indices of its chunk in order).
+   */
+  template <typename Fcn>
+    void ParallelDecode (unsigned threads, const Fcn& fcn) const;
+
+};
+
+/**
+ * Encoder for ABI data that writes everything in binary form into a single
+ * buffer.  Head slots of each tuple and array are reserved when it is
+ * started, and the offsets of dynamic values are filled into their slots
+ * as the tail data is appended.  This way, nested data is written in place
+ * and never copied around.  The hex form is only produced at the end if
+ * requested with GetHex.
+ *
+ * Values are written in order as the members of the current tuple (or
+ * elements of the current array).  The head size of each tuple has to be
+ * known when it is started; with the typed Write and Encode methods,
+ * it is computed automatically from the C++ types (see AbiCodec).
+ */
+class AbiWriter
+{
+
+private:
+
+  /** A tuple or array that is being written.  */
+  struct Frame
+  {
+
+    /** Position that tail offsets in this frame are relative to.  */
+    size_t base;
+
+    /** Position of the next head slot to write.  */
+    size_t next;
+
+    /** End of the frame's head slots.  */
+    size_t end;
+
+    /**
+     * Whether the frame can hold dynamic values (which is not the
+     * case for static tuples inlined into their parent's head).
+     */
+    bool dynamic;
+
+  };
+
+  /** The buffer with the binary data.  */
+  std::string buf;
+
+  /** The stack of open frames, with the top-level tuple at the bottom.  */
+  std::vector<Frame> frames;
+
+  /**
+   * Reserves the next size bytes of head slots in the current frame,
+   * and returns their position.
+   */
+  size_t NextSlot (size_t size);
+
+  /**
+   * Reserves the next head slot for a dynamic value, and fills in the
+   * offset of the data that will be appended next.
+   */
+  void StartDynamic ();
+
+  /**
+   * Writes a 64-bit value into the low bytes of the word at pos.
+   */
+  void PutLow64 (size_t pos, uint64_t val);
+
+  /**
+   * Appends n zero bytes to the buffer, and returns their position.
+   */
+  size_t Append (size_t n);
+
+  /**
+   * Verifies that all values have been written.
+   */
+  void CheckComplete () const;
+
+public:
+
+  /**
+   * Constructs a writer for a top-level tuple whose head part has the
+   * given size in bytes (i.e. 32 bytes per word).  Optionally, the buffer
+   * can be preallocated to the given capacity.
+   */
+  explicit AbiWriter (size_t headSize, size_t capacity = 0);
+
+  /**
+   * Constructs a writer whose output starts with the given prefix (e.g.
+   * a function selector) before the encoded tuple.  Offsets are relative
+   * to the start of the tuple, i.e. not counting the prefix.
+   */
+  AbiWriter (std::string_view prefix, size_t headSize, size_t capacity = 0);
+
+  AbiWriter (const AbiWriter&) = delete;
+  void operator= (const AbiWriter&) = delete;
+
+  void WriteUint (uint64_t val);
+  void WriteUint (const Uint256& val);
+  void WriteInt (int64_t val);
+  void WriteBool (bool val);
+  void WriteAddress (const Address& addr);
+
+  /**
+   * Writes a bytesN value, with N being the size of the data (1 to 32).
+   */
+  void WriteFixedBytes (std::string_view data);
+
+  /**
+   * Writes a dynamic bytes or string value.
+   */
+  void WriteBytes (std::string_view data);
+
+  /**
+   * Starts writing a tuple (or fixed-size array) with the given head size.
+   * If the tuple is dynamic, its data is appended to the tail and the
+   * current slot gets the offset.  Otherwise it is written inline into
+   * the current head part.  Its members are written with further calls
+   * until End is called.
+   */
+  void BeginTuple (size_t headSize, bool dynamic);
+
+  /**
+   * Starts writing a dynamic array with the given length, where each
+   * element takes up elemHeadSize bytes of head slots.  The elements
+   * are written with further calls until End is called.
+   */
+  void BeginArray (size_t len, size_t elemHeadSize);
+
+  /**
+   * Finishes the current tuple or array.  All its head slots must have
+   * been written.
+   */
+  void End ();
+
+  /**
+   * Writes values of the given C++ types (see AbiCodec) as the next
+   * members of the current tuple.
+   */
+  template <typename... Ts>
+    void Write (const Ts&... vals);
+
+  /**
+   * Encodes the given values as a tuple of the corresponding ABI types,
+   * and returns the binary data.
+   */
+  template <typename... Ts>
+    static std::string Encode (const Ts&... vals);
+
+  /**
+   * Returns the binary data.  All values must have been written.
+   */
+  const std::string& GetBinary () const;
+
+  /**
+   * Moves the binary data out of the writer, which must not be used
+   * afterwards.  All values must have been written.
+   */
+  std::string ReleaseBinary ();
+
+  /**
+   * Returns the data as hex string with 0x prefix.  All values must have
+   * been written.
+   */
+  std::string GetHex () const;
+
+};
+
+/* ************************************************************************** */
+
+template <typename T>
+  T
+  AbiDecoder::ReadMember (const std::string_view d, const size_t base,
+                          const size_t slot, size_t& end, size_t& budget)
+{
+  if constexpr (AbiCodec<T>::DYNAMIC)
+    return AbiCodec<T>::Read (d, OffsetAt (d, base, slot, end), end, budget);
+  else
+    return AbiCodec<T>::Read (d, slot, end, budget);
+}
+
+template <typename T>
+  AbiArrayView<T>
+  AbiDecoder::ReadArrayView ()
+{
+  constexpr size_t elemHead = AbiCodec<T>::HEAD_SIZE;
+
+  const size_t pos = OffsetAt (data, 0, headEnd, tailEnd);
+  headEnd += 32;
+
+  size_t budget = data.size ();
+  const size_t len = ArrayLengthAt (data, pos, elemHead, tailEnd, budget);
+  const size_t base = pos + 32;
+  tailEnd = std::max (tailEnd, base + len * elemHead);
+
+  return AbiArrayView<T> (owned, data, base, len);
+}
+
+template <typename T>
+  T
+  AbiArrayView<T>::operator[] (const size_t index) const
+{
+  AbiDecoder::CheckIndex (index, len);
+
+  /* ReadArrayView has verified already that all heads are within
+     the data.  */
+  constexpr size_t elemHead = AbiCodec<T>::HEAD_SIZE;
+  size_t end = 0;
+  size_t budget = data.size ();
+  return AbiDecoder::ReadMember<T> (data, base, base + index * elemHead, end,
+                                    budget);
+}
+
+template <typename T>
+  template <typename Fcn>
+    void
+    AbiArrayView<T>::ParallelDecode (const unsigned threads,
+                                     const Fcn& fcn) const
+{
+  ParallelFor (len, threads, [&] (const size_t begin, const size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+        fcn (i, (*this)[i]);
+    });
+}
+
+template <typename... Ts>
+  std::tuple<Ts...>
+  AbiDecoder::Decode ()
+{
+  using Codec = AbiCodec<std::tuple<Ts...>>;
+
+  size_t end = tailEnd;
+  size_t budget = data.size ();
+  auto res = Codec::ReadMembers (data, 0, headEnd, end, budget,
+                                 std::index_sequence_for<Ts...> ());
+  headEnd += Codec::INNER_HEAD_SIZE;
+  tailEnd = std::max (tailEnd, end);
+
+  return res;
+}
+
+template <typename T>
+  T
+  AbiDecoder::ReadAt (const size_t index)
+{
+  size_t budget = data.size ();
+  return ReadMember<T> (data, 0, HeadSlot (index), tailEnd, budget);
+}
+
+template <typename... Ts>
+  void
+  AbiWriter::Write (const Ts&... vals)
+{
+  (AbiCodec<Ts>::Write (*this, vals), ...);
+}
+
+template <typename... Ts>
+  std::string
+  AbiWriter::Encode (const Ts&... vals)
+{
+  AbiWriter w(AbiCodec<std::tuple<Ts...>>::INNER_HEAD_SIZE);
+  w.Write (vals...);
+  w.CheckComplete ();
+  return std::move (w.buf);
+}
+
+template <>
+  struct AbiCodec<bool>
+{
+  static constexpr bool DYNAMIC = false;
+  static constexpr size_t HEAD_SIZE = 32;
+
+  static bool
+  Read (const std::string_view d, const size_t pos, size_t& end,
+        size_t&)
+  {
+    return AbiDecoder::BoolAt (d, pos, end);
+  }
+
+  static void
+  Write (AbiWriter& w, const bool val)
+  {
+    w.WriteBool (val);
+  }
+};
+
+template <typename T>
+  struct AbiCodec<T, std::enable_if_t<std::is_integral_v<T>
+                                        && !std::is_same_v<T, bool>>>
+{
+  static_assert (sizeof (T) <= 8, "integer types are at most 64 bits");
+
+  static constexpr bool DYNAMIC = false;
+  static constexpr size_t HEAD_SIZE = 32;
+
+  static T
+  Read (const std::string_view d, const size_t pos, size_t& end,
+        size_t&)
+  {
+    constexpr unsigned bits = 8 * sizeof (T);
+    if constexpr (std::is_signed_v<T>)
+      return static_cast<T> (AbiDecoder::IntAt (d, pos, bits, end));
+    else
+      return static_cast<T> (AbiDecoder::UintAt (d, pos, bits, end));
+  }
+
+  static void
+  Write (AbiWriter& w, const T val)
+  {
+    if constexpr (std::is_signed_v<T>)
+      w.WriteInt (val);
+    else
+      w.WriteUint (val);
+  }
+};
+
+template <>
+  struct AbiCodec<Uint256>
+{
+  static constexpr bool DYNAMIC = false;
+  static constexpr size_t HEAD_SIZE = 32;
+
+  static Uint256
+  Read (const std::string_view d, const size_t pos, size_t& end,
+        size_t&)
+  {
+    return AbiDecoder::Uint256At (d, pos, 256, end);
+  }
+
+  static void
+  Write (AbiWriter& w, const Uint256& val)
+  {
+    w.WriteUint (val);
+  }
+};
+
+template <>
+  struct AbiCodec<Address>
+{
+  static constexpr bool DYNAMIC = false;
+  static constexpr size_t HEAD_SIZE = 32;
+
+  static Address
+  Read (const std::string_view d, const size_t pos, size_t& end,
+        size_t&)
+  {
+    return AbiDecoder::AddressAt (d, pos, end);
+  }
+
+  static void
+  Write (AbiWriter& w, const Address& val)
+  {
+    w.WriteAddress (val);
+  }
+};
+
+template <size_t N>
+  struct AbiCodec<std::array<unsigned char, N>>
+{
+  static_assert (N >= 1 && N <= 32, "invalid bytesN size");
+
+  static constexpr bool DYNAMIC = false;
+  static constexpr size_t HEAD_SIZE = 32;
+
+  static std::array<unsigned char, N>
+  Read (const std::string_view d, const size_t pos, size_t& end,
+        size_t&)
+  {
+    const std::string_view bytes = AbiDecoder::FixedBytesAt (d, pos, N, end);
+    std::array<unsigned char, N> res;
+    std::copy (bytes.begin (), bytes.end (), res.begin ());
+    return res;
+  }
+
+  static void
+  Write (AbiWriter& w, const std::array<unsigned char, N>& val)
+  {
+    w.WriteFixedBytes (std::string_view (
+        reinterpret_cast<const char*> (val.data ()), val.size ()));
+  }
+};
+
+/**
+ * Codec for bytes and string values as view into the underlying buffer,
+ * which must stay valid while the result is used.
+ */
+template <>
+  struct AbiCodec<std::string_view>
+{
+  static constexpr bool DYNAMIC = true;
+  static constexpr size_t HEAD_SIZE = 32;
+
+  static std::string_view
+  Read (const std::string_view d, const size_t pos, size_t& end,
+        size_t& budget)
+  {
+    return AbiDecoder::BytesAt (d, pos, end, budget);
+  }
+
+  static void
+  Write (AbiWriter& w, const std::string_view val)
+  {
+    w.WriteBytes (val);
+  }
+};
+
+template <>
+  struct AbiCodec<std::string>
+{
+  static constexpr bool DYNAMIC = true;
+  static constexpr size_t HEAD_SIZE = 32;
+
+  static std::string
+  Read (const std::string_view d, const size_t pos, size_t& end,
+        size_t& budget)
+  {
+    return std::string (AbiDecoder::BytesAt (d, pos, end, budget));
+  }
+
+  static void
+  Write (AbiWriter& w, const std::string& val)
+  {
+    w.WriteBytes (val);
+  }
+};
+
+template <typename T>
+  struct AbiCodec<std::vector<T>>
+{
+  static constexpr bool DYNAMIC = true;
+  static constexpr size_t HEAD_SIZE = 32;
+
+  static std::vector<T>
+  Read (const std::string_view d, const size_t pos, size_t& end,
+        size_t& budget)
+  {
+    constexpr size_t elemHead = AbiCodec<T>::HEAD_SIZE;
+    const size_t len
+        = AbiDecoder::ArrayLengthAt (d, pos, elemHead, end, budget);
+
+    /* Offsets of dynamic elements are relative to the start of the
+       elements, i.e. after the length word.  */
+    const size_t base = pos + 32;
+
+    std::vector<T> res;
+    res.reserve (len);
+    for (size_t i = 0; i < len; ++i)
+      res.push_back (AbiDecoder::ReadMember<T> (d, base, base + i * elemHead,
+                                                end, budget));
+
+    return res;
+  }
+
+  static void
+  Write (AbiWriter& w, const std::vector<T>& val)
+  {
+    w.BeginArray (val.size (), AbiCodec<T>::HEAD_SIZE);
+    for (const auto& entry : val)
+      AbiCodec<T>::Write (w, entry);
+    w.End ();
+  }
+};
+
+template <typename... Ts>
+  struct AbiCodec<std::tuple<Ts...>>
+{
+  static constexpr bool DYNAMIC = (AbiCodec<Ts>::DYNAMIC || ... || false);
+
+  /** Size of the tuple's own head part, i.e. the heads of all members.  */
+  static constexpr size_t INNER_HEAD_SIZE
+      = (AbiCodec<Ts>::HEAD_SIZE + ... + 0);
+
+  static constexpr size_t HEAD_SIZE = DYNAMIC ? 32 : INNER_HEAD_SIZE;
+
+  /**
+   * Returns the offsets of the members' head slots in the head part.
+   */
+  static constexpr std::array<size_t, sizeof... (Ts)>
+  Offsets ()
+  {
+    constexpr size_t sizes[] = {AbiCodec<Ts>::HEAD_SIZE..., 0};
+
+    std::array<size_t, sizeof... (Ts)> res = {};
+    size_t off = 0;
+    for (size_t i = 0; i < res.size (); ++i)
+      {
+        res[i] = off;
+        off += sizes[i];
+      }
+
+    return res;
+  }
+
+  /**
+   * Reads all members, with the head part starting at head and the
+   * offsets of dynamic members relative to base.
+   */
+  template <size_t... Is>
+    static std::tuple<Ts...>
+    ReadMembers (const std::string_view d, const size_t base,
+                 const size_t head, size_t& end, size_t& budget,
+                 std::index_sequence<Is...>)
+  {
+    [[maybe_unused]] constexpr auto offsets = Offsets ();
+    return std::tuple<Ts...> {
+        AbiDecoder::ReadMember<Ts> (d, base, head + offsets[Is], end,
+                                    budget)...
+    };
+  }
+
+  static std::tuple<Ts...>
+  Read (const std::string_view d, const size_t pos, size_t& end,
+        size_t& budget)
+  {
+    return ReadMembers (d, pos, pos, end, budget,
+                        std::index_sequence_for<Ts...> ());
+  }
+
+  static void
+  Write (AbiWriter& w, const std::tuple<Ts...>& val)
+  {
+    w.BeginTuple (INNER_HEAD_SIZE, DYNAMIC);
+    std::apply ([&w] (const Ts&... members)
+      {
+        w.Write (members...);
+      }, val);
+    w.End ();
+  }
+};
+
+/* ************************************************************************** */
+
 /**
  * Helper class for encoding data into an ABI blob (hex string).
  */
@@ -152,6 +1069,11 @@ public:
    */
   void WriteWord (const std::string& data);
 
+  /**
+   * Writes a word with the given uint256 value.
+   */
+  void WriteWord (const Uint256& val);
+
   /**
    * Writes general dynamic data.  The already-encoded tail part
    * is passed in.  Callers might use another AbiEncoder instance to
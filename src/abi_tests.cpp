@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2022 The Xaya developers
+// Copyright (C) 2021-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -24,6 +24,42 @@ TEST_F (AbiDecoderTests, ParseInt)
   EXPECT_EQ (AbiDecoder::ParseInt ("0000"), 0);
   EXPECT_EQ (AbiDecoder::ParseInt ("0xffaa2"), 0xFFAA2);
   EXPECT_EQ (AbiDecoder::ParseInt ("0x00001234"), 0x1234);
+  EXPECT_EQ (AbiDecoder::ParseInt ("-42"), -42);
+  EXPECT_EQ (AbiDecoder::ParseInt ("9223372036854775807"), INT64_MAX);
+  EXPECT_EQ (AbiDecoder::ParseInt ("-9223372036854775808"), INT64_MIN);
+  EXPECT_EQ (AbiDecoder::ParseInt ("0x7fffffffffffffff"), INT64_MAX);
+
+  EXPECT_DEATH (AbiDecoder::ParseInt ("9223372036854775808"), "overflow");
+  EXPECT_DEATH (AbiDecoder::ParseInt ("0x8000000000000000"), "overflow");
+  EXPECT_DEATH (AbiDecoder::ParseInt ("-0x10"), "Invalid integer");
+  EXPECT_DEATH (AbiDecoder::ParseInt (""), "Invalid integer");
+}
+
+TEST_F (AbiDecoderTests, ReadUint256)
+{
+  AbiDecoder dec("0x"
+      "f0e1d2c3b4a5968778695a4b3c2d1e0f00112233445566778899aabbccddeeff"
+      "00000000000000000000000000000000000000000000000000000000000004d2"
+      "0000000000000000000000000000000000000000000000000000000000000100");
+
+  Uint256 val;
+  dec.ReadUint (256, val);
+  EXPECT_EQ (val.ToHex (), "0x"
+      "f0e1d2c3b4a5968778695a4b3c2d1e0f00112233445566778899aabbccddeeff");
+  dec.ReadUint (16, val);
+  EXPECT_EQ (val, Uint256 (1234));
+  EXPECT_DEATH (dec.ReadUint (8, val), "exceeds 8 bits");
+}
+
+TEST_F (AbiDecoderTests, UpperCaseHex)
+{
+  AbiDecoder dec("0x"
+      "F0E1D2C3B4A5968778695A4B3C2D1E0F00112233445566778899AABBCCDDEEFF"
+      "00000000000000000000000000000000000000000000000000000000000004D2");
+
+  EXPECT_EQ (dec.ReadUint (256), "0x"
+      "f0e1d2c3b4a5968778695a4b3c2d1e0f00112233445566778899aabbccddeeff");
+  EXPECT_EQ (dec.ReadUint (16), "0x04d2");
 }
 
 TEST_F (AbiDecoderTests, DecodeMoveEvent)
@@ -85,6 +121,336 @@ TEST_F (AbiDecoderTests, DecodeStringArray)
   EXPECT_EQ (dec.GetAllDataRead (), data);
 }
 
+TEST_F (AbiDecoderTests, FromBinary)
+{
+  /* This is ("foo", 42) encoded as types (string, uint8).  */
+  const std::string data = "0x"
+      "0000000000000000000000000000000000000000000000000000000000000040"
+      "000000000000000000000000000000000000000000000000000000000000002a"
+      "0000000000000000000000000000000000000000000000000000000000000003"
+      "666f6f0000000000000000000000000000000000000000000000000000000000";
+
+  std::string bin;
+  ASSERT_TRUE (Unhexlify (data.substr (2) + "0042ff", bin));
+
+  AbiDecoder dec = AbiDecoder::FromBinary (bin);
+  const std::string_view str = dec.ReadStringView ();
+  EXPECT_EQ (str, "foo");
+  EXPECT_EQ (str.data (), bin.data () + 3 * 32)
+      << "String view does not point into the input buffer";
+  EXPECT_EQ (dec.ReadUint (8), "0x2a");
+
+  const std::string_view all = dec.GetAllDataReadBinary ();
+  EXPECT_EQ (all.data (), bin.data ());
+  EXPECT_EQ (all.size (), 4 * 32);
+  EXPECT_EQ (dec.GetAllDataRead (), data);
+}
+
+TEST_F (AbiDecoderTests, RandomAccess)
+{
+  /* This is the move event data from DecodeMoveEvent, with heads
+     (string ns, string name, string mv, uint256 nonce, address mover,
+     uint256 amount, address receiver).  */
+  const std::string data = "0x"
+      "00000000000000000000000000000000000000000000000000000000000000e0"
+      "0000000000000000000000000000000000000000000000000000000000000120"
+      "0000000000000000000000000000000000000000000000000000000000000160"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "00000000000000000000000014e663e1531e0f438840952d18720c74c28d4f20"
+      "00000000000000000000000000000000000000000000000000000000000004d2"
+      "000000000000000000000000f0534cc8f4c22972d31105c7ac7b656b581a3a8e"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "7000000000000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000005"
+      "646f6d6f62000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "7b7d000000000000000000000000000000000000000000000000000000000000";
+
+  {
+    AbiDecoder dec(data + "0042ff");
+    EXPECT_EQ (dec.ReadAt<std::string_view> (1), "domob");
+    EXPECT_EQ (dec.GetAllDataReadBinary ().size (), 0x160);
+    EXPECT_EQ (dec.ReadAt<uint64_t> (5), 1234);
+    EXPECT_EQ (dec.ReadAt<Address> (4).GetLowerCase (),
+               "0x14e663e1531e0f438840952d18720c74c28d4f20");
+    EXPECT_EQ (dec.ReadAt<std::string_view> (2), "{}");
+    EXPECT_EQ (dec.GetAllDataRead (), data);
+
+    /* The sequential read position is not affected.  */
+    EXPECT_EQ (dec.ReadString (), "p");
+
+    EXPECT_DEATH (dec.ReadAt<uint64_t> (13), "EOF");
+    EXPECT_DEATH (dec.ReadAt<uint64_t> (SIZE_MAX / 16), "EOF");
+  }
+
+  {
+    AbiDecoder dec(data + "0042ff");
+    dec.SkipBytes ();
+    dec.SkipBytes ();
+    EXPECT_EQ (dec.GetAllDataReadBinary ().size (), 0x160);
+    dec.Skip (2);
+    EXPECT_EQ (dec.ReadUint (160),
+               "0x14e663e1531e0f438840952d18720c74c28d4f20");
+    dec.Skip ();
+    EXPECT_EQ (dec.ReadUint (160),
+               "0xf0534cc8f4c22972d31105c7ac7b656b581a3a8e");
+    EXPECT_EQ (dec.GetAllDataReadBinary ().size (), 0x160);
+
+    EXPECT_DEATH (dec.Skip (7), "EOF");
+    dec.Skip (6);
+    EXPECT_DEATH (dec.SkipBytes (), "EOF");
+  }
+}
+
+TEST_F (AbiDecoderTests, ArrayView)
+{
+  using Entry = std::tuple<uint64_t, std::string>;
+  constexpr size_t n = 1'000;
+
+  std::vector<Entry> entries;
+  for (size_t i = 0; i < n; ++i)
+    entries.emplace_back (i, std::string (i % 40, 'a' + i % 26));
+  std::vector<uint64_t> numbers = {1, 2, 3};
+
+  const std::string bin = AbiWriter::Encode (entries, numbers, true);
+  auto dec = AbiDecoder::FromBinary (bin);
+
+  const auto view = dec.ReadArrayView<Entry> ();
+  ASSERT_EQ (view.size (), n);
+  EXPECT_FALSE (view.empty ());
+  EXPECT_EQ (view[500], entries[500]);
+  EXPECT_EQ (view[0], entries[0]);
+  EXPECT_EQ (view[n - 1], entries[n - 1]);
+  EXPECT_DEATH (view[n], "index out of range");
+
+  size_t i = 0;
+  for (const auto& e : view)
+    EXPECT_EQ (e, entries[i++]);
+  EXPECT_EQ (i, n);
+
+  for (const unsigned threads : {1, 4})
+    {
+      std::vector<Entry> decoded(n);
+      view.ParallelDecode (threads, [&] (const size_t idx, Entry&& e)
+        {
+          decoded[idx] = std::move (e);
+        });
+      EXPECT_EQ (decoded, entries);
+    }
+
+  /* Reading continues with the following heads, and the view can be used
+     independently of the decoder.  */
+  const auto small = dec.ReadArrayView<uint64_t> ();
+  EXPECT_TRUE (dec.ReadAt<bool> (2));
+  EXPECT_EQ (std::vector<uint64_t> (small.begin (), small.end ()), numbers);
+
+  const AbiArrayView<std::string> empty;
+  EXPECT_TRUE (empty.empty ());
+  EXPECT_EQ (empty.begin (), empty.end ());
+}
+
+TEST_F (AbiDecoderTests, ArrayViewInvalidData)
+{
+  /* An array whose length exceeds the data.  */
+  AbiDecoder dec("0x"
+      "0000000000000000000000000000000000000000000000000000000000000020"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "0000000000000000000000000000000000000000000000000000000000000001");
+  EXPECT_DEATH (dec.ReadArrayView<uint64_t> (), "exceeds the data");
+
+  /* The heads are valid, but an element's offset is not.  This is only
+     detected when the element is accessed.  */
+  AbiDecoder dec2("0x"
+      "0000000000000000000000000000000000000000000000000000000000000020"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "0000000000000000000000000000000000000000000000000000000000000100");
+  const auto view = dec2.ReadArrayView<std::string> ();
+  ASSERT_EQ (view.size (), 1);
+  EXPECT_DEATH (view[0], "offset out of range");
+}
+
+TEST_F (AbiDecoderTests, InvalidData)
+{
+  EXPECT_DEATH (AbiDecoder ("0xzz"), "Invalid hex data");
+
+  AbiDecoder dec("0x"
+      "0000000000000000000000000000000000000000000000000000000000000100"
+      "0000000000000000000000000000000000000000000000000000000000000020");
+  EXPECT_DEATH (dec.ReadUint (8), "exceeds 8 bits");
+  EXPECT_DEATH (dec.ReadDynamic (), "offset out of range");
+}
+
+/* ************************************************************************** */
+
+using AbiDecoderTypedTests = testing::Test;
+
+/* The head offsets of tuple members are computed at compile time.  */
+static_assert (AbiCodec<std::tuple<>>::HEAD_SIZE == 0);
+static_assert (!AbiCodec<std::tuple<uint8_t, std::array<unsigned char, 4>>>
+                    ::DYNAMIC);
+static_assert (AbiCodec<std::tuple<bool, std::tuple<int8_t, Address>>>
+                    ::HEAD_SIZE == 96);
+static_assert (AbiCodec<std::tuple<bool, std::vector<bool>>>::HEAD_SIZE == 32);
+static_assert (AbiCodec<std::tuple<uint8_t, std::tuple<bool, bool>,
+                                   std::string>>::Offsets ()[2] == 96);
+
+TEST_F (AbiDecoderTypedTests, MoveEvent)
+{
+  /* This is the same data as for AbiDecoderTests.DecodeMoveEvent.  */
+  const std::string data = "0x"
+      "00000000000000000000000000000000000000000000000000000000000000e0"
+      "0000000000000000000000000000000000000000000000000000000000000120"
+      "0000000000000000000000000000000000000000000000000000000000000160"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "00000000000000000000000014e663e1531e0f438840952d18720c74c28d4f20"
+      "00000000000000000000000000000000000000000000000000000000000004d2"
+      "000000000000000000000000f0534cc8f4c22972d31105c7ac7b656b581a3a8e"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "7000000000000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000005"
+      "646f6d6f62000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "7b7d000000000000000000000000000000000000000000000000000000000000";
+
+  AbiDecoder dec(data + "0042ff");
+  const auto [ns, name, mv, nonce, mover, amount, receiver]
+      = dec.Decode<std::string, std::string, std::string, uint64_t,
+                   Address, uint64_t, Address> ();
+
+  EXPECT_EQ (ns, "p");
+  EXPECT_EQ (name, "domob");
+  EXPECT_EQ (mv, "{}");
+  EXPECT_EQ (nonce, 2);
+  EXPECT_EQ (mover.GetLowerCase (),
+             "0x14e663e1531e0f438840952d18720c74c28d4f20");
+  EXPECT_EQ (amount, 1234);
+  EXPECT_EQ (receiver.GetLowerCase (),
+             "0xf0534cc8f4c22972d31105c7ac7b656b581a3a8e");
+
+  EXPECT_EQ (dec.GetAllDataRead (), data);
+}
+
+TEST_F (AbiDecoderTypedTests, NestedTypes)
+{
+  /* This is (7, ("xaya", [-2, 300]), 0xdeadbeef, true, ["a", ""]) encoded
+     with eth_abi as (uint8, (string, int16[]), bytes4, bool, string[]).  */
+  const std::string data = "0x"
+      "0000000000000000000000000000000000000000000000000000000000000007"
+      "00000000000000000000000000000000000000000000000000000000000000a0"
+      "deadbeef00000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "0000000000000000000000000000000000000000000000000000000000000180"
+      "0000000000000000000000000000000000000000000000000000000000000040"
+      "0000000000000000000000000000000000000000000000000000000000000080"
+      "0000000000000000000000000000000000000000000000000000000000000004"
+      "7861796100000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffe"
+      "000000000000000000000000000000000000000000000000000000000000012c"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "0000000000000000000000000000000000000000000000000000000000000040"
+      "0000000000000000000000000000000000000000000000000000000000000080"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "6100000000000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000000";
+
+  AbiDecoder dec(data);
+  const auto [num, tuple, code, flag, strings]
+      = dec.Decode<uint8_t, std::tuple<std::string_view, std::vector<int16_t>>,
+                   std::array<unsigned char, 4>, bool,
+                   std::vector<std::string>> ();
+
+  EXPECT_EQ (num, 7);
+  EXPECT_EQ (std::get<0> (tuple), "xaya");
+  EXPECT_EQ (std::get<1> (tuple), std::vector<int16_t> ({-2, 300}));
+  EXPECT_EQ (code, (std::array<unsigned char, 4> {0xde, 0xad, 0xbe, 0xef}));
+  EXPECT_TRUE (flag);
+  EXPECT_EQ (strings, std::vector<std::string> ({"a", ""}));
+
+  EXPECT_EQ (dec.GetAllDataRead (), data);
+}
+
+TEST_F (AbiDecoderTypedTests, MixedWithStreamReads)
+{
+  /* This is (5, "foo") encoded as (uint256, string).  Offsets of
+     dynamic data are relative to the start of the decoder, also when
+     Decode is used after other reads.  */
+  AbiDecoder dec("0x"
+      "0000000000000000000000000000000000000000000000000000000000000005"
+      "0000000000000000000000000000000000000000000000000000000000000040"
+      "0000000000000000000000000000000000000000000000000000000000000003"
+      "666f6f0000000000000000000000000000000000000000000000000000000000");
+
+  EXPECT_EQ (dec.ReadUint (256), "0x"
+      "0000000000000000000000000000000000000000000000000000000000000005");
+  EXPECT_EQ (std::get<0> (dec.Decode<std::string> ()), "foo");
+  EXPECT_EQ (dec.GetAllDataReadBinary ().size (), 4 * 32);
+}
+
+TEST_F (AbiDecoderTypedTests, SignedIntegers)
+{
+  AbiDecoder dec("0x"
+      "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff80"
+      "000000000000000000000000000000000000000000000000000000000000007f"
+      "ffffffffffffffffffffffffffffffffffffffffffffffff8000000000000000");
+
+  const auto [a, b, c] = dec.Decode<int8_t, int16_t, int64_t> ();
+  EXPECT_EQ (a, -128);
+  EXPECT_EQ (b, 127);
+  EXPECT_EQ (c, INT64_MIN);
+}
+
+TEST_F (AbiDecoderTypedTests, Uint256)
+{
+  AbiDecoder dec("0x"
+      "0000000000000000000000000000000000000000000000000000000000000040"
+      "f0e1d2c3b4a5968778695a4b3c2d1e0f00112233445566778899aabbccddeeff"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "0000000000000000000000000000000000000000000000000000000000000002");
+
+  const auto [arr, val] = dec.Decode<std::vector<Uint256>, Uint256> ();
+  EXPECT_EQ (arr, std::vector<Uint256> ({Uint256 (1), Uint256 (2)}));
+  EXPECT_EQ (val.ToHex (), "0x"
+      "f0e1d2c3b4a5968778695a4b3c2d1e0f00112233445566778899aabbccddeeff");
+}
+
+TEST_F (AbiDecoderTypedTests, InvalidData)
+{
+  const std::string maxWord = "0x"
+      "00000000000000000000000000000000000000000000000000000000000000ff";
+  EXPECT_DEATH (AbiDecoder (maxWord).Decode<int8_t> (), "exceeds 8 bits");
+  EXPECT_DEATH (AbiDecoder (maxWord).Decode<bool> (), "Invalid bool");
+  EXPECT_DEATH (AbiDecoder (maxWord).Decode<std::string> (),
+                "offset out of range");
+  EXPECT_DEATH ((AbiDecoder (maxWord).Decode<uint8_t, uint8_t> ()),
+                "EOF");
+
+  /* A bytes4 value with non-zero padding.  */
+  AbiDecoder bytes("0x"
+      "deadbeef00000000000000000000000000000000000000000000000000000001");
+  EXPECT_DEATH ((bytes.Decode<std::array<unsigned char, 4>> ()), "Padding");
+
+  /* A uint8[] with a length that exceeds the data.  */
+  AbiDecoder array("0x"
+      "0000000000000000000000000000000000000000000000000000000000000020"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "0000000000000000000000000000000000000000000000000000000000000001");
+  EXPECT_DEATH (array.Decode<std::vector<uint8_t>> (), "Array length");
+
+  /* A uint8[][] whose elements both point to the same inner array.  */
+  AbiDecoder aliased("0x"
+      "0000000000000000000000000000000000000000000000000000000000000020"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "0000000000000000000000000000000000000000000000000000000000000040"
+      "0000000000000000000000000000000000000000000000000000000000000040"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "0000000000000000000000000000000000000000000000000000000000000002");
+  EXPECT_DEATH (aliased.Decode<std::vector<std::vector<uint8_t>>> (),
+                "overlapping tail data");
+}
+
 /* ************************************************************************** */
 
 using AbiEncoderTests = testing::Test;
@@ -97,6 +463,19 @@ TEST_F (AbiEncoderTests, FormatInt)
   EXPECT_EQ (AbiEncoder::FormatInt (0x1234abcd), "0x1234abcd");
 }
 
+TEST_F (AbiEncoderTests, WriteUint256)
+{
+  Uint256 val;
+  ASSERT_TRUE (Uint256::FromDecimal ("123456789012345678901234567890", val));
+
+  AbiEncoder enc(2);
+  enc.WriteWord (val);
+  enc.WriteWord (Uint256 ());
+  EXPECT_EQ (enc.Finalise (), "0x"
+      "00000000000000000000000000000000000000018ee90ff6c373e0ee4e3f0ad2"
+      "0000000000000000000000000000000000000000000000000000000000000000");
+}
+
 TEST_F (AbiEncoderTests, ConcatHex)
 {
   EXPECT_EQ (AbiEncoder::ConcatHex ("0x", "0x"), "0x");
@@ -178,5 +557,160 @@ TEST_F (AbiEncoderTests, ForwarderExecute)
 
 /* ************************************************************************** */
 
+using AbiWriterTests = testing::Test;
+
+/** The Solidity docs example as used in AbiEncoderTests.Dynamic.  */
+const std::string DAVE_EXAMPLE = "0x"
+    "0000000000000000000000000000000000000000000000000000000000000060"
+    "0000000000000000000000000000000000000000000000000000000000000001"
+    "00000000000000000000000000000000000000000000000000000000000000a0"
+    "0000000000000000000000000000000000000000000000000000000000000004"
+    "6461766500000000000000000000000000000000000000000000000000000000"
+    "0000000000000000000000000000000000000000000000000000000000000003"
+    "0000000000000000000000000000000000000000000000000000000000000001"
+    "0000000000000000000000000000000000000000000000000000000000000002"
+    "0000000000000000000000000000000000000000000000000000000000000003";
+
+TEST_F (AbiWriterTests, Dynamic)
+{
+  AbiWriter w(3 * 32);
+  w.WriteBytes ("dave");
+  w.WriteBool (true);
+  w.BeginArray (3, 32);
+  for (unsigned i = 1; i <= 3; ++i)
+    w.WriteUint (i);
+  w.End ();
+
+  EXPECT_EQ (w.GetHex (), DAVE_EXAMPLE);
+}
+
+TEST_F (AbiWriterTests, Prefix)
+{
+  AbiWriter w("\x12\x34\x56\x78", 3 * 32);
+  w.WriteBytes ("dave");
+  w.WriteBool (true);
+  w.BeginArray (3, 32);
+  for (unsigned i = 1; i <= 3; ++i)
+    w.WriteUint (i);
+  w.End ();
+
+  EXPECT_EQ (w.GetHex (), "0x12345678" + DAVE_EXAMPLE.substr (2));
+
+  std::string expected;
+  ASSERT_TRUE (Unhexlify ("12345678" + DAVE_EXAMPLE.substr (2), expected));
+  EXPECT_EQ (w.ReleaseBinary (), expected);
+}
+
+TEST_F (AbiWriterTests, Typed)
+{
+  const std::string bin = AbiWriter::Encode (
+      std::string ("dave"), true, std::vector<uint64_t> ({1, 2, 3}));
+  EXPECT_EQ ("0x" + Hexlify (bin), DAVE_EXAMPLE);
+}
+
+TEST_F (AbiWriterTests, NestedRoundTrip)
+{
+  /* The same data as in AbiDecoderTypedTests.NestedTypes, i.e.
+     (7, ("xaya", [-2, 300]), 0xdeadbeef, true, ["a", ""]) encoded
+     with eth_abi as (uint8, (string, int16[]), bytes4, bool, string[]).  */
+  const std::string data = "0x"
+      "0000000000000000000000000000000000000000000000000000000000000007"
+      "00000000000000000000000000000000000000000000000000000000000000a0"
+      "deadbeef00000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "0000000000000000000000000000000000000000000000000000000000000180"
+      "0000000000000000000000000000000000000000000000000000000000000040"
+      "0000000000000000000000000000000000000000000000000000000000000080"
+      "0000000000000000000000000000000000000000000000000000000000000004"
+      "7861796100000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffe"
+      "000000000000000000000000000000000000000000000000000000000000012c"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "0000000000000000000000000000000000000000000000000000000000000040"
+      "0000000000000000000000000000000000000000000000000000000000000080"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "6100000000000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000000";
+
+  /* Write it with the untyped methods.  */
+  AbiWriter w(5 * 32, data.size () / 2);
+  w.WriteUint (7);
+  w.BeginTuple (2 * 32, true);
+  w.WriteBytes ("xaya");
+  w.BeginArray (2, 32);
+  w.WriteInt (-2);
+  w.WriteInt (300);
+  w.End ();
+  w.End ();
+  w.WriteFixedBytes ("\xde\xad\xbe\xef");
+  w.WriteBool (true);
+  w.BeginArray (2, 32);
+  w.WriteBytes ("a");
+  w.WriteBytes ("");
+  w.End ();
+  EXPECT_EQ (w.GetHex (), data);
+
+  /* Decode and encode again with the typed methods.  */
+  AbiDecoder dec(data);
+  const auto values
+      = dec.Decode<uint8_t, std::tuple<std::string, std::vector<int16_t>>,
+                   std::array<unsigned char, 4>, bool,
+                   std::vector<std::string>> ();
+  const std::string bin = std::apply ([] (const auto&... vals)
+    {
+      return AbiWriter::Encode (vals...);
+    }, values);
+  EXPECT_EQ (bin, w.GetBinary ());
+}
+
+TEST_F (AbiWriterTests, StaticTupleAndUint256)
+{
+  /* ((true, addr), 2^256 - 1) as ((bool, address), uint256).  */
+  const Address addr("0xb18947c38b180a0a162b14ddd09597ac43e931fb");
+  const Uint256 big = Uint256 (1) - Uint256 (2);
+
+  AbiWriter w(3 * 32);
+  w.BeginTuple (2 * 32, false);
+  w.WriteBool (true);
+  w.WriteAddress (addr);
+  w.End ();
+  w.WriteUint (big);
+
+  EXPECT_EQ (w.GetHex (), "0x"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "000000000000000000000000b18947c38b180a0a162b14ddd09597ac43e931fb"
+      "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
+  EXPECT_EQ (AbiWriter::Encode (std::make_tuple (true, addr), big),
+             w.GetBinary ());
+}
+
+TEST_F (AbiWriterTests, Errors)
+{
+  {
+    AbiWriter w(32);
+    w.WriteBool (true);
+    EXPECT_DEATH (w.WriteBool (false), "Too many values");
+  }
+
+  {
+    AbiWriter w(2 * 32);
+    w.WriteBool (true);
+    EXPECT_DEATH (w.GetBinary (), "Not all values");
+    EXPECT_DEATH (w.End (), "No tuple or array");
+  }
+
+  {
+    AbiWriter w(2 * 32);
+    w.BeginTuple (2 * 32, false);
+    EXPECT_DEATH (w.WriteBytes ("foo"), "inside static tuple");
+    w.WriteBool (true);
+    EXPECT_DEATH (w.End (), "Not all values");
+    EXPECT_DEATH (w.GetHex (), "Not all tuples");
+  }
+}
+
+/* ************************************************************************** */
+
 } // anonymous namespace
 } // namespace ethutils
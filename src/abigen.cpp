@@ -0,0 +1,1248 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/* Code generator that reads a JSON ABI file (as produced by solc) and writes
+   a C++ header with structs for the events, functions and errors it defines.
+   Each struct has Decode and Encode methods specialised to its layout,
+   which read and write the binary ABI data directly with the helpers from
+   abiruntime.hpp.  All static head offsets are computed here and appear
+   as constants in the generated code.
+
+   Usage:  abigen [--include-prefix=PREFIX] ABI-FILE NAMESPACE
+
+   The header is written to stdout.  PREFIX is put before "abiruntime.hpp"
+   in the generated include, and defaults to "eth-utils/" to match the
+   installed headers.  The input may also be a build artifact (a JSON object
+   with the ABI in its "abi" field).  */
+
+#include "abitype.hpp"
+#include "hexutils.hpp"
+#include "keccak.hpp"
+
+#include <json/json.h>
+
+#include <glog/logging.h>
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+using ethutils::AbiType;
+
+/** Prefix of the runtime helpers, as used in the generated code.  */
+const std::string RT = "ethutils::abigen::";
+
+/**
+ * Prints an error about the input and exits.
+ */
+[[noreturn]] void
+Fail (const std::string& msg)
+{
+  std::cerr << "abigen: " << msg << std::endl;
+  std::exit (EXIT_FAILURE);
+}
+
+/**
+ * A type as used in the generated code, with the information needed to
+ * generate decoding and encoding code for it.
+ */
+struct GenType
+{
+
+  /** The ABI type itself.  */
+  AbiType abi;
+
+  /** The C++ type for values.  */
+  std::string cpp;
+
+  /** For tuples, the names and types of the struct fields.  */
+  std::vector<std::pair<std::string, std::shared_ptr<const GenType>>> fields;
+
+  /** For arrays, the element type.  */
+  std::shared_ptr<const GenType> elem;
+
+  /**
+   * Returns the size of the head block inside the type's own encoding,
+   * for tuples and fixed arrays.
+   */
+  size_t
+  InnerHead () const
+  {
+    if (abi.GetKind () == AbiType::Kind::FIXED_ARRAY)
+      return abi.GetSize () * elem->abi.GetHeadSize ();
+
+    size_t res = 0;
+    for (const auto& f : fields)
+      res += f.second->abi.GetHeadSize ();
+    return res;
+  }
+
+  /**
+   * Returns true if the type is an elementary value type (which is
+   * stored directly in event topics when indexed).
+   */
+  bool
+  IsValueType () const
+  {
+    switch (abi.GetKind ())
+      {
+      case AbiType::Kind::UINT:
+      case AbiType::Kind::INT:
+      case AbiType::Kind::ADDRESS:
+      case AbiType::Kind::BOOL:
+      case AbiType::Kind::FIXED_BYTES:
+        return true;
+      default:
+        return false;
+      }
+  }
+
+};
+
+using GenTypePtr = std::shared_ptr<const GenType>;
+
+/**
+ * Returns the C++ integer type used for an integer of the given bits,
+ * or an empty string if it needs a full word.
+ */
+std::string
+IntegerCpp (const size_t bits, const bool isSigned)
+{
+  const std::string prefix = isSigned ? "int" : "uint";
+  for (const size_t width : {8, 16, 32, 64})
+    if (bits <= width)
+      return prefix + std::to_string (width) + "_t";
+  return "";
+}
+
+/**
+ * Returns the C++ type for an elementary ABI type.
+ */
+std::string
+ElementaryCpp (const AbiType& t)
+{
+  switch (t.GetKind ())
+    {
+    case AbiType::Kind::UINT:
+      {
+        const std::string res = IntegerCpp (t.GetSize (), false);
+        return res.empty () ? "ethutils::Uint256" : res;
+      }
+    case AbiType::Kind::INT:
+      {
+        const std::string res = IntegerCpp (t.GetSize (), true);
+        return res.empty () ? RT + "Word" : res;
+      }
+    case AbiType::Kind::ADDRESS:
+      return "ethutils::Address::Binary";
+    case AbiType::Kind::BOOL:
+      return "bool";
+    case AbiType::Kind::FIXED_BYTES:
+      return "std::array<unsigned char, " + std::to_string (t.GetSize ())
+                + ">";
+    case AbiType::Kind::BYTES:
+    case AbiType::Kind::STRING:
+      return "std::string";
+    default:
+      LOG (FATAL) << "Not an elementary type: " << t.ToString ();
+      return "";
+    }
+}
+
+/**
+ * Returns true for words that are reserved in C++.  Only those that are
+ * plausible as Solidity identifiers are checked.
+ */
+bool
+IsReserved (const std::string& name)
+{
+  static const std::set<std::string> reserved = {
+    "auto", "bool", "break", "case", "catch", "char", "class", "const",
+    "continue", "default", "delete", "do", "double", "else", "enum",
+    "explicit", "export", "extern", "false", "float", "for", "friend", "goto",
+    "if", "inline", "int", "long", "namespace", "new", "operator", "private",
+    "protected", "public", "register", "return", "short", "signed", "sizeof",
+    "static", "struct", "switch", "template", "this", "throw", "true", "try",
+    "typedef", "typename", "union", "unsigned", "using", "virtual", "void",
+    "volatile", "while",
+  };
+  return reserved.count (name) > 0;
+}
+
+/**
+ * Turns a name from the ABI into a valid C++ identifier.
+ */
+std::string
+Identifier (const std::string& name)
+{
+  std::string res;
+  for (const char c : name)
+    res.push_back (std::isalnum (static_cast<unsigned char> (c)) ? c : '_');
+
+  if (res.empty () || std::isdigit (static_cast<unsigned char> (res[0])))
+    res = "_" + res;
+  if (IsReserved (res))
+    res += "_";
+
+  return res;
+}
+
+/**
+ * Returns the name with its first letter in upper case.
+ */
+std::string
+Capitalise (std::string name)
+{
+  if (!name.empty ())
+    name[0] = std::toupper (static_cast<unsigned char> (name[0]));
+  return name;
+}
+
+/**
+ * Returns a position expression for base plus a constant offset.
+ */
+std::string
+Add (const std::string& base, const size_t off)
+{
+  if (off == 0)
+    return base;
+  if (base == "0")
+    return std::to_string (off);
+  return base + " + " + std::to_string (off);
+}
+
+/**
+ * Returns a position expression for element i of a block at base,
+ * with the given head size per element.
+ */
+std::string
+Element (const std::string& base, const std::string& i, const size_t head)
+{
+  const std::string off = i + " * " + std::to_string (head);
+  if (base == "0")
+    return off;
+  return base + " + " + off;
+}
+
+/**
+ * Returns the expression for a field of a struct value.  The top-level
+ * parameters are members of the generated struct itself, for which
+ * value is empty.  They are accessed through "this", so that they do not
+ * clash with the parameters and local variables of the generated methods
+ * (e.g. an event field called "data").
+ */
+std::string
+Member (const std::string& value, const std::string& name)
+{
+  if (value.empty ())
+    return "this->" + name;
+  return value + "." + name;
+}
+
+/**
+ * Returns a C++ expression for a byte array literal.
+ */
+std::string
+ByteList (const std::string& bin)
+{
+  std::ostringstream out;
+  out << "{";
+  for (size_t i = 0; i < bin.size (); ++i)
+    {
+      if (i > 0)
+        out << ", ";
+      out << "0x" << ethutils::Hexlify (bin.substr (i, 1));
+    }
+  out << "}";
+  return out.str ();
+}
+
+/**
+ * Writer for the generated code, which keeps track of the indentation
+ * and the names of temporary variables.
+ */
+class CodeWriter
+{
+
+private:
+
+  std::ostringstream out;
+
+  /** Current indentation level.  */
+  unsigned indent = 0;
+
+  /** Counter for unique variable names.  */
+  unsigned vars = 0;
+
+public:
+
+  /**
+   * Writes a line of code at the current indentation.
+   */
+  void
+  Line (const std::string& str = "")
+  {
+    if (!str.empty ())
+      out << std::string (2 * indent, ' ') << str;
+    out << '\n';
+  }
+
+  /**
+   * Opens a brace block.
+   */
+  void
+  Open ()
+  {
+    Line ("{");
+    ++indent;
+  }
+
+  /**
+   * Closes a brace block, with an optional suffix after the brace.
+   */
+  void
+  Close (const std::string& suffix = "")
+  {
+    CHECK_GT (indent, 0);
+    --indent;
+    Line ("}" + suffix);
+  }
+
+  /**
+   * Writes a check that returns false from a decoding function.
+   */
+  void
+  Check (const std::string& cond)
+  {
+    Line ("if (!" + cond + ")");
+    ++indent;
+    Line ("return false;");
+    --indent;
+  }
+
+  /**
+   * Returns a new unique variable name.
+   */
+  std::string
+  Var (const std::string& prefix)
+  {
+    return prefix + std::to_string (vars++);
+  }
+
+  std::string
+  Get () const
+  {
+    return out.str ();
+  }
+
+};
+
+/* ************************************************************************** */
+
+/**
+ * The actual generator, which builds the types from the JSON input and
+ * writes the code.
+ */
+class Generator
+{
+
+private:
+
+  /** Code for the structs of tuple types.  */
+  CodeWriter tuples;
+
+  /** Code for the structs of events, functions and errors.  */
+  CodeWriter main;
+
+  /**
+   * The tuple structs defined so far, by the name they are based on and
+   * their fields (C++ type and name of each) to the actual struct name.
+   */
+  std::map<std::pair<std::string, std::string>, std::string> tupleTypes;
+
+  /** All struct names used so far.  */
+  std::set<std::string> usedNames;
+
+  /**
+   * Returns a unique struct name based on the given one.
+   */
+  std::string
+  UniqueName (const std::string& base)
+  {
+    std::string res = base;
+    for (unsigned i = 2; usedNames.count (res) > 0; ++i)
+      res = base + std::to_string (i);
+    usedNames.insert (res);
+    return res;
+  }
+
+  GenTypePtr BuildType (const Json::Value& param, const std::string& owner);
+  GenTypePtr BuildTuple (const Json::Value& param, const std::string& owner);
+  std::vector<std::pair<std::string, GenTypePtr>> BuildFields (
+      const Json::Value& params, const std::string& owner);
+
+  void DecodeAt (CodeWriter& w, const GenType& t, const std::string& bin,
+                 const std::string& pos, const std::string& target);
+  void DecodeSlot (CodeWriter& w, const GenType& t, const std::string& bin,
+                   const std::string& base, const std::string& slot,
+                   const std::string& target);
+
+  void EncodeStatic (CodeWriter& w, const GenType& t, const std::string& buf,
+                     const std::string& pos, const std::string& value);
+  void EncodeDynamic (CodeWriter& w, const GenType& t, const std::string& buf,
+                      const std::string& value);
+  void EncodeSlot (CodeWriter& w, const GenType& t, const std::string& buf,
+                   const std::string& base, const std::string& slot,
+                   const std::string& value);
+
+  /**
+   * Writes the declarations of the given fields.
+   */
+  void WriteFields (CodeWriter& w,
+                    const std::vector<std::pair<std::string, GenTypePtr>>& f);
+
+  /**
+   * Writes the statements that decode the given fields from bin, as
+   * the encoding of their tuple starting at pos.
+   */
+  void DecodeFields (CodeWriter& w, const GenType& tuple,
+                     const std::string& bin, const std::string& pos);
+
+  /**
+   * Writes the statements that append the encoding of the given fields
+   * (as tuple) to buf.
+   */
+  void EncodeFields (CodeWriter& w, const GenType& tuple,
+                     const std::string& buf);
+
+  /**
+   * Constructs a tuple type for the given fields.
+   */
+  static GenType FieldsTuple (
+      const std::vector<std::pair<std::string, GenTypePtr>>& fields);
+
+  /**
+   * Returns the signature of an event, function or error, e.g.
+   * "transfer(address,uint256)".
+   */
+  static std::string Signature (const std::string& name,
+                                const GenType& tuple);
+
+  void GenerateEvent (const Json::Value& entry);
+  void GenerateCall (const Json::Value& entry, const std::string& suffix);
+
+public:
+
+  Generator () = default;
+
+  /**
+   * Processes all entries of the ABI.
+   */
+  void Process (const Json::Value& abi);
+
+  /**
+   * Returns the full generated header.
+   */
+  std::string GetHeader (const std::string& source, const std::string& ns,
+                         const std::string& includePrefix) const;
+
+};
+
+GenTypePtr
+Generator::BuildTuple (const Json::Value& param, const std::string& owner)
+{
+  auto res = std::make_shared<GenType> ();
+
+  /* Use the struct name from the internal type if there is one, e.g.
+     "struct Contract.Item" or "struct Item[]".  */
+  std::string name;
+  const std::string internal = param.get ("internalType", "").asString ();
+  if (internal.substr (0, 7) == "struct ")
+    {
+      name = internal.substr (7);
+      name = name.substr (0, name.find ('['));
+      const size_t dot = name.rfind ('.');
+      if (dot != std::string::npos)
+        name = name.substr (dot + 1);
+    }
+  if (name.empty ())
+    name = owner + Capitalise (param.get ("name", "").asString ())
+              + "Tuple";
+  name = Identifier (name);
+
+  res->fields = BuildFields (param["components"], name);
+
+  std::string canonical = "(";
+  for (size_t i = 0; i < res->fields.size (); ++i)
+    {
+      if (i > 0)
+        canonical += ",";
+      canonical += res->fields[i].second->abi.ToString ();
+    }
+  canonical += ")";
+  if (!AbiType::Parse (canonical, res->abi))
+    Fail ("invalid tuple type " + canonical);
+
+  /* Reuse an existing struct of the same name and fields, e.g. if the
+     same struct is used in multiple functions.  Structs with the same
+     types but different field names are distinct.  */
+  std::string layout;
+  for (const auto& f : res->fields)
+    layout += f.second->cpp + " " + f.first + ";";
+  const auto key = std::make_pair (name, layout);
+  auto mit = tupleTypes.find (key);
+  if (mit != tupleTypes.end ())
+    {
+      res->cpp = mit->second;
+      return res;
+    }
+
+  res->cpp = UniqueName (name);
+  tupleTypes.emplace (key, res->cpp);
+
+  tuples.Line ("/** Struct for the tuple type " + canonical + ".  */");
+  tuples.Line ("struct " + res->cpp);
+  tuples.Open ();
+  WriteFields (tuples, res->fields);
+  tuples.Close (";");
+  tuples.Line ();
+
+  return res;
+}
+
+GenTypePtr
+Generator::BuildType (const Json::Value& param, const std::string& owner)
+{
+  if (!param.isObject () || !param["type"].isString ())
+    Fail ("invalid parameter: " + param.toStyledString ());
+
+  const std::string type = param["type"].asString ();
+  const size_t arrayStart = type.find ('[');
+  const std::string base = type.substr (0, arrayStart);
+
+  GenTypePtr res;
+  if (base == "tuple")
+    res = BuildTuple (param, owner);
+  else
+    {
+      auto elementary = std::make_shared<GenType> ();
+      if (base.find_first_of ("()") != std::string::npos
+            || !AbiType::Parse (base, elementary->abi))
+        Fail ("invalid type: " + type);
+      elementary->cpp = ElementaryCpp (elementary->abi);
+      res = elementary;
+    }
+
+  /* Wrap the base type in each array suffix.  */
+  std::string suffixes
+      = arrayStart == std::string::npos ? "" : type.substr (arrayStart);
+  while (!suffixes.empty ())
+    {
+      const size_t end = suffixes.find (']');
+      if (suffixes[0] != '[' || end == std::string::npos)
+        Fail ("invalid type: " + type);
+
+      auto arr = std::make_shared<GenType> ();
+      const std::string canonical
+          = res->abi.ToString () + suffixes.substr (0, end + 1);
+      if (!AbiType::Parse (canonical, arr->abi))
+        Fail ("invalid type: " + type);
+
+      arr->elem = res;
+      if (arr->abi.GetKind () == AbiType::Kind::FIXED_ARRAY)
+        arr->cpp = "std::array<" + res->cpp + ", "
+                      + std::to_string (arr->abi.GetSize ()) + ">";
+      else
+        arr->cpp = "std::vector<" + res->cpp + ">";
+
+      res = arr;
+      suffixes = suffixes.substr (end + 1);
+    }
+
+  return res;
+}
+
+std::vector<std::pair<std::string, GenTypePtr>>
+Generator::BuildFields (const Json::Value& params, const std::string& owner)
+{
+  if (!params.isNull () && !params.isArray ())
+    Fail ("parameters of " + owner + " are not an array");
+
+  std::vector<std::pair<std::string, GenTypePtr>> res;
+  std::set<std::string> names;
+  for (Json::ArrayIndex i = 0; i < params.size (); ++i)
+    {
+      const Json::Value& p = params[i];
+
+      std::string name = p.get ("name", "").asString ();
+      name = name.empty () ? "arg" + std::to_string (i) : Identifier (name);
+      /* Avoid clashes with the other members of the generated structs.  */
+      if (name == "SIGNATURE" || name == "TOPIC0" || name == "SELECTOR"
+            || name == "Decode" || name == "Encode")
+        name += "_";
+      if (!names.insert (name).second)
+        Fail ("duplicate parameter " + name + " in " + owner);
+
+      res.emplace_back (name, BuildType (p, owner));
+    }
+
+  return res;
+}
+
+GenType
+Generator::FieldsTuple (
+    const std::vector<std::pair<std::string, GenTypePtr>>& fields)
+{
+  GenType res;
+  res.fields = fields;
+
+  std::string canonical = "(";
+  for (size_t i = 0; i < fields.size (); ++i)
+    {
+      if (i > 0)
+        canonical += ",";
+      canonical += fields[i].second->abi.ToString ();
+    }
+  canonical += ")";
+  CHECK (AbiType::Parse (canonical, res.abi)) << canonical;
+
+  return res;
+}
+
+std::string
+Generator::Signature (const std::string& name, const GenType& tuple)
+{
+  return name + tuple.abi.ToString ();
+}
+
+void
+Generator::WriteFields (
+    CodeWriter& w, const std::vector<std::pair<std::string, GenTypePtr>>& f)
+{
+  for (const auto& entry : f)
+    w.Line (entry.second->cpp + " " + entry.first + "{};");
+}
+
+/* ************************************************************************** */
+
+void
+Generator::DecodeAt (CodeWriter& w, const GenType& t, const std::string& bin,
+                     const std::string& pos, const std::string& target)
+{
+  const std::string bits = std::to_string (t.abi.GetSize ());
+  const std::string args = "(" + bin + ", " + pos + ", ";
+
+  switch (t.abi.GetKind ())
+    {
+    case AbiType::Kind::UINT:
+      w.Check (RT + "ReadUint " + args + bits + ", " + target + ")");
+      return;
+
+    case AbiType::Kind::INT:
+      if (t.abi.GetSize () <= 64)
+        w.Check (RT + "ReadInt " + args + bits + ", " + target + ")");
+      else
+        w.Check (RT + "ReadWideWord " + args + bits + ", true, "
+                  + target + ")");
+      return;
+
+    case AbiType::Kind::ADDRESS:
+      w.Check (RT + "ReadAddress " + args + target + ")");
+      return;
+
+    case AbiType::Kind::BOOL:
+      {
+        /* Decode through a temporary, which also works for the element
+           references of std::vector<bool>.  */
+        const std::string v = w.Var ("v");
+        w.Open ();
+        w.Line ("bool " + v + ";");
+        w.Check (RT + "ReadBool " + args + v + ")");
+        w.Line (target + " = " + v + ";");
+        w.Close ();
+        return;
+      }
+
+    case AbiType::Kind::FIXED_BYTES:
+      w.Check (RT + "ReadFixedBytes " + args + target + ")");
+      return;
+
+    case AbiType::Kind::BYTES:
+    case AbiType::Kind::STRING:
+      w.Check (RT + "ReadBytes " + args + "budget, " + target + ")");
+      return;
+
+    case AbiType::Kind::TUPLE:
+      {
+        size_t off = 0;
+        for (const auto& f : t.fields)
+          {
+            DecodeSlot (w, *f.second, bin, pos, Add (pos, off),
+                        Member (target, f.first));
+            off += f.second->abi.GetHeadSize ();
+          }
+        return;
+      }
+
+    case AbiType::Kind::FIXED_ARRAY:
+      {
+        const std::string i = w.Var ("i");
+        w.Line ("for (size_t " + i + " = 0; " + i + " < "
+                  + std::to_string (t.abi.GetSize ()) + "; ++" + i + ")");
+        w.Open ();
+        DecodeSlot (w, *t.elem, bin, pos,
+                    Element (pos, i, t.elem->abi.GetHeadSize ()),
+                    target + "[" + i + "]");
+        w.Close ();
+        return;
+      }
+
+    case AbiType::Kind::ARRAY:
+      {
+        const std::string n = w.Var ("n");
+        const std::string b = w.Var ("b");
+        const std::string i = w.Var ("i");
+        const size_t head = t.elem->abi.GetHeadSize ();
+
+        w.Open ();
+        w.Line ("size_t " + n + ", " + b + ";");
+        w.Check (RT + "ReadArrayLength " + args + std::to_string (head)
+                  + ", budget, " + n + ", " + b + ")");
+        w.Line (target + ".resize (" + n + ");");
+        w.Line ("for (size_t " + i + " = 0; " + i + " < " + n + "; ++"
+                  + i + ")");
+        w.Open ();
+        DecodeSlot (w, *t.elem, bin, b, Element (b, i, head),
+                    target + "[" + i + "]");
+        w.Close ();
+        w.Close ();
+        return;
+      }
+    }
+}
+
+void
+Generator::DecodeSlot (CodeWriter& w, const GenType& t, const std::string& bin,
+                       const std::string& base, const std::string& slot,
+                       const std::string& target)
+{
+  if (!t.abi.IsDynamic ())
+    {
+      DecodeAt (w, t, bin, slot, target);
+      return;
+    }
+
+  const std::string p = w.Var ("p");
+  w.Open ();
+  w.Line ("size_t " + p + ";");
+  w.Check (RT + "ReadOffset (" + bin + ", " + base + ", " + slot + ", "
+            + p + ")");
+  DecodeAt (w, t, bin, p, target);
+  w.Close ();
+}
+
+void
+Generator::EncodeStatic (CodeWriter& w, const GenType& t,
+                         const std::string& buf, const std::string& pos,
+                         const std::string& value)
+{
+  const std::string args = "(" + buf + ", " + pos + ", " + value + ");";
+  const std::string intArgs = "(" + buf + ", " + pos + ", "
+                                + std::to_string (t.abi.GetSize ()) + ", "
+                                + value + ");";
+
+  switch (t.abi.GetKind ())
+    {
+    case AbiType::Kind::UINT:
+      w.Line (RT + "PutUint " + intArgs);
+      return;
+
+    case AbiType::Kind::INT:
+      w.Line (RT + (t.abi.GetSize () <= 64 ? "PutInt " : "PutWideInt ")
+                + intArgs);
+      return;
+
+    case AbiType::Kind::ADDRESS:
+      w.Line (RT + "PutAddress " + args);
+      return;
+
+    case AbiType::Kind::BOOL:
+      w.Line (RT + "PutBool " + args);
+      return;
+
+    case AbiType::Kind::FIXED_BYTES:
+      w.Line (RT + "PutFixedBytes " + args);
+      return;
+
+    case AbiType::Kind::TUPLE:
+      {
+        size_t off = 0;
+        for (const auto& f : t.fields)
+          {
+            EncodeStatic (w, *f.second, buf, Add (pos, off),
+                          Member (value, f.first));
+            off += f.second->abi.GetHeadSize ();
+          }
+        return;
+      }
+
+    case AbiType::Kind::FIXED_ARRAY:
+      {
+        const std::string i = w.Var ("i");
+        w.Line ("for (size_t " + i + " = 0; " + i + " < "
+                  + std::to_string (t.abi.GetSize ()) + "; ++" + i + ")");
+        w.Open ();
+        EncodeStatic (w, *t.elem, buf,
+                      Element (pos, i, t.elem->abi.GetHeadSize ()),
+                      value + "[" + i + "]");
+        w.Close ();
+        return;
+      }
+
+    default:
+      LOG (FATAL) << "Type is not static: " << t.abi.ToString ();
+    }
+}
+
+void
+Generator::EncodeDynamic (CodeWriter& w, const GenType& t,
+                          const std::string& buf, const std::string& value)
+{
+  switch (t.abi.GetKind ())
+    {
+    case AbiType::Kind::BYTES:
+    case AbiType::Kind::STRING:
+      w.Line (RT + "AppendBytes (" + buf + ", " + value + ");");
+      return;
+
+    case AbiType::Kind::TUPLE:
+      {
+        const std::string b = w.Var ("b");
+        w.Open ();
+        w.Line ("const size_t " + b + " = " + RT + "Reserve (" + buf + ", "
+                  + std::to_string (t.InnerHead ()) + ");");
+        size_t off = 0;
+        for (const auto& f : t.fields)
+          {
+            EncodeSlot (w, *f.second, buf, b, Add (b, off),
+                        Member (value, f.first));
+            off += f.second->abi.GetHeadSize ();
+          }
+        w.Close ();
+        return;
+      }
+
+    case AbiType::Kind::FIXED_ARRAY:
+    case AbiType::Kind::ARRAY:
+      {
+        const std::string b = w.Var ("b");
+        const std::string i = w.Var ("i");
+        const size_t head = t.elem->abi.GetHeadSize ();
+
+        std::string len;
+        w.Open ();
+        if (t.abi.GetKind () == AbiType::Kind::ARRAY)
+          {
+            len = value + ".size ()";
+            w.Line (RT + "AppendSize (" + buf + ", " + len + ");");
+          }
+        else
+          len = std::to_string (t.abi.GetSize ());
+
+        w.Line ("const size_t " + b + " = " + RT + "Reserve (" + buf + ", "
+                  + len + " * " + std::to_string (head) + ");");
+        w.Line ("for (size_t " + i + " = 0; " + i + " < " + len + "; ++"
+                  + i + ")");
+        w.Open ();
+        EncodeSlot (w, *t.elem, buf, b, Element (b, i, head),
+                    value + "[" + i + "]");
+        w.Close ();
+        w.Close ();
+        return;
+      }
+
+    default:
+      LOG (FATAL) << "Type is not dynamic: " << t.abi.ToString ();
+    }
+}
+
+void
+Generator::EncodeSlot (CodeWriter& w, const GenType& t, const std::string& buf,
+                       const std::string& base, const std::string& slot,
+                       const std::string& value)
+{
+  if (!t.abi.IsDynamic ())
+    {
+      EncodeStatic (w, t, buf, slot, value);
+      return;
+    }
+
+  w.Line (RT + "PutOffset (" + buf + ", " + base + ", " + slot + ");");
+  EncodeDynamic (w, t, buf, value);
+}
+
+void
+Generator::DecodeFields (CodeWriter& w, const GenType& tuple,
+                         const std::string& bin, const std::string& pos)
+{
+  /* Dynamic arrays and bytes values are charged against a budget of the
+     data size, so that aliased tail data cannot blow up the work.  Only
+     dynamic types contain such values.  */
+  if (tuple.abi.IsDynamic ())
+    w.Line ("size_t budget = " + bin + ".size ();");
+  DecodeAt (w, tuple, bin, pos, "");
+}
+
+void
+Generator::EncodeFields (CodeWriter& w, const GenType& tuple,
+                         const std::string& buf)
+{
+  if (tuple.fields.empty ())
+    return;
+
+  w.Line ("const size_t b = " + RT + "Reserve (" + buf + ", "
+            + std::to_string (tuple.InnerHead ()) + ");");
+  size_t off = 0;
+  for (const auto& f : tuple.fields)
+    {
+      EncodeSlot (w, *f.second, buf, "b", Add ("b", off),
+                  Member ("", f.first));
+      off += f.second->abi.GetHeadSize ();
+    }
+}
+
+/* ************************************************************************** */
+
+void
+Generator::GenerateEvent (const Json::Value& entry)
+{
+  const std::string name = entry["name"].asString ();
+  const std::string structName = UniqueName (Identifier (name + "Event"));
+  const bool anonymous = entry.get ("anonymous", false).asBool ();
+
+  const auto fields = BuildFields (entry["inputs"], structName);
+
+  std::vector<std::pair<std::string, GenTypePtr>> indexed, data;
+  std::vector<std::pair<std::string, GenTypePtr>> declared;
+  for (Json::ArrayIndex i = 0; i < fields.size (); ++i)
+    {
+      if (!entry["inputs"][i].get ("indexed", false).asBool ())
+        {
+          data.push_back (fields[i]);
+          declared.push_back (fields[i]);
+          continue;
+        }
+
+      indexed.push_back (fields[i]);
+
+      /* Indexed reference types are only available as their hash.  */
+      if (fields[i].second->IsValueType ())
+        declared.push_back (fields[i]);
+      else
+        {
+          auto word = std::make_shared<GenType> ();
+          word->abi = fields[i].second->abi;
+          word->cpp = RT + "Word";
+          declared.emplace_back (fields[i].first, word);
+        }
+    }
+
+  const GenType all = FieldsTuple (fields);
+  const GenType dataTuple = FieldsTuple (data);
+  const std::string sgn = Signature (name, all);
+  const size_t numTopics = indexed.size () + (anonymous ? 0 : 1);
+
+  CodeWriter& w = main;
+  w.Line ("/** The event " + sgn + ".  */");
+  w.Line ("struct " + structName);
+  w.Open ();
+  w.Line ("static constexpr const char* SIGNATURE = \"" + sgn + "\";");
+  if (!anonymous)
+    w.Line ("static constexpr " + RT + "Word TOPIC0 = "
+              + ByteList (ethutils::Keccak256 (sgn)) + ";");
+  w.Line ();
+  WriteFields (w, declared);
+  w.Line ();
+
+  w.Line ("/**");
+  w.Line (" * Decodes the event from the log topics (including topic0) and");
+  w.Line (" * data, all as binary.  Returns false if they do not match.");
+  w.Line (" */");
+  w.Line ("bool");
+  w.Line ("Decode (const std::vector<std::string>& topics,"
+            " const std::string_view bin)");
+  w.Open ();
+  w.Check ("(topics.size () == " + std::to_string (numTopics) + ")");
+  if (!anonymous)
+    w.Check ("(topics[0] == std::string_view (reinterpret_cast<const char*>"
+              " (TOPIC0.data ()), TOPIC0.size ()))");
+  for (size_t i = 0; i < indexed.size (); ++i)
+    {
+      const std::string topic
+          = "topics[" + std::to_string (i + (anonymous ? 0 : 1)) + "]";
+      const auto& f = indexed[i];
+      const std::string target = Member ("", f.first);
+      if (f.second->IsValueType ())
+        DecodeAt (w, *f.second, topic, "0", target);
+      else
+        {
+          w.Check ("(" + topic + ".size () == " + target + ".size ())");
+          w.Line ("std::copy (" + topic + ".begin (), " + topic + ".end (), "
+                    + target + ".begin ());");
+        }
+    }
+  DecodeFields (w, dataTuple, "bin", "0");
+  w.Line ("return true;");
+  w.Close ();
+  w.Line ();
+
+  w.Line ("/**");
+  w.Line (" * Encodes the event into log topics and data.");
+  w.Line (" */");
+  w.Line ("void");
+  w.Line ("Encode (std::vector<std::string>& topics, std::string& data) const");
+  w.Open ();
+  w.Line ("topics.clear ();");
+  if (!anonymous)
+    w.Line ("topics.emplace_back (TOPIC0.begin (), TOPIC0.end ());");
+  for (const auto& f : indexed)
+    {
+      const std::string value = Member ("", f.first);
+      if (f.second->IsValueType ())
+        {
+          w.Line ("topics.emplace_back (" + RT + "WORD, '\\0');");
+          EncodeStatic (w, *f.second, "topics.back ()", "0", value);
+        }
+      else
+        w.Line ("topics.emplace_back (" + value + ".begin (), " + value
+                  + ".end ());");
+    }
+  w.Line ("data.clear ();");
+  EncodeFields (w, dataTuple, "data");
+  w.Close ();
+
+  w.Close (";");
+  w.Line ();
+}
+
+void
+Generator::GenerateCall (const Json::Value& entry, const std::string& suffix)
+{
+  const std::string name = entry["name"].asString ();
+  const std::string structName
+      = UniqueName (Identifier (Capitalise (name) + suffix));
+
+  const auto inputs = BuildFields (entry["inputs"], structName);
+  const GenType inputTuple = FieldsTuple (inputs);
+  const std::string sgn = Signature (name, inputTuple);
+  const std::string selector = ethutils::Keccak256 (sgn).substr (0, 4);
+
+  CodeWriter& w = main;
+  w.Line ("/** Arguments for " + sgn + ".  */");
+  w.Line ("struct " + structName);
+  w.Open ();
+  w.Line ("static constexpr const char* SIGNATURE = \"" + sgn + "\";");
+  w.Line ("static constexpr std::array<unsigned char, 4> SELECTOR = "
+            + ByteList (selector) + ";");
+  w.Line ();
+  WriteFields (w, inputs);
+  if (!inputs.empty ())
+    w.Line ();
+
+  w.Line ("/**");
+  w.Line (" * Decodes binary call data (including the selector).  Returns");
+  w.Line (" * false if it is invalid or has a different selector.");
+  w.Line (" */");
+  w.Line ("bool");
+  w.Line ("Decode (const std::string_view calldata)");
+  w.Open ();
+  w.Check ("(calldata.substr (0, 4) == std::string_view ("
+            "reinterpret_cast<const char*> (SELECTOR.data ()), 4))");
+  if (!inputs.empty ())
+    {
+      w.Line ("const std::string_view bin = calldata.substr (4);");
+      DecodeFields (w, inputTuple, "bin", "0");
+    }
+  w.Line ("return true;");
+  w.Close ();
+  w.Line ();
+
+  w.Line ("/**");
+  w.Line (" * Encodes the binary call data with the selector.");
+  w.Line (" */");
+  w.Line ("std::string");
+  w.Line ("Encode () const");
+  w.Open ();
+  w.Line ("std::string out(SELECTOR.begin (), SELECTOR.end ());");
+  EncodeFields (w, inputTuple, "out");
+  w.Line ("return out;");
+  w.Close ();
+
+  w.Close (";");
+  w.Line ();
+
+  if (!entry.isMember ("outputs") || entry["outputs"].empty ())
+    return;
+
+  const std::string returnName = UniqueName (
+      Identifier (Capitalise (name) + "Return"));
+  const auto outputs = BuildFields (entry["outputs"], returnName);
+  const GenType outputTuple = FieldsTuple (outputs);
+
+  w.Line ("/** Return values of " + sgn + ".  */");
+  w.Line ("struct " + returnName);
+  w.Open ();
+  WriteFields (w, outputs);
+  w.Line ();
+
+  w.Line ("/**");
+  w.Line (" * Decodes binary return data.  Returns false if it is invalid.");
+  w.Line (" */");
+  w.Line ("bool");
+  w.Line ("Decode (const std::string_view bin)");
+  w.Open ();
+  DecodeFields (w, outputTuple, "bin", "0");
+  w.Line ("return true;");
+  w.Close ();
+  w.Line ();
+
+  w.Line ("/**");
+  w.Line (" * Encodes the binary return data.");
+  w.Line (" */");
+  w.Line ("std::string");
+  w.Line ("Encode () const");
+  w.Open ();
+  w.Line ("std::string out;");
+  EncodeFields (w, outputTuple, "out");
+  w.Line ("return out;");
+  w.Close ();
+
+  w.Close (";");
+  w.Line ();
+}
+
+void
+Generator::Process (const Json::Value& abi)
+{
+  if (!abi.isArray ())
+    Fail ("the ABI is not a JSON array");
+
+  for (const auto& entry : abi)
+    {
+      const std::string type = entry.get ("type", "function").asString ();
+      if (type != "event" && type != "function" && type != "error")
+        continue;
+
+      if (!entry["name"].isString () || entry["name"].asString ().empty ())
+        Fail ("ABI entry without name: " + entry.toStyledString ());
+
+      if (type == "event")
+        GenerateEvent (entry);
+      else if (type == "error")
+        GenerateCall (entry, "Error");
+      else
+        GenerateCall (entry, "Call");
+    }
+}
+
+std::string
+Generator::GetHeader (const std::string& source, const std::string& ns,
+                      const std::string& includePrefix) const
+{
+  std::string guard;
+  for (const char c : ns)
+    {
+      const unsigned char u = static_cast<unsigned char> (c);
+      const char g = std::isalnum (u) ? std::toupper (u) : '_';
+      if (g != '_' || guard.empty () || guard.back () != '_')
+        guard.push_back (g);
+    }
+  guard += "_ABIGEN_HPP";
+
+  std::ostringstream out;
+  out << "// Generated by abigen from " << source << ".  Do not edit.\n"
+      << "\n"
+      << "#ifndef " << guard << "\n"
+      << "#define " << guard << "\n"
+      << "\n"
+      << "#include \"" << includePrefix << "abiruntime.hpp\"\n"
+      << "\n"
+      << "#include <algorithm>\n"
+      << "#include <array>\n"
+      << "#include <cstddef>\n"
+      << "#include <cstdint>\n"
+      << "#include <string>\n"
+      << "#include <string_view>\n"
+      << "#include <vector>\n"
+      << "\n"
+      << "namespace " << ns << "\n"
+      << "{\n"
+      << "\n"
+      << tuples.Get ()
+      << main.Get ()
+      << "} // namespace " << ns << "\n"
+      << "\n"
+      << "#endif // " << guard << "\n";
+
+  return out.str ();
+}
+
+} // anonymous namespace
+
+int
+main (int argc, char** argv)
+{
+  google::InitGoogleLogging (argv[0]);
+
+  std::string includePrefix = "eth-utils/";
+  std::vector<std::string> args;
+  for (int i = 1; i < argc; ++i)
+    {
+      const std::string arg = argv[i];
+      const std::string prefixFlag = "--include-prefix=";
+      if (arg.substr (0, prefixFlag.size ()) == prefixFlag)
+        includePrefix = arg.substr (prefixFlag.size ());
+      else
+        args.push_back (arg);
+    }
+
+  if (args.size () != 2)
+    {
+      std::cerr << "Usage: abigen [--include-prefix=PREFIX]"
+                << " ABI-FILE NAMESPACE" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  std::ifstream in(args[0]);
+  if (!in)
+    Fail ("cannot open " + args[0]);
+
+  Json::CharReaderBuilder rbuilder;
+  Json::Value abi;
+  std::string errs;
+  if (!Json::parseFromStream (rbuilder, in, &abi, &errs))
+    Fail ("invalid JSON in " + args[0] + ": " + errs);
+
+  if (abi.isObject () && abi.isMember ("abi"))
+    abi = abi["abi"];
+
+  Generator gen;
+  gen.Process (abi);
+
+  const std::string source = args[0].substr (args[0].rfind ('/') + 1);
+  std::cout << gen.GetHeader (source, args[1], includePrefix);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,423 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/* Tests for the code generated by abigen from abigen_sample.json.  The
+   expected encodings have been computed with the eth_abi Python module.  */
+
+#include "abigen_sample.hpp"
+
+#include "hexutils.hpp"
+#include "keccak.hpp"
+#include "uint256.hpp"
+
+#include <gtest/gtest.h>
+
+#include <glog/logging.h>
+
+#include <type_traits>
+
+namespace ethutils
+{
+namespace
+{
+
+/**
+ * Converts hex data without 0x prefix to binary.
+ */
+std::string
+Bin (const std::string& hex)
+{
+  std::string res;
+  CHECK (Unhexlify (hex, res)) << hex;
+  return res;
+}
+
+/**
+ * Returns the raw binary form of an address.
+ */
+Address::Binary
+AddressBin (const std::string& addr)
+{
+  const Address a(addr);
+  CHECK (a) << addr;
+  return a.GetBinary ();
+}
+
+/**
+ * Returns a 32-byte word with all bytes set to b.
+ */
+std::array<unsigned char, 32>
+FilledWord (const unsigned char b)
+{
+  std::array<unsigned char, 32> res;
+  res.fill (b);
+  return res;
+}
+
+TEST (AbigenTests, MoveEvent)
+{
+  /* Real event data from a move on the Mumbai testnet (as also used in the
+     tests of AbiDecoder).  */
+  const std::string data = Bin (
+      "00000000000000000000000000000000000000000000000000000000000000e0"
+      "0000000000000000000000000000000000000000000000000000000000000120"
+      "0000000000000000000000000000000000000000000000000000000000000160"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "00000000000000000000000014e663e1531e0f438840952d18720c74c28d4f20"
+      "00000000000000000000000000000000000000000000000000000000000004d2"
+      "000000000000000000000000f0534cc8f4c22972d31105c7ac7b656b581a3a8e"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "7000000000000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000005"
+      "646f6d6f62000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "7b7d000000000000000000000000000000000000000000000000000000000000");
+  const std::vector<std::string> topics = {
+    Keccak256 ("Move(string,string,string,uint256,address,uint256,address)"),
+  };
+
+  sample::MoveEvent ev;
+  ASSERT_TRUE (ev.Decode (topics, data));
+  EXPECT_EQ (ev.ns, "p");
+  EXPECT_EQ (ev.name, "domob");
+  EXPECT_EQ (ev.mv, "{}");
+  EXPECT_EQ (ev.nonce, Uint256 (2));
+  EXPECT_EQ (ev.mover,
+             AddressBin ("0x14e663e1531e0f438840952d18720c74c28d4f20"));
+  EXPECT_EQ (ev.amount, Uint256 (1234));
+  EXPECT_EQ (ev.receiver,
+             AddressBin ("0xf0534cc8f4c22972d31105c7ac7b656b581a3a8e"));
+
+  std::vector<std::string> encodedTopics;
+  std::string encodedData;
+  ev.Encode (encodedTopics, encodedData);
+  EXPECT_EQ (encodedTopics, topics);
+  EXPECT_EQ (encodedData, data);
+
+  /* Wrong topic0 or truncated data.  */
+  EXPECT_FALSE (ev.Decode ({std::string (32, '\0')}, data));
+  EXPECT_FALSE (ev.Decode (topics, data.substr (0, data.size () - 32)));
+
+  /* All three strings pointing to the same tail data is rejected, since
+     it decodes to more data than the payload holds.  */
+  const std::string ptr = Bin (std::string (62, '0') + "e0");
+  const std::string aliased = ptr + ptr + ptr + data.substr (3 * 32, 4 * 32)
+                                + Bin (std::string (62, '0') + "60")
+                                + std::string (96, 'x');
+  EXPECT_FALSE (ev.Decode (topics, aliased));
+}
+
+TEST (AbigenTests, TransferEvent)
+{
+  sample::TransferEvent ev;
+  ev.from = AddressBin ("0x14e663e1531e0f438840952d18720c74c28d4f20");
+  ev.to = AddressBin ("0xf0534cc8f4c22972d31105c7ac7b656b581a3a8e");
+  ev.value = Uint256 (42);
+
+  std::vector<std::string> topics;
+  std::string data;
+  ev.Encode (topics, data);
+
+  ASSERT_EQ (topics.size (), 3);
+  EXPECT_EQ (Hexlify (topics[0]),
+             "ddf252ad1be2c89b69c2b068fc378daa"
+             "952ba7f163c4a11628f55a4df523b3ef");
+  EXPECT_EQ (Hexlify (topics[1]),
+             "00000000000000000000000014e663e1"
+             "531e0f438840952d18720c74c28d4f20");
+  EXPECT_EQ (Hexlify (topics[2]),
+             "000000000000000000000000f0534cc8"
+             "f4c22972d31105c7ac7b656b581a3a8e");
+  EXPECT_EQ (Hexlify (data),
+             "00000000000000000000000000000000"
+             "0000000000000000000000000000002a");
+
+  sample::TransferEvent decoded;
+  ASSERT_TRUE (decoded.Decode (topics, data));
+  EXPECT_EQ (decoded.from, ev.from);
+  EXPECT_EQ (decoded.to, ev.to);
+  EXPECT_EQ (decoded.value, ev.value);
+
+  topics.pop_back ();
+  EXPECT_FALSE (decoded.Decode (topics, data));
+}
+
+TEST (AbigenTests, IndexedReferenceType)
+{
+  sample::TaggedEvent ev;
+  const std::string tagHash = Keccak256 ("tag");
+  std::copy (tagHash.begin (), tagHash.end (), ev.tag.begin ());
+  ev.level = -3;
+  ev.info.id = 42;
+  ev.info.active = true;
+
+  std::vector<std::string> topics;
+  std::string data;
+  ev.Encode (topics, data);
+
+  ASSERT_EQ (topics.size (), 3);
+  EXPECT_EQ (topics[0], Keccak256 ("Tagged(string,int16,(uint64,bool))"));
+  EXPECT_EQ (topics[1], tagHash);
+  EXPECT_EQ (Hexlify (topics[2]),
+             "ffffffffffffffffffffffffffffffff"
+             "fffffffffffffffffffffffffffffffd");
+  EXPECT_EQ (Hexlify (data),
+             "000000000000000000000000000000000000000000000000000000000000002a"
+             "00000000000000000000000000000000"
+             "00000000000000000000000000000001");
+
+  sample::TaggedEvent decoded;
+  ASSERT_TRUE (decoded.Decode (topics, data));
+  EXPECT_EQ (decoded.tag, ev.tag);
+  EXPECT_EQ (decoded.level, -3);
+  EXPECT_EQ (decoded.info.id, 42);
+  EXPECT_TRUE (decoded.info.active);
+
+  /* The indexed int16 must be sign-extended correctly.  */
+  topics[2][0] = 0;
+  EXPECT_FALSE (decoded.Decode (topics, data));
+}
+
+TEST (AbigenTests, FunctionCall)
+{
+  const std::string calldata = Bin ("e8e53452"
+      "00000000000000000000000000000000000000000000000000000000000000a0"
+      "00000000000000000000000000000000000000000000000000000000000000e0"
+      "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffb"
+      "0000000000000000000000000000000000000000000000000000000000000200"
+      "deadbeef00000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000005"
+      "616c696365000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "0101010101010101010101010101010101010101010101010101010101010101"
+      "0202020202020202020202020202020202020202020202020202020202020202"
+      "000000000000000000000000000000000000000000000000ffffffffffffffff"
+      "0000000000000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000000"
+      "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"
+      "0000000000000000000000000000000000000000000000000000000000000003"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "0000000000000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000001");
+
+  sample::RegisterCall call;
+  call.name = "alice";
+  call.items.resize (2);
+  call.items[0].id = 1;
+  call.items[0].active = true;
+  call.items[0].tags = {FilledWord (0x01), FilledWord (0x02)};
+  call.items[1].id = UINT64_MAX;
+  call.items[1].active = false;
+  call.items[1].tags = {FilledWord (0x00), FilledWord (0xff)};
+  call.delta = -5;
+  call.flags = {true, false, true};
+  call.code = {0xde, 0xad, 0xbe, 0xef};
+
+  EXPECT_EQ (Hexlify (call.Encode ()), Hexlify (calldata));
+
+  sample::RegisterCall decoded;
+  ASSERT_TRUE (decoded.Decode (calldata));
+  EXPECT_EQ (decoded.name, "alice");
+  ASSERT_EQ (decoded.items.size (), 2);
+  EXPECT_EQ (decoded.items[0].id, 1);
+  EXPECT_TRUE (decoded.items[0].active);
+  EXPECT_EQ (decoded.items[0].tags[1], FilledWord (0x02));
+  EXPECT_EQ (decoded.items[1].id, UINT64_MAX);
+  EXPECT_FALSE (decoded.items[1].active);
+  EXPECT_EQ (decoded.items[1].tags[1], FilledWord (0xff));
+  EXPECT_EQ (decoded.delta, -5);
+  EXPECT_EQ (decoded.flags, std::vector<bool> ({true, false, true}));
+  EXPECT_EQ (decoded.code, call.code);
+
+  EXPECT_EQ (decoded.Encode (), calldata);
+
+  /* Wrong selector and truncated data.  */
+  std::string modified = calldata;
+  modified[0] = 0;
+  EXPECT_FALSE (decoded.Decode (modified));
+  EXPECT_FALSE (decoded.Decode (calldata.substr (0, calldata.size () - 1)));
+}
+
+TEST (AbigenTests, ReturnData)
+{
+  const std::string data = Bin (
+      "8000000000000000000000000000000000000000000000000000000000000007"
+      "0000000000000000000000000000000000000000000000000000000000000040"
+      "0000000000000000000000000000000000000000000000000000000000000003"
+      "0001020000000000000000000000000000000000000000000000000000000000");
+
+  sample::RegisterReturn ret;
+  ASSERT_TRUE (ret.Decode (data));
+  EXPECT_EQ (ret.total.ToBinary (), data.substr (0, 32));
+  EXPECT_EQ (ret.arg1, std::string ("\x00\x01\x02", 3));
+  EXPECT_EQ (ret.Encode (), data);
+}
+
+TEST (AbigenTests, EventFieldNamesLikeLocals)
+{
+  /* The fields are called like the parameters and local variables of
+     the generated methods.  */
+  sample::StoredEvent ev;
+  ev.topics = 3;
+  ev.data = std::string ("\x01\x02");
+  ev.b = 7;
+  ev.out = "hi";
+
+  std::vector<std::string> topics;
+  std::string data;
+  ev.Encode (topics, data);
+
+  ASSERT_EQ (topics.size (), 2);
+  EXPECT_EQ (topics[0], Keccak256 ("Stored(uint8,bytes,uint32,string)"));
+  EXPECT_EQ (Hexlify (topics[1]),
+             "00000000000000000000000000000000"
+             "00000000000000000000000000000003");
+  EXPECT_EQ (data, Bin (
+      "0000000000000000000000000000000000000000000000000000000000000060"
+      "0000000000000000000000000000000000000000000000000000000000000007"
+      "00000000000000000000000000000000000000000000000000000000000000a0"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "0102000000000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "6869000000000000000000000000000000000000000000000000000000000000"));
+
+  sample::StoredEvent decoded;
+  ASSERT_TRUE (decoded.Decode (topics, data));
+  EXPECT_EQ (decoded.topics, 3);
+  EXPECT_EQ (decoded.data, ev.data);
+  EXPECT_EQ (decoded.b, 7);
+  EXPECT_EQ (decoded.out, "hi");
+}
+
+TEST (AbigenTests, CallFieldNamesLikeLocals)
+{
+  const std::string calldata = Bin ("8460aeb0"
+      "0000000000000000000000000000000000000000000000000000000000000005"
+      "0000000000000000000000000000000000000000000000000000000000000080"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "00000000000000000000000000000000000000000000000000000000000000c0"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "ab00000000000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "0000000000000000000000000000000000000000000000000000000000000002");
+
+  sample::StoreCall call;
+  call.b = Uint256 (5);
+  call.out = std::string ("\xab");
+  call.calldata = true;
+  call.p0 = {1, 2};
+  EXPECT_EQ (Hexlify (call.Encode ()), Hexlify (calldata));
+
+  sample::StoreCall decoded;
+  ASSERT_TRUE (decoded.Decode (calldata));
+  EXPECT_EQ (decoded.b, Uint256 (5));
+  EXPECT_EQ (decoded.out, call.out);
+  EXPECT_TRUE (decoded.calldata);
+  EXPECT_EQ (decoded.p0, call.p0);
+
+  const std::string data = Bin (
+      "0000000000000000000000000000000000000000000000000000000000000040"
+      "0000000000000000000000000000000000000000000000000000000000000009"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "cdef000000000000000000000000000000000000000000000000000000000000");
+
+  sample::StoreReturn ret;
+  ASSERT_TRUE (ret.Decode (data));
+  EXPECT_EQ (ret.bin, std::string ("\xcd\xef"));
+  EXPECT_EQ (ret.data, 9);
+  EXPECT_EQ (ret.Encode (), data);
+}
+
+TEST (AbigenTests, IntegerLimits)
+{
+  const std::string calldata = Bin ("d000b10a"
+      "0000000000000000000000000000000000000000000000000000000000ffffff"
+      "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffff800000"
+      "00000000000000000000000000000000ffffffffffffffffffffffffffffffff"
+      "ffffffffffffffffffffffffffffffffffffffffffffff800000000000000000");
+
+  sample::SetLimitsCall call;
+  call.u = (1 << 24) - 1;
+  call.s = -(1 << 23);
+  ASSERT_TRUE (Uint256::FromHex ("0xffffffffffffffffffffffffffffffff",
+                                 call.wide));
+  const std::string signedWide = calldata.substr (4 + 3 * 32, 32);
+  std::copy (signedWide.begin (), signedWide.end (),
+             call.signedWide.begin ());
+  EXPECT_EQ (Hexlify (call.Encode ()), Hexlify (calldata));
+
+  sample::SetLimitsCall decoded;
+  ASSERT_TRUE (decoded.Decode (calldata));
+  EXPECT_EQ (decoded.u, call.u);
+  EXPECT_EQ (decoded.s, call.s);
+  EXPECT_EQ (decoded.wide, call.wide);
+  EXPECT_EQ (decoded.signedWide, call.signedWide);
+
+  /* Values that fit the C++ types of the fields, but not the declared
+     ABI types, must not be encoded.  */
+  sample::SetLimitsCall invalid = call;
+  invalid.u = 1 << 24;
+  EXPECT_DEATH (invalid.Encode (), "out of range for uint24");
+
+  invalid = call;
+  invalid.s = 1 << 23;
+  EXPECT_DEATH (invalid.Encode (), "out of range for int24");
+  invalid.s = -(1 << 23) - 1;
+  EXPECT_DEATH (invalid.Encode (), "out of range for int24");
+
+  invalid = call;
+  invalid.wide += Uint256 (1);
+  EXPECT_DEATH (invalid.Encode (), "out of range for uint128");
+
+  invalid = call;
+  invalid.signedWide[0] = 0;
+  EXPECT_DEATH (invalid.Encode (), "out of range for int72");
+}
+
+TEST (AbigenTests, StructReuse)
+{
+  /* The same struct is reused, but one with other field names is not.  */
+  static_assert (std::is_same<decltype (sample::UpdateCall::item),
+                              sample::Item>::value);
+  static_assert (std::is_same<decltype (sample::RegisterCall::items),
+                              std::vector<sample::Item>>::value);
+  static_assert (std::is_same<decltype (sample::UpdateCall::other),
+                              sample::Item2>::value);
+
+  sample::UpdateCall call;
+  call.item.id = 1;
+  call.item.tags[1] = FilledWord (0x02);
+  call.other.key = 2;
+  call.other.enabled = true;
+  call.other.labels[0] = FilledWord (0x03);
+
+  sample::UpdateCall decoded;
+  ASSERT_TRUE (decoded.Decode (call.Encode ()));
+  EXPECT_EQ (decoded.item.id, 1);
+  EXPECT_FALSE (decoded.item.active);
+  EXPECT_EQ (decoded.item.tags[1], FilledWord (0x02));
+  EXPECT_EQ (decoded.other.key, 2);
+  EXPECT_TRUE (decoded.other.enabled);
+  EXPECT_EQ (decoded.other.labels[0], FilledWord (0x03));
+}
+
+TEST (AbigenTests, Error)
+{
+  EXPECT_EQ (Hexlify (std::string (sample::UnauthorizedError::SELECTOR.begin (),
+                                   sample::UnauthorizedError::SELECTOR.end ())),
+             "8e4a23d6");
+
+  sample::UnauthorizedError err;
+  err.caller = AddressBin ("0x14e663e1531e0f438840952d18720c74c28d4f20");
+
+  sample::UnauthorizedError decoded;
+  ASSERT_TRUE (decoded.Decode (err.Encode ()));
+  EXPECT_EQ (decoded.caller, err.caller);
+}
+
+} // anonymous namespace
+} // namespace ethutils
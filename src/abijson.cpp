@@ -0,0 +1,604 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "abijson.hpp"
+
+#include "hexutils.hpp"
+#include "keccak.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <charconv>
+
+namespace ethutils
+{
+
+namespace
+{
+
+/**
+ * Returns the length of the valid UTF-8 sequence at the start of str,
+ * or zero if it does not start with one.  This rejects overlong encodings,
+ * surrogates and code points above U+10FFFF.
+ */
+size_t
+Utf8SequenceLength (const std::string_view str)
+{
+  const auto byte = [&] (const size_t i)
+    {
+      return static_cast<unsigned char> (str[i]);
+    };
+
+  const unsigned char lead = byte (0);
+  if (lead < 0x80)
+    return 1;
+
+  size_t len;
+  unsigned char min = 0x80;
+  unsigned char max = 0xBF;
+  if (lead >= 0xC2 && lead <= 0xDF)
+    len = 2;
+  else if (lead >= 0xE0 && lead <= 0xEF)
+    {
+      len = 3;
+      if (lead == 0xE0)
+        min = 0xA0;
+      else if (lead == 0xED)
+        max = 0x9F;
+    }
+  else if (lead >= 0xF0 && lead <= 0xF4)
+    {
+      len = 4;
+      if (lead == 0xF0)
+        min = 0x90;
+      else if (lead == 0xF4)
+        max = 0x8F;
+    }
+  else
+    return 0;
+
+  if (str.size () < len)
+    return 0;
+  if (byte (1) < min || byte (1) > max)
+    return 0;
+  for (size_t i = 2; i < len; ++i)
+    if (byte (i) < 0x80 || byte (i) > 0xBF)
+      return 0;
+
+  return len;
+}
+
+/**
+ * Returns the number of significant bits of a value.
+ */
+size_t
+BitLength (const Uint256& val)
+{
+  unsigned char bin[Uint256::BINARY_SIZE];
+  val.ToBinary (bin);
+
+  for (size_t i = 0; i < sizeof (bin); ++i)
+    if (bin[i] != 0)
+      {
+        size_t res = 8 * (sizeof (bin) - i);
+        for (unsigned char mask = 0x80; (bin[i] & mask) == 0; mask >>= 1)
+          --res;
+        return res;
+      }
+
+  return 0;
+}
+
+/**
+ * Parses an integer from JSON (either a number or a string in decimal
+ * or hex, with optional minus sign) into its sign and absolute value.
+ */
+bool
+ParseInteger (const Json::Value& val, bool& negative, Uint256& magnitude)
+{
+  if (val.isUInt64 ())
+    {
+      negative = false;
+      magnitude = Uint256 (val.asUInt64 ());
+      return true;
+    }
+
+  if (val.isInt64 ())
+    {
+      negative = true;
+      magnitude = Uint256 (-static_cast<uint64_t> (val.asInt64 ()));
+      return true;
+    }
+
+  if (!val.isString ())
+    return false;
+
+  const char* begin;
+  const char* end;
+  val.getString (&begin, &end);
+  std::string_view str(begin, end - begin);
+
+  negative = (!str.empty () && str.front () == '-');
+  if (negative)
+    str.remove_prefix (1);
+
+  return Uint256::Parse (str, magnitude);
+}
+
+/**
+ * Parses a hex string with 0x prefix from JSON into binary.  Digits are
+ * accepted in either case, and invalid input is not logged.
+ */
+bool
+ParseHex (const Json::Value& val, std::string& bin)
+{
+  if (!val.isString ())
+    return false;
+
+  const char* begin;
+  const char* end;
+  val.getString (&begin, &end);
+  const std::string_view str(begin, end - begin);
+
+  return str.substr (0, 2) == "0x" && UnhexlifyAnyCase (str.substr (2), bin);
+}
+
+/**
+ * Checks whether a string is a valid address, i.e. either all lower-case
+ * or correctly checksummed.  This applies the same rules as the Address
+ * constructor, but does not log the (untrusted) input if it is invalid.
+ */
+bool
+IsValidAddress (const std::string& str)
+{
+  constexpr size_t hexSize = 2 * Address::BINARY_SIZE;
+  if (str.size () != 2 + hexSize || str.substr (0, 2) != "0x")
+    return false;
+
+  const std::string_view digits = std::string_view (str).substr (2);
+  std::string bin;
+  if (!UnhexlifyAnyCase (digits, bin))
+    return false;
+  CHECK_EQ (bin.size (), Address::BINARY_SIZE);
+
+  const bool lower = std::none_of (digits.begin (), digits.end (),
+                                   [] (const char c)
+                                     {
+                                       return c >= 'A' && c <= 'F';
+                                     });
+  if (lower)
+    return true;
+
+  Address::Binary raw;
+  std::copy (bin.begin (), bin.end (), raw.begin ());
+  char checksummed[hexSize];
+  Address::FormatChecksummed (raw, checksummed);
+
+  return digits == std::string_view (checksummed, hexSize);
+}
+
+/**
+ * Returns the size of the head part of a tuple's members (as opposed to
+ * the tuple's own head size in an enclosing tuple).
+ */
+size_t
+InnerHeadSize (const AbiType& t)
+{
+  size_t res = 0;
+  for (const auto& c : t.GetComponents ())
+    res += c.GetHeadSize ();
+  return res;
+}
+
+} // anonymous namespace
+
+void
+AppendJsonString (std::string& out, std::string_view str)
+{
+  static const char* const DIGITS = "0123456789abcdef";
+
+  out.push_back ('"');
+  while (!str.empty ())
+    {
+      const unsigned char c = str.front ();
+      switch (c)
+        {
+        case '"':
+          out.append ("\\\"");
+          break;
+        case '\\':
+          out.append ("\\\\");
+          break;
+        case '\n':
+          out.append ("\\n");
+          break;
+        case '\r':
+          out.append ("\\r");
+          break;
+        case '\t':
+          out.append ("\\t");
+          break;
+
+        default:
+          if (c < 0x20)
+            {
+              out.append ("\\u00");
+              out.push_back (DIGITS[c >> 4]);
+              out.push_back (DIGITS[c & 0xF]);
+              break;
+            }
+
+          const size_t len = Utf8SequenceLength (str);
+          if (len == 0)
+            {
+              out.append ("\\ufffd");
+              break;
+            }
+
+          out.append (str.substr (0, len));
+          str.remove_prefix (len);
+          continue;
+        }
+
+      str.remove_prefix (1);
+    }
+  out.push_back ('"');
+}
+
+/* ************************************************************************** */
+
+void
+AbiJsonWriter::BeginValue ()
+{
+  if (!first)
+    out.push_back (',');
+  first = false;
+}
+
+void
+AbiJsonWriter::WriteInteger (const size_t bits, const bool negative,
+                             const Uint256& magnitude)
+{
+  BeginValue ();
+
+  const bool quoted = (bits > 64);
+  if (quoted)
+    out.push_back ('"');
+  if (negative)
+    out.push_back ('-');
+
+  if (magnitude.FitsUint64 ())
+    {
+      char buf[24];
+      const auto res = std::to_chars (buf, buf + sizeof (buf),
+                                      magnitude.GetLow64 ());
+      out.append (buf, res.ptr);
+    }
+  else
+    out.append (magnitude.ToDecimal ());
+
+  if (quoted)
+    out.push_back ('"');
+}
+
+void
+AbiJsonWriter::WriteHex (const std::string_view data)
+{
+  BeginValue ();
+
+  const size_t start = out.size ();
+  out.resize (start + 2 * data.size () + 4);
+  out[start] = '"';
+  out[start + 1] = '0';
+  out[start + 2] = 'x';
+  Hexlify (reinterpret_cast<const unsigned char*> (data.data ()),
+           data.size (), &out[start + 3]);
+  out.back () = '"';
+}
+
+void
+AbiJsonWriter::BeginTuple (const size_t count)
+{
+  BeginArray (count);
+}
+
+void
+AbiJsonWriter::EndTuple ()
+{
+  EndArray ();
+}
+
+void
+AbiJsonWriter::BeginArray (const size_t len)
+{
+  BeginValue ();
+  out.push_back ('[');
+  first = true;
+}
+
+void
+AbiJsonWriter::EndArray ()
+{
+  out.push_back (']');
+  first = false;
+}
+
+void
+AbiJsonWriter::VisitUint (const size_t bits, const Uint256& val)
+{
+  WriteInteger (bits, false, val);
+}
+
+void
+AbiJsonWriter::VisitInt (const size_t bits, const bool negative,
+                         const Uint256& magnitude)
+{
+  WriteInteger (bits, negative, magnitude);
+}
+
+void
+AbiJsonWriter::VisitAddress (const Address::Binary& addr)
+{
+  BeginValue ();
+
+  const size_t start = out.size ();
+  out.resize (start + 2 * addr.size () + 4);
+  out[start] = '"';
+  out[start + 1] = '0';
+  out[start + 2] = 'x';
+  Address::FormatChecksummed (addr, &out[start + 3]);
+  out.back () = '"';
+}
+
+void
+AbiJsonWriter::VisitBool (const bool val)
+{
+  BeginValue ();
+  out.append (val ? "true" : "false");
+}
+
+void
+AbiJsonWriter::VisitFixedBytes (const std::string_view data)
+{
+  WriteHex (data);
+}
+
+void
+AbiJsonWriter::VisitBytes (const std::string_view data)
+{
+  WriteHex (data);
+}
+
+void
+AbiJsonWriter::VisitString (const std::string_view data)
+{
+  BeginValue ();
+  AppendJsonString (out, data);
+}
+
+bool
+AbiJsonWriter::Convert (const AbiDecodePlan& plan, const std::string_view bin,
+                        std::string& out)
+{
+  const size_t oldSize = out.size ();
+
+  AbiJsonWriter writer(out);
+  if (plan.Visit (bin, writer))
+    return true;
+
+  out.resize (oldSize);
+  return false;
+}
+
+/* ************************************************************************** */
+
+AbiJsonEncoder::AbiJsonEncoder (const AbiType& t)
+  : type(t)
+{
+  CHECK (type.GetKind () == AbiType::Kind::TUPLE)
+      << "Type for AbiJsonEncoder must be a tuple: " << type.ToString ();
+}
+
+AbiJsonEncoder
+AbiJsonEncoder::ForFunction (const std::string& signature)
+{
+  const size_t open = signature.find ('(');
+  CHECK (open != std::string::npos && open > 0)
+      << "Invalid function signature: " << signature;
+
+  AbiType params;
+  CHECK (AbiType::Parse (std::string_view (signature).substr (open), params)
+            && params.GetKind () == AbiType::Kind::TUPLE)
+      << "Invalid function signature: " << signature;
+
+  AbiJsonEncoder res(params);
+  const std::string canonical = signature.substr (0, open) + params.ToString ();
+  res.selector = Keccak256 (canonical).substr (0, 4);
+
+  return res;
+}
+
+template <typename Fcn>
+  bool
+  AbiJsonEncoder::EncodeElements (const Json::Value& val, const size_t count,
+                                  const Fcn& typeOf, AbiWriter& w,
+                                  std::string& path, std::string& error) const
+{
+  const size_t oldSize = path.size ();
+  for (size_t i = 0; i < count; ++i)
+    {
+      path += "[" + std::to_string (i) + "]";
+      if (!EncodeValue (typeOf (i), val[static_cast<Json::ArrayIndex> (i)],
+                        w, path, error))
+        return false;
+      path.resize (oldSize);
+    }
+
+  return true;
+}
+
+bool
+AbiJsonEncoder::EncodeValue (const AbiType& t, const Json::Value& val,
+                             AbiWriter& w, std::string& path,
+                             std::string& error) const
+{
+  using Kind = AbiType::Kind;
+
+  const auto fail = [&] (const std::string& msg)
+    {
+      error = path + ": " + msg;
+      return false;
+    };
+
+  switch (t.GetKind ())
+    {
+    case Kind::UINT:
+    case Kind::INT:
+      {
+        const bool isSigned = (t.GetKind () == Kind::INT);
+        const std::string name = (isSigned ? "int" : "uint")
+                                    + std::to_string (t.GetSize ());
+
+        bool negative;
+        Uint256 magnitude;
+        if (!ParseInteger (val, negative, magnitude))
+          return fail ("expected integer for " + name);
+
+        /* The magnitude of negative values can be one larger than the
+           maximum positive value of signed integers.  */
+        Uint256 limit = magnitude;
+        if (negative && !magnitude.IsZero ())
+          {
+            if (!isSigned)
+              return fail ("negative value for " + name);
+            limit -= Uint256 (1);
+          }
+        if (BitLength (limit) > t.GetSize () - (isSigned ? 1 : 0))
+          return fail ("value out of range for " + name);
+
+        w.WriteUint (negative ? Uint256 () - magnitude : magnitude);
+        return true;
+      }
+
+    case Kind::ADDRESS:
+      {
+        if (!val.isString ())
+          return fail ("expected address string");
+        const std::string str = val.asString ();
+        if (!IsValidAddress (str))
+          return fail ("invalid address");
+        const Address addr(str);
+        CHECK (addr) << "Address validation mismatch";
+        w.WriteAddress (addr);
+        return true;
+      }
+
+    case Kind::BOOL:
+      if (!val.isBool ())
+        return fail ("expected bool");
+      w.WriteBool (val.asBool ());
+      return true;
+
+    case Kind::FIXED_BYTES:
+    case Kind::BYTES:
+      {
+        std::string bin;
+        if (!ParseHex (val, bin))
+          return fail ("expected hex string");
+        if (t.GetKind () == Kind::BYTES)
+          w.WriteBytes (bin);
+        else if (bin.size () != t.GetSize ())
+          return fail ("expected " + std::to_string (t.GetSize ()) + " bytes");
+        else
+          w.WriteFixedBytes (bin);
+        return true;
+      }
+
+    case Kind::STRING:
+      {
+        if (!val.isString ())
+          return fail ("expected string");
+        const char* begin;
+        const char* end;
+        val.getString (&begin, &end);
+        w.WriteBytes (std::string_view (begin, end - begin));
+        return true;
+      }
+
+    case Kind::TUPLE:
+    case Kind::FIXED_ARRAY:
+    case Kind::ARRAY:
+      break;
+    }
+
+  if (!val.isArray ())
+    return fail ("expected array");
+
+  if (t.GetKind () == Kind::TUPLE)
+    {
+      const auto& components = t.GetComponents ();
+      if (val.size () != components.size ())
+        return fail ("expected " + std::to_string (components.size ())
+                        + " tuple members");
+
+      w.BeginTuple (InnerHeadSize (t), t.IsDynamic ());
+      const auto typeOf = [&] (const size_t i) -> const AbiType&
+        {
+          return components[i];
+        };
+      if (!EncodeElements (val, components.size (), typeOf, w, path, error))
+        return false;
+      w.End ();
+      return true;
+    }
+
+  const AbiType& elem = t.GetElement ();
+  const size_t len = val.size ();
+  if (t.GetKind () == Kind::FIXED_ARRAY)
+    {
+      if (len != t.GetSize ())
+        return fail ("expected " + std::to_string (t.GetSize ())
+                        + " array elements");
+      w.BeginTuple (len * elem.GetHeadSize (), t.IsDynamic ());
+    }
+  else
+    w.BeginArray (len, elem.GetHeadSize ());
+
+  const auto typeOf = [&] (size_t) -> const AbiType&
+    {
+      return elem;
+    };
+  if (!EncodeElements (val, len, typeOf, w, path, error))
+    return false;
+  w.End ();
+  return true;
+}
+
+bool
+AbiJsonEncoder::Encode (const Json::Value& val, std::string& out,
+                        std::string& error) const
+{
+  std::string path = "$";
+  const auto& components = type.GetComponents ();
+  if (!val.isArray () || val.size () != components.size ())
+    {
+      error = path + ": expected array with "
+                + std::to_string (components.size ()) + " values";
+      return false;
+    }
+
+  AbiWriter w(selector, InnerHeadSize (type));
+  const auto typeOf = [&] (const size_t i) -> const AbiType&
+    {
+      return components[i];
+    };
+  if (!EncodeElements (val, components.size (), typeOf, w, path, error))
+    return false;
+
+  out = w.ReleaseBinary ();
+  return true;
+}
+
+} // namespace ethutils
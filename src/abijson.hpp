@@ -0,0 +1,180 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ETHUTILS_ABIJSON_HPP
+#define ETHUTILS_ABIJSON_HPP
+
+#include "abi.hpp"
+#include "abiplan.hpp"
+#include "abitype.hpp"
+
+#include <json/json.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace ethutils
+{
+
+/**
+ * An AbiVisitor that streams the decoded values as JSON into an output
+ * string, without building intermediate objects.  The mapping is:
+ *
+ *  - Tuples and arrays become JSON arrays.
+ *  - Integers of up to 64 bits become JSON numbers, and larger integers
+ *    become strings with their decimal value.  Note that parsers which
+ *    read numbers as doubles cannot represent all 64-bit values exactly.
+ *  - Addresses become strings in checksummed form.
+ *  - bytes and bytesN become hex strings with 0x prefix.
+ *  - Strings are escaped as needed.  Invalid UTF-8 sequences are
+ *    replaced by U+FFFD, so that the output is always valid JSON.
+ */
+class AbiJsonWriter : public AbiVisitor
+{
+
+private:
+
+  /** The output string, to which the JSON is appended.  */
+  std::string& out;
+
+  /**
+   * Whether the next value is the first in its enclosing tuple or array,
+   * i.e. does not need a comma before it.
+   */
+  bool first = true;
+
+  /**
+   * Writes the separator before a new value, if needed.
+   */
+  void BeginValue ();
+
+  /**
+   * Writes a decimal integer, quoted if it is larger than 64 bits.
+   */
+  void WriteInteger (size_t bits, bool negative, const Uint256& magnitude);
+
+  /**
+   * Writes binary data as quoted hex string with 0x prefix.
+   */
+  void WriteHex (std::string_view data);
+
+public:
+
+  explicit AbiJsonWriter (std::string& o)
+    : out(o)
+  {}
+
+  void BeginTuple (size_t count) override;
+  void EndTuple () override;
+  void BeginArray (size_t len) override;
+  void EndArray () override;
+
+  void VisitUint (size_t bits, const Uint256& val) override;
+  void VisitInt (size_t bits, bool negative,
+                 const Uint256& magnitude) override;
+  void VisitAddress (const Address::Binary& addr) override;
+  void VisitBool (bool val) override;
+  void VisitFixedBytes (std::string_view data) override;
+  void VisitBytes (std::string_view data) override;
+  void VisitString (std::string_view data) override;
+
+  /**
+   * Decodes a binary payload with the given plan and appends its JSON
+   * form to out.  Returns false if the data is invalid, in which case
+   * out is left unchanged.  Since the plan bounds the decoded values by
+   * the data size, the output size is bounded by it as well.
+   */
+  static bool Convert (const AbiDecodePlan& plan, std::string_view bin,
+                       std::string& out);
+
+};
+
+/**
+ * Encoder that converts JSON values (e.g. from the parameters of an API
+ * request) directly to ABI data of a fixed tuple type, optionally with
+ * a function selector in front for calldata.  The accepted JSON forms
+ * are the ones produced by AbiJsonWriter:
+ *
+ *  - Tuples and arrays are JSON arrays.
+ *  - Integers are JSON numbers, or strings in decimal or in hex with
+ *    0x prefix (optionally with a minus sign for negative values).
+ *  - Addresses are strings, either all lower-case or checksummed.
+ *  - bytes and bytesN are hex strings with 0x prefix (digits in any case).
+ *  - Strings and bools are the corresponding JSON types.
+ *
+ * The values are validated against the type while they are written into
+ * a single buffer.  Invalid values are reported with an error message
+ * including the JSON path (like "$[1][0]") of the offending value.
+ */
+class AbiJsonEncoder
+{
+
+private:
+
+  /** The tuple type of the values.  */
+  AbiType type;
+
+  /** The function selector to prepend (or empty for plain data).  */
+  std::string selector;
+
+  /**
+   * Encodes the value of a given type to the writer.  The path of the
+   * value is given for error messages.  It is extended for child values,
+   * but restored again when this method returns true.
+   */
+  bool EncodeValue (const AbiType& t, const Json::Value& val, AbiWriter& w,
+                    std::string& path, std::string& error) const;
+
+  /**
+   * Encodes the members of a tuple or array, whose types are given
+   * by the function.
+   */
+  template <typename Fcn>
+    bool EncodeElements (const Json::Value& val, size_t count,
+                         const Fcn& typeOf, AbiWriter& w,
+                         std::string& path, std::string& error) const;
+
+public:
+
+  /**
+   * Constructs an encoder for plain data of the given type, which must
+   * be a tuple.
+   */
+  explicit AbiJsonEncoder (const AbiType& t);
+
+  /**
+   * Constructs an encoder for calldata of a function, given by its
+   * signature like "transfer(address,uint256)" (with canonical types and
+   * without spaces or names).  CHECK-fails if the signature is invalid.
+   */
+  static AbiJsonEncoder ForFunction (const std::string& signature);
+
+  /**
+   * Returns the function selector, or an empty string for an encoder
+   * for plain data.
+   */
+  const std::string&
+  GetSelector () const
+  {
+    return selector;
+  }
+
+  /**
+   * Encodes a JSON value, which must be an array with the members of
+   * the tuple type.  Returns false and sets error if the value is invalid.
+   */
+  bool Encode (const Json::Value& val, std::string& out,
+               std::string& error) const;
+
+};
+
+/**
+ * Appends a string as quoted and escaped JSON string to out.
+ */
+void AppendJsonString (std::string& out, std::string_view str);
+
+} // namespace ethutils
+
+#endif // ETHUTILS_ABIJSON_HPP
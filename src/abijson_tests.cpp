@@ -0,0 +1,348 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "abijson.hpp"
+
+#include "hexutils.hpp"
+#include "uint256.hpp"
+
+#include <gtest/gtest.h>
+
+#include <glog/logging.h>
+
+namespace ethutils
+{
+namespace
+{
+
+class AbiJsonTests : public testing::Test
+{
+
+protected:
+
+  /**
+   * Converts hex data without 0x prefix to binary.
+   */
+  static std::string
+  Bin (const std::string& hex)
+  {
+    std::string res;
+    CHECK (Unhexlify (hex, res)) << hex;
+    return res;
+  }
+
+  /**
+   * Constructs a decode plan for a type string.
+   */
+  static std::unique_ptr<AbiDecodePlan>
+  Plan (const std::string& str)
+  {
+    AbiType type;
+    CHECK (AbiType::Parse (str, type)) << str;
+    return std::make_unique<AbiDecodePlan> (type);
+  }
+
+  /**
+   * Converts a string with AppendJsonString.
+   */
+  static std::string
+  JsonString (const std::string& str)
+  {
+    std::string res;
+    AppendJsonString (res, str);
+    return res;
+  }
+
+  /**
+   * Parses a JSON string, which must be valid.
+   */
+  static Json::Value
+  ParseJson (const std::string& str)
+  {
+    Json::CharReaderBuilder rbuilder;
+    std::unique_ptr<Json::CharReader> reader(rbuilder.newCharReader ());
+
+    Json::Value res;
+    std::string parseErrs;
+    CHECK (reader->parse (str.data (), str.data () + str.size (),
+                          &res, &parseErrs))
+        << "Failed to parse JSON: " << parseErrs;
+
+    return res;
+  }
+
+  /**
+   * Encodes a JSON value with an encoder for the given type.  Returns
+   * the binary data as hex on success, and the error message otherwise.
+   */
+  static std::string
+  EncodeJson (const std::string& type, const std::string& json)
+  {
+    const AbiJsonEncoder enc(Plan (type)->GetType ());
+
+    std::string bin, error;
+    if (!enc.Encode (ParseJson (json), bin, error))
+      return error;
+
+    return Hexlify (bin);
+  }
+
+};
+
+/** The type used in the AllTypes and RoundTrip tests.  */
+const std::string ALL_TYPES = "(uint8,int16,int256,uint256,address,bool,bytes3,"
+                              "bytes,string[],(uint64,int64,bool)[2])";
+
+/* (255, -300, -2^200, 2^255 + 1, 0x14e6..., true, 0x010203, 0xdead,
+   ["a\"b\\c\n", "\x01é€😀", ""],
+   [(2^64 - 1, -2^63, false), (0, 5, true)])
+   encoded with eth_abi.  */
+const std::string ALL_TYPES_DATA =
+    "00000000000000000000000000000000000000000000000000000000000000ff"
+    "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffed4"
+    "ffffffffffffff00000000000000000000000000000000000000000000000000"
+    "8000000000000000000000000000000000000000000000000000000000000001"
+    "00000000000000000000000014e663e1531e0f438840952d18720c74c28d4f20"
+    "0000000000000000000000000000000000000000000000000000000000000001"
+    "0102030000000000000000000000000000000000000000000000000000000000"
+    "00000000000000000000000000000000000000000000000000000000000001e0"
+    "0000000000000000000000000000000000000000000000000000000000000220"
+    "000000000000000000000000000000000000000000000000ffffffffffffffff"
+    "ffffffffffffffffffffffffffffffffffffffffffffffff8000000000000000"
+    "0000000000000000000000000000000000000000000000000000000000000000"
+    "0000000000000000000000000000000000000000000000000000000000000000"
+    "0000000000000000000000000000000000000000000000000000000000000005"
+    "0000000000000000000000000000000000000000000000000000000000000001"
+    "0000000000000000000000000000000000000000000000000000000000000002"
+    "dead000000000000000000000000000000000000000000000000000000000000"
+    "0000000000000000000000000000000000000000000000000000000000000003"
+    "0000000000000000000000000000000000000000000000000000000000000060"
+    "00000000000000000000000000000000000000000000000000000000000000a0"
+    "00000000000000000000000000000000000000000000000000000000000000e0"
+    "0000000000000000000000000000000000000000000000000000000000000006"
+    "6122625c630a0000000000000000000000000000000000000000000000000000"
+    "000000000000000000000000000000000000000000000000000000000000000a"
+    "01c3a9e282acf09f988000000000000000000000000000000000000000000000"
+    "0000000000000000000000000000000000000000000000000000000000000000";
+
+TEST_F (AbiJsonTests, AllTypes)
+{
+  const std::string data = Bin (ALL_TYPES_DATA);
+  const auto plan = Plan (ALL_TYPES);
+
+  const std::string addr
+      = Address ("0x14e663e1531e0f438840952d18720c74c28d4f20")
+          .GetChecksummed ();
+
+  std::string out = "prefix:";
+  ASSERT_TRUE (AbiJsonWriter::Convert (*plan, data, out));
+  EXPECT_EQ (out,
+      "prefix:"
+      "[255,-300,"
+      "\"-16069380442589902755419620923411626025"
+      "22202993782792835301376\","
+      "\"578960446186580977117854925043439539266"
+      "34992332820282019728792003956564819969\","
+      "\"" + addr + "\",true,\"0x010203\",\"0xdead\","
+      "[\"a\\\"b\\\\c\\n\","
+      "\"\\u0001\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80\",\"\"],"
+      "[[18446744073709551615,-9223372036854775808,false],[0,5,true]]]");
+}
+
+TEST_F (AbiJsonTests, EmptyTuplesAndArrays)
+{
+  /* ((), uint256[], (bool)) with an empty array.  */
+  const std::string data = Bin (
+      "0000000000000000000000000000000000000000000000000000000000000040"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "0000000000000000000000000000000000000000000000000000000000000000");
+
+  std::string out;
+  ASSERT_TRUE (AbiJsonWriter::Convert (*Plan ("((),uint256[],(bool))"),
+                                       data, out));
+  EXPECT_EQ (out, "[[],[],[true]]");
+}
+
+TEST_F (AbiJsonTests, InvalidData)
+{
+  /* A string whose length exceeds the data.  */
+  const std::string data = Bin (
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "0000000000000000000000000000000000000000000000000000000000000040"
+      "0000000000000000000000000000000000000000000000000000000000000021"
+      "6162630000000000000000000000000000000000000000000000000000000000");
+
+  std::string out = "unchanged";
+  EXPECT_FALSE (AbiJsonWriter::Convert (*Plan ("(uint8,string)"), data, out));
+  EXPECT_EQ (out, "unchanged");
+
+  /* Out-of-range value for uint8.  */
+  EXPECT_FALSE (AbiJsonWriter::Convert (
+      *Plan ("(uint8)"),
+      Bin ("0000000000000000000000000000000000000000000000000000000000000100"),
+      out));
+  EXPECT_EQ (out, "unchanged");
+
+  /* A uint256[][][] where all offsets in each array point to the same
+     child array.  This would expand to a million values.  */
+  const auto word = [] (const uint64_t val)
+    {
+      return Uint256 (val).ToBinary ();
+    };
+  const size_t n = 100;
+  std::string aliased = word (32);
+  for (unsigned level = 0; level < 3; ++level)
+    {
+      aliased += word (n);
+      for (size_t i = 0; i < n; ++i)
+        aliased += word (level < 2 ? 32 * n : i);
+    }
+  EXPECT_FALSE (AbiJsonWriter::Convert (*Plan ("(uint256[][][])"), aliased,
+                                        out));
+  EXPECT_EQ (out, "unchanged");
+}
+
+TEST_F (AbiJsonTests, StringEscaping)
+{
+  EXPECT_EQ (JsonString (""), "\"\"");
+  EXPECT_EQ (JsonString ("abc"), "\"abc\"");
+  EXPECT_EQ (JsonString ("\"\\/\b\f\n\r\t\x1f"),
+             "\"\\\"\\\\/\\u0008\\u000c\\n\\r\\t\\u001f\"");
+  EXPECT_EQ (JsonString (std::string ("a\0b", 3)), "\"a\\u0000b\"");
+
+  /* Valid multi-byte sequences are kept as they are.  */
+  const std::string valid
+      = "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80\xf4\x8f\xbf\xbf";
+  EXPECT_EQ (JsonString (valid), "\"" + valid + "\"");
+
+  /* Invalid ones (stray continuation bytes, truncated sequences, overlong
+     encodings, surrogates and too large code points) are replaced.  */
+  EXPECT_EQ (JsonString ("a\x80" "b"), "\"a\\ufffdb\"");
+  EXPECT_EQ (JsonString ("\xc3"), "\"\\ufffd\"");
+  EXPECT_EQ (JsonString ("\xe2\x82"), "\"\\ufffd\\ufffd\"");
+  EXPECT_EQ (JsonString ("\xc0\xaf"), "\"\\ufffd\\ufffd\"");
+  EXPECT_EQ (JsonString ("\xe0\x80\xaf"), "\"\\ufffd\\ufffd\\ufffd\"");
+  EXPECT_EQ (JsonString ("\xed\xa0\x80"), "\"\\ufffd\\ufffd\\ufffd\"");
+  EXPECT_EQ (JsonString ("\xf4\x90\x80\x80"),
+             "\"\\ufffd\\ufffd\\ufffd\\ufffd\"");
+  EXPECT_EQ (JsonString ("\xff"), "\"\\ufffd\"");
+}
+
+TEST_F (AbiJsonTests, EncodeFunctionCall)
+{
+  const auto enc = AbiJsonEncoder::ForFunction ("transfer(address,uint)");
+  EXPECT_EQ (Hexlify (enc.GetSelector ()), "a9059cbb");
+
+  std::string bin, error;
+  ASSERT_TRUE (enc.Encode (
+      ParseJson (R"(["0x14e663e1531e0f438840952d18720c74c28d4f20",
+                    "1000000000000000000"])"),
+      bin, error)) << error;
+  EXPECT_EQ (Hexlify (bin),
+      "a9059cbb"
+      "00000000000000000000000014e663e1531e0f438840952d18720c74c28d4f20"
+      "0000000000000000000000000000000000000000000000000de0b6b3a7640000");
+
+  EXPECT_DEATH (AbiJsonEncoder::ForFunction ("(uint256)"),
+                "Invalid function signature");
+  EXPECT_DEATH (AbiJsonEncoder::ForFunction ("foo(uint257)"),
+                "Invalid function signature");
+  const AbiType notTuple = Plan ("(uint8[])")->GetType ().GetComponents ()[0];
+  EXPECT_DEATH (AbiJsonEncoder {notTuple}, "must be a tuple");
+}
+
+TEST_F (AbiJsonTests, EncodeNested)
+{
+  /* (255, [(true, [127, -128]), (false, [])]) encoded with eth_abi.  */
+  EXPECT_EQ (EncodeJson ("(uint8,(bool,int8[])[])",
+                         R"([255, [[true, [127, "-0x80"]], [false, []]]])"),
+      "00000000000000000000000000000000000000000000000000000000000000ff"
+      "0000000000000000000000000000000000000000000000000000000000000040"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "0000000000000000000000000000000000000000000000000000000000000040"
+      "00000000000000000000000000000000000000000000000000000000000000e0"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "0000000000000000000000000000000000000000000000000000000000000040"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "000000000000000000000000000000000000000000000000000000000000007f"
+      "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff80"
+      "0000000000000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000040"
+      "0000000000000000000000000000000000000000000000000000000000000000");
+}
+
+TEST_F (AbiJsonTests, RoundTrip)
+{
+  std::string json;
+  ASSERT_TRUE (AbiJsonWriter::Convert (*Plan (ALL_TYPES), Bin (ALL_TYPES_DATA),
+                                       json));
+  EXPECT_EQ (EncodeJson (ALL_TYPES, json), ALL_TYPES_DATA);
+}
+
+TEST_F (AbiJsonTests, EncodeErrors)
+{
+  const std::string type = "(uint8,(bool,int8[])[])";
+  const std::string addr = "0x14e663e1531e0f438840952d18720c74c28d4f20";
+
+  EXPECT_EQ (EncodeJson (type, "{}"), "$: expected array with 2 values");
+  EXPECT_EQ (EncodeJson (type, "[1]"), "$: expected array with 2 values");
+  EXPECT_EQ (EncodeJson (type, "[256, []]"),
+             "$[0]: value out of range for uint8");
+  EXPECT_EQ (EncodeJson (type, R"(["-1", []])"),
+             "$[0]: negative value for uint8");
+  EXPECT_EQ (EncodeJson (type, "[1.5, []]"),
+             "$[0]: expected integer for uint8");
+  EXPECT_EQ (EncodeJson (type, R"(["0xg", []])"),
+             "$[0]: expected integer for uint8");
+  EXPECT_EQ (EncodeJson (type, "[0, {}]"), "$[1]: expected array");
+  EXPECT_EQ (EncodeJson (type, "[0, [[true]]]"),
+             "$[1][0]: expected 2 tuple members");
+  EXPECT_EQ (EncodeJson (type, "[0, [[true, []], [1, []]]]"),
+             "$[1][1][0]: expected bool");
+  EXPECT_EQ (EncodeJson (type, "[0, [[true, [127, 128]]]]"),
+             "$[1][0][1][1]: value out of range for int8");
+  EXPECT_EQ (EncodeJson (type, "[0, [[true, [-129]]]]"),
+             "$[1][0][1][0]: value out of range for int8");
+
+  EXPECT_EQ (EncodeJson ("(address)", "[42]"), "$[0]: expected address string");
+  const std::string badChecksum
+      = "0x14E663e1531e0f438840952d18720c74c28d4f20";
+  EXPECT_EQ (EncodeJson ("(address)", "[\"" + badChecksum + "\"]"),
+             "$[0]: invalid address");
+  EXPECT_EQ (EncodeJson ("(bytes3)", R"(["0x0102"])"),
+             "$[0]: expected 3 bytes");
+  EXPECT_EQ (EncodeJson ("(bytes)", R"(["0102"])"),
+             "$[0]: expected hex string");
+  EXPECT_EQ (EncodeJson ("(string)", "[true]"), "$[0]: expected string");
+  EXPECT_EQ (EncodeJson ("(uint8[2])", "[[1, 2, 3]]"),
+             "$[0]: expected 2 array elements");
+
+  EXPECT_EQ (EncodeJson ("(address)", "[\"0x" + std::string (40, 'G') + "\"]"),
+             "$[0]: invalid address");
+  EXPECT_EQ (EncodeJson ("(address)", R"(["0x14e663"])"),
+             "$[0]: invalid address");
+  EXPECT_EQ (EncodeJson ("(bytes)", R"(["0xABCG"])"),
+             "$[0]: expected hex string");
+
+  /* Edge cases that are valid.  */
+  EXPECT_EQ (EncodeJson ("(bytes,bytes2)", R"(["0xABcd", "0xEF01"])"),
+             "0000000000000000000000000000000000000000000000000000000000000040"
+             "ef01000000000000000000000000000000000000000000000000000000000000"
+             "0000000000000000000000000000000000000000000000000000000000000002"
+             "abcd000000000000000000000000000000000000000000000000000000000000");
+  const std::string checksummed = Address (addr).GetChecksummed ();
+  ASSERT_NE (checksummed, addr);
+  EXPECT_EQ (EncodeJson ("(address)", "[\"" + checksummed + "\"]"),
+             "000000000000000000000000" + addr.substr (2));
+  EXPECT_EQ (EncodeJson ("(int8,int8,uint256,address)",
+                         R"([-128, "127", "0x)" + std::string (64, 'f')
+                            + R"(", ")" + addr + R"("])"),
+             "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff80"
+             "000000000000000000000000000000000000000000000000000000000000007f"
+             + std::string (64, 'f')
+             + "000000000000000000000000" + addr.substr (2));
+}
+
+} // anonymous namespace
+} // namespace ethutils
@@ -0,0 +1,508 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "abiplan.hpp"
+
+#include "hexutils.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+namespace ethutils
+{
+
+namespace
+{
+
+/** Size of an ABI word.  */
+constexpr size_t WORD = 32;
+
+/**
+ * Returns true if all the given bytes are equal to b.
+ */
+bool
+AllBytes (const std::string_view data, const unsigned char b)
+{
+  for (const char c : data)
+    if (static_cast<unsigned char> (c) != b)
+      return false;
+  return true;
+}
+
+/**
+ * Reads the word at pos as size or offset value.  Returns false if it is
+ * out of the data range, or if the value is larger than the data size
+ * (which cannot be valid for either sizes or offsets).
+ */
+bool
+ReadSize (const std::string_view bin, const size_t pos, size_t& val)
+{
+  if (pos > bin.size () || bin.size () - pos < WORD)
+    return false;
+
+  const std::string_view word = bin.substr (pos, WORD);
+  if (!AllBytes (word.substr (0, WORD - 8), 0))
+    return false;
+
+  uint64_t res = 0;
+  for (const char c : word.substr (WORD - 8))
+    res = (res << 8) | static_cast<unsigned char> (c);
+
+  if (res > bin.size ())
+    return false;
+
+  val = res;
+  return true;
+}
+
+/**
+ * Checks that an atomic word is valid for its type.
+ */
+bool
+CheckWord (const AbiType::Kind kind, const size_t size,
+           const std::string_view word)
+{
+  using Kind = AbiType::Kind;
+
+  switch (kind)
+    {
+    case Kind::UINT:
+      return AllBytes (word.substr (0, WORD - size / 8), 0);
+
+    case Kind::INT:
+      {
+        /* The value must be sign-extended from its bit size.  */
+        const size_t pad = WORD - size / 8;
+        const bool negative = static_cast<unsigned char> (word[pad]) & 0x80;
+        return AllBytes (word.substr (0, pad), negative ? 0xFF : 0);
+      }
+
+    case Kind::ADDRESS:
+      return AllBytes (word.substr (0, WORD - Address::BINARY_SIZE), 0);
+
+    case Kind::BOOL:
+      return AllBytes (word.substr (0, WORD - 1), 0)
+                && static_cast<unsigned char> (word[WORD - 1]) <= 1;
+
+    case Kind::FIXED_BYTES:
+      return AllBytes (word.substr (size), 0);
+
+    default:
+      LOG (FATAL) << "Unexpected atomic type kind: " << static_cast<int> (kind);
+      return false;
+    }
+}
+
+/**
+ * Charges the given cost against the remaining work budget.  Returns false
+ * if the budget is exhausted.
+ *
+ * Each dynamic array and bytes or string value costs the size of its own
+ * encoding (the length word plus the element heads or padded content),
+ * and the budget starts out as the size of the data.  Since these parts
+ * do not overlap in a proper encoding, it is never exceeded for valid
+ * data.  But it bounds the work for crafted data that points many offsets
+ * at the same tail data, which could otherwise expand to an exponential
+ * number of decoded values.
+ */
+bool
+Charge (size_t& budget, const size_t cost)
+{
+  if (cost > budget)
+    return false;
+
+  budget -= cost;
+  return true;
+}
+
+/**
+ * Reads the content of a bytes or string value whose encoding starts
+ * at pos.  The content must be followed by zero padding up to a full
+ * word, which must be present in the data.  Its size is charged against
+ * the budget.
+ */
+bool
+ReadBytes (const std::string_view bin, const size_t pos, size_t& budget,
+           std::string_view& out)
+{
+  size_t len;
+  if (!ReadSize (bin, pos, len))
+    return false;
+
+  const size_t start = pos + WORD;
+  const size_t padded = (len + WORD - 1) / WORD * WORD;
+  if (bin.size () - start < padded)
+    return false;
+  if (!AllBytes (bin.substr (start + len, padded - len), 0))
+    return false;
+  if (!Charge (budget, WORD + padded))
+    return false;
+
+  out = bin.substr (start, len);
+  return true;
+}
+
+/**
+ * Reads the word of an atomic value at pos, and checks that it is valid
+ * for the type.
+ */
+bool
+ReadWord (const AbiType::Kind kind, const size_t size,
+          const std::string_view bin, const size_t pos, std::string_view& out)
+{
+  if (pos > bin.size () || bin.size () - pos < WORD)
+    return false;
+
+  const std::string_view word = bin.substr (pos, WORD);
+  if (!CheckWord (kind, size, word))
+    return false;
+
+  out = word;
+  return true;
+}
+
+/**
+ * Reads the length of a (fixed or dynamic) array whose encoding starts
+ * at pos, and the position where the element heads start.  Makes sure
+ * the heads of all elements are within the data, so that callers can
+ * allocate memory for them.  Dynamic arrays are charged against the
+ * budget, with elements that have no head data counting as one byte.
+ */
+bool
+ReadArray (const AbiType::Kind kind, const size_t size, const size_t elemHead,
+           const std::string_view bin, const size_t pos, size_t& budget,
+           size_t& len, size_t& base)
+{
+  len = size;
+  base = pos;
+  if (kind == AbiType::Kind::ARRAY)
+    {
+      if (!ReadSize (bin, pos, len))
+        return false;
+      base += WORD;
+    }
+
+  if (base > bin.size ()
+        || (elemHead != 0 && len > (bin.size () - base) / elemHead))
+    return false;
+
+  if (kind == AbiType::Kind::ARRAY
+        && !Charge (budget, WORD + len * std::max<size_t> (elemHead, 1)))
+    return false;
+
+  return true;
+}
+
+} // anonymous namespace
+
+/* ************************************************************************** */
+
+bool
+AbiValue::GetBool () const
+{
+  CHECK_EQ (data.size (), WORD);
+  return data[WORD - 1] != 0;
+}
+
+uint64_t
+AbiValue::GetUint64 () const
+{
+  CHECK_EQ (data.size (), WORD);
+  CHECK (AllBytes (data.substr (0, WORD - 8), 0))
+      << "Value does not fit into 64 bits";
+
+  uint64_t res = 0;
+  for (const char c : data.substr (WORD - 8))
+    res = (res << 8) | static_cast<unsigned char> (c);
+
+  return res;
+}
+
+int64_t
+AbiValue::GetInt64 () const
+{
+  CHECK_EQ (data.size (), WORD);
+  const bool negative = static_cast<unsigned char> (data[WORD - 8]) & 0x80;
+  CHECK (AllBytes (data.substr (0, WORD - 8), negative ? 0xFF : 0))
+      << "Value does not fit into 64 bits";
+
+  uint64_t res = 0;
+  for (const char c : data.substr (WORD - 8))
+    res = (res << 8) | static_cast<unsigned char> (c);
+
+  return static_cast<int64_t> (res);
+}
+
+Address
+AbiValue::GetAddress () const
+{
+  CHECK_EQ (data.size (), WORD);
+
+  std::string hex(2 + 2 * Address::BINARY_SIZE, '\0');
+  hex[0] = '0';
+  hex[1] = 'x';
+  Hexlify (reinterpret_cast<const unsigned char*> (data.data ())
+              + WORD - Address::BINARY_SIZE,
+           Address::BINARY_SIZE, &hex[2]);
+
+  return Address (hex);
+}
+
+/* ************************************************************************** */
+
+AbiDecodePlan::AbiDecodePlan (const AbiType& t)
+  : type(t)
+{
+  steps.emplace_back ();
+  Compile (0, type, 0);
+}
+
+void
+AbiDecodePlan::Compile (const size_t idx, const AbiType& t,
+                        const size_t offset)
+{
+  Step s;
+  s.kind = t.GetKind ();
+  s.size = t.GetSize ();
+  s.dynamic = t.IsDynamic ();
+  s.headSize = t.GetHeadSize ();
+  s.offset = offset;
+  s.first = steps.size ();
+  s.count = 0;
+
+  std::vector<const AbiType*> children;
+  switch (s.kind)
+    {
+    case AbiType::Kind::TUPLE:
+      for (const auto& c : t.GetComponents ())
+        children.push_back (&c);
+      break;
+    case AbiType::Kind::ARRAY:
+    case AbiType::Kind::FIXED_ARRAY:
+      children.push_back (&t.GetElement ());
+      break;
+    default:
+      break;
+    }
+
+  /* The children are stored in a contiguous block, and their own
+     children follow after it.  */
+  s.count = children.size ();
+  steps.resize (steps.size () + s.count);
+  steps[idx] = s;
+
+  size_t childOffset = 0;
+  for (size_t i = 0; i < children.size (); ++i)
+    {
+      const bool inTuple = (s.kind == AbiType::Kind::TUPLE);
+      Compile (s.first + i, *children[i], inTuple ? childOffset : 0);
+      childOffset += children[i]->GetHeadSize ();
+    }
+}
+
+bool
+AbiDecodePlan::DecodeSlot (const size_t idx, const std::string_view bin,
+                           const size_t base, const size_t slot,
+                           size_t& budget, AbiValue& out) const
+{
+  if (!steps[idx].dynamic)
+    return DecodeAt (idx, bin, slot, budget, out);
+
+  size_t ptr;
+  if (!ReadSize (bin, slot, ptr) || ptr > bin.size () - base)
+    return false;
+
+  return DecodeAt (idx, bin, base + ptr, budget, out);
+}
+
+bool
+AbiDecodePlan::DecodeAt (const size_t idx, const std::string_view bin,
+                         const size_t pos, size_t& budget,
+                         AbiValue& out) const
+{
+  const Step& s = steps[idx];
+  out.data = std::string_view ();
+  out.elements.clear ();
+
+  switch (s.kind)
+    {
+    case AbiType::Kind::BYTES:
+    case AbiType::Kind::STRING:
+      return ReadBytes (bin, pos, budget, out.data);
+
+    case AbiType::Kind::TUPLE:
+      out.elements.resize (s.count);
+      for (size_t i = 0; i < s.count; ++i)
+        {
+          const size_t child = s.first + i;
+          if (!DecodeSlot (child, bin, pos, pos + steps[child].offset,
+                           budget, out.elements[i]))
+            return false;
+        }
+      return true;
+
+    case AbiType::Kind::FIXED_ARRAY:
+    case AbiType::Kind::ARRAY:
+      {
+        const size_t elemHead = steps[s.first].headSize;
+        size_t len, base;
+        if (!ReadArray (s.kind, s.size, elemHead, bin, pos, budget,
+                        len, base))
+          return false;
+
+        out.elements.resize (len);
+        for (size_t i = 0; i < len; ++i)
+          if (!DecodeSlot (s.first, bin, base, base + i * elemHead, budget,
+                           out.elements[i]))
+            return false;
+        return true;
+      }
+
+    default:
+      {
+        std::string_view word;
+        if (!ReadWord (s.kind, s.size, bin, pos, word))
+          return false;
+
+        if (s.kind == AbiType::Kind::FIXED_BYTES)
+          out.data = word.substr (0, s.size);
+        else
+          out.data = word;
+        return true;
+      }
+    }
+}
+
+bool
+AbiDecodePlan::VisitSlot (const size_t idx, const std::string_view bin,
+                          const size_t base, const size_t slot,
+                          size_t& budget, AbiVisitor& v) const
+{
+  if (!steps[idx].dynamic)
+    return VisitAt (idx, bin, slot, budget, v);
+
+  size_t ptr;
+  if (!ReadSize (bin, slot, ptr) || ptr > bin.size () - base)
+    return false;
+
+  return VisitAt (idx, bin, base + ptr, budget, v);
+}
+
+bool
+AbiDecodePlan::VisitAt (const size_t idx, const std::string_view bin,
+                        const size_t pos, size_t& budget,
+                        AbiVisitor& v) const
+{
+  const Step& s = steps[idx];
+  switch (s.kind)
+    {
+    case AbiType::Kind::BYTES:
+    case AbiType::Kind::STRING:
+      {
+        std::string_view data;
+        if (!ReadBytes (bin, pos, budget, data))
+          return false;
+
+        if (s.kind == AbiType::Kind::STRING)
+          v.VisitString (data);
+        else
+          v.VisitBytes (data);
+        return true;
+      }
+
+    case AbiType::Kind::TUPLE:
+      v.BeginTuple (s.count);
+      for (size_t i = 0; i < s.count; ++i)
+        {
+          const size_t child = s.first + i;
+          if (!VisitSlot (child, bin, pos, pos + steps[child].offset, budget,
+                          v))
+            return false;
+        }
+      v.EndTuple ();
+      return true;
+
+    case AbiType::Kind::FIXED_ARRAY:
+    case AbiType::Kind::ARRAY:
+      {
+        const size_t elemHead = steps[s.first].headSize;
+        size_t len, base;
+        if (!ReadArray (s.kind, s.size, elemHead, bin, pos, budget,
+                        len, base))
+          return false;
+
+        v.BeginArray (len);
+        for (size_t i = 0; i < len; ++i)
+          if (!VisitSlot (s.first, bin, base, base + i * elemHead, budget, v))
+            return false;
+        v.EndArray ();
+        return true;
+      }
+
+    default:
+      break;
+    }
+
+  std::string_view word;
+  if (!ReadWord (s.kind, s.size, bin, pos, word))
+    return false;
+  const auto* bytes = reinterpret_cast<const unsigned char*> (word.data ());
+
+  switch (s.kind)
+    {
+    case AbiType::Kind::UINT:
+      v.VisitUint (s.size, Uint256::FromBinary (bytes));
+      break;
+
+    case AbiType::Kind::INT:
+      {
+        const Uint256 val = Uint256::FromBinary (bytes);
+        if (bytes[0] & 0x80)
+          v.VisitInt (s.size, true, Uint256 () - val);
+        else
+          v.VisitInt (s.size, false, val);
+        break;
+      }
+
+    case AbiType::Kind::ADDRESS:
+      {
+        Address::Binary addr;
+        std::copy (bytes + WORD - addr.size (), bytes + WORD, addr.begin ());
+        v.VisitAddress (addr);
+        break;
+      }
+
+    case AbiType::Kind::BOOL:
+      v.VisitBool (bytes[WORD - 1] != 0);
+      break;
+
+    case AbiType::Kind::FIXED_BYTES:
+      v.VisitFixedBytes (word.substr (0, s.size));
+      break;
+
+    default:
+      LOG (FATAL) << "Unexpected type kind: " << static_cast<int> (s.kind);
+    }
+
+  return true;
+}
+
+bool
+AbiDecodePlan::Decode (const std::string_view bin, AbiValue& out) const
+{
+  size_t budget = bin.size ();
+  return DecodeAt (0, bin, 0, budget, out);
+}
+
+bool
+AbiDecodePlan::Visit (const std::string_view bin, AbiVisitor& v) const
+{
+  size_t budget = bin.size ();
+  return VisitAt (0, bin, 0, budget, v);
+}
+
+/* ************************************************************************** */
+
+} // namespace ethutils
@@ -0,0 +1,235 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ETHUTILS_ABIPLAN_HPP
+#define ETHUTILS_ABIPLAN_HPP
+
+#include "abitype.hpp"
+#include "address.hpp"
+#include "uint256.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace ethutils
+{
+
+/**
+ * A value decoded by an AbiDecodePlan.  Data is referenced as views into
+ * the decoded binary payload, which must outlive the value.
+ */
+struct AbiValue
+{
+
+  /**
+   * The data of atomic types.  For integers, addresses and bools this
+   * is the raw 32-byte word, for bytesN it is the N bytes, and for bytes
+   * and string it is the content.  Empty for tuples and arrays.
+   *
+   * This points into the buffer passed to AbiDecodePlan::Decode, and is
+   * only valid while that buffer lives.
+   */
+  std::string_view data;
+
+  /** The elements of tuples and arrays.  */
+  std::vector<AbiValue> elements;
+
+  /**
+   * Returns the value of a bool.
+   */
+  bool GetBool () const;
+
+  /**
+   * Returns the value of an unsigned integer.  CHECK-fails if it
+   * does not fit into 64 bits.
+   */
+  uint64_t GetUint64 () const;
+
+  /**
+   * Returns the value of a signed integer.  CHECK-fails if it does
+   * not fit into 64 bits.
+   */
+  int64_t GetInt64 () const;
+
+  /**
+   * Returns the value of an address.
+   */
+  Address GetAddress () const;
+
+};
+
+/**
+ * Interface for visitors that receive decoded ABI data as a stream of
+ * callbacks, without building any intermediate objects.  Tuples and arrays
+ * are reported with matching Begin/End calls around their elements.
+ * Views passed to the callbacks reference the decoded binary payload.
+ */
+class AbiVisitor
+{
+
+public:
+
+  AbiVisitor () = default;
+  virtual ~AbiVisitor () = default;
+
+  /**
+   * Called at the start of a tuple with the given number of components.
+   */
+  virtual void BeginTuple (size_t count) = 0;
+  virtual void EndTuple () = 0;
+
+  /**
+   * Called at the start of a (fixed or dynamic) array with the given
+   * number of elements.
+   */
+  virtual void BeginArray (size_t len) = 0;
+  virtual void EndArray () = 0;
+
+  /**
+   * Called for an unsigned integer of the given bit size.
+   */
+  virtual void VisitUint (size_t bits, const Uint256& val) = 0;
+
+  /**
+   * Called for a signed integer of the given bit size, with its
+   * sign and absolute value.
+   */
+  virtual void VisitInt (size_t bits, bool negative,
+                         const Uint256& magnitude) = 0;
+
+  virtual void VisitAddress (const Address::Binary& addr) = 0;
+  virtual void VisitBool (bool val) = 0;
+
+  /**
+   * Called for bytesN values, with the N bytes of data.
+   */
+  virtual void VisitFixedBytes (std::string_view data) = 0;
+
+  virtual void VisitBytes (std::string_view data) = 0;
+  virtual void VisitString (std::string_view data) = 0;
+
+};
+
+/**
+ * A decoder for ABI-encoded data of a fixed type.  The type is compiled
+ * once into a flat list of steps with precomputed head offsets and sizes,
+ * and the plan can then be used to decode many payloads without looking
+ * at the type again.
+ */
+class AbiDecodePlan
+{
+
+private:
+
+  /**
+   * One step of the plan, corresponding to a (sub-)type.
+   */
+  struct Step
+  {
+
+    AbiType::Kind kind;
+
+    /** The size parameter of the type (see AbiType::GetSize).  */
+    size_t size;
+
+    /** Whether the type is dynamic.  */
+    bool dynamic;
+
+    /** The type's head size (see AbiType::GetHeadSize).  */
+    size_t headSize;
+
+    /**
+     * The index of the first child step (tuple components or the
+     * array element) and their number.
+     */
+    size_t first;
+    size_t count;
+
+    /**
+     * The offset of this value's head slot inside the enclosing tuple's
+     * head (zero for array elements and the root).
+     */
+    size_t offset;
+
+  };
+
+  /** The type being decoded.  */
+  AbiType type;
+
+  /** The steps of the plan, with the root at index zero.  */
+  std::vector<Step> steps;
+
+  /**
+   * Fills in the step at the given index (which must exist already)
+   * for the given type, and compiles its children.
+   */
+  void Compile (size_t idx, const AbiType& t, size_t offset);
+
+  /**
+   * Decodes the value of a step whose encoding starts at pos.  The work
+   * done is charged against budget (see Decode).
+   */
+  bool DecodeAt (size_t idx, std::string_view bin, size_t pos,
+                 size_t& budget, AbiValue& out) const;
+
+  /**
+   * Decodes the value of a step from its head slot.  For dynamic types,
+   * the slot holds an offset relative to base.
+   */
+  bool DecodeSlot (size_t idx, std::string_view bin, size_t base, size_t slot,
+                   size_t& budget, AbiValue& out) const;
+
+  /**
+   * Visits the value of a step whose encoding starts at pos.
+   */
+  bool VisitAt (size_t idx, std::string_view bin, size_t pos,
+                size_t& budget, AbiVisitor& v) const;
+
+  /**
+   * Visits the value of a step from its head slot.
+   */
+  bool VisitSlot (size_t idx, std::string_view bin, size_t base, size_t slot,
+                  size_t& budget, AbiVisitor& v) const;
+
+public:
+
+  explicit AbiDecodePlan (const AbiType& t);
+
+  AbiDecodePlan (const AbiDecodePlan&) = delete;
+  void operator= (const AbiDecodePlan&) = delete;
+
+  const AbiType&
+  GetType () const
+  {
+    return type;
+  }
+
+  /**
+   * Decodes a binary payload as the encoding of a value of the plan's type.
+   * For event data or function arguments, the type should be the tuple
+   * of all parameters.  Returns false if the data is not a valid encoding
+   * (e.g. out-of-range offsets, or non-zero padding).
+   *
+   * The total size of all dynamic arrays and bytes values decoded must
+   * not exceed the size of the data, which holds for any encoding in which
+   * their tail data does not overlap.  Data that points many offsets at the
+   * same tail data (and would otherwise expand to a huge number of values)
+   * is rejected instead.
+   */
+  bool Decode (std::string_view bin, AbiValue& out) const;
+
+  /**
+   * Decodes a binary payload and streams the values to a visitor.  This
+   * does the same validation (and enforces the same limit) as Decode.  If the data is invalid, false is
+   * returned, and the visitor may have received some callbacks already.
+   */
+  bool Visit (std::string_view bin, AbiVisitor& v) const;
+
+};
+
+} // namespace ethutils
+
+#endif // ETHUTILS_ABIPLAN_HPP
@@ -0,0 +1,238 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "abiplan.hpp"
+
+#include "hexutils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <glog/logging.h>
+
+namespace ethutils
+{
+namespace
+{
+
+class AbiDecodePlanTests : public testing::Test
+{
+
+protected:
+
+  /**
+   * Parses a type string, CHECK-failing if it is invalid.
+   */
+  static AbiType
+  Type (const std::string& str)
+  {
+    AbiType res;
+    CHECK (AbiType::Parse (str, res)) << str;
+    return res;
+  }
+
+  /**
+   * Converts hex data without 0x prefix to binary.
+   */
+  static std::string
+  Bin (const std::string& hex)
+  {
+    std::string res;
+    CHECK (Unhexlify (hex, res)) << hex;
+    return res;
+  }
+
+  /**
+   * Returns an ABI word holding the given number.
+   */
+  static std::string
+  Word (const uint64_t val)
+  {
+    std::string res(32, '\0');
+    for (size_t i = 0; i < 8; ++i)
+      res[31 - i] = static_cast<char> ((val >> (8 * i)) & 0xFF);
+    return res;
+  }
+
+  /**
+   * Returns data for the type (uint256[][][]), where each array has n
+   * elements but all offsets in an array point to the same child array.
+   * This expands to n^3 values from just O(n) bytes of data.
+   */
+  static std::string
+  AliasedArrays (const size_t n)
+  {
+    std::string res = Word (32);
+    for (unsigned level = 0; level < 3; ++level)
+      {
+        res += Word (n);
+        for (size_t i = 0; i < n; ++i)
+          res += Word (level < 2 ? 32 * n : i);
+      }
+    return res;
+  }
+
+};
+
+TEST_F (AbiDecodePlanTests, DynamicTypes)
+{
+  /* ("p", "domob", 2^200, 0x14e6..., [0x11..., 0x22...],
+      [(5, true), (2^64 - 1, false)]) encoded with eth_abi.  */
+  const std::string data = Bin (
+      "00000000000000000000000000000000000000000000000000000000000000c0"
+      "0000000000000000000000000000000000000000000000000000000000000100"
+      "0000000000000100000000000000000000000000000000000000000000000000"
+      "00000000000000000000000014e663e1531e0f438840952d18720c74c28d4f20"
+      "0000000000000000000000000000000000000000000000000000000000000140"
+      "00000000000000000000000000000000000000000000000000000000000001a0"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "7000000000000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000005"
+      "646f6d6f62000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "1111111111111111111111111111111111111111111111111111111111111111"
+      "2222222222222222222222222222222222222222222222222222222222222222"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "0000000000000000000000000000000000000000000000000000000000000005"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "000000000000000000000000000000000000000000000000ffffffffffffffff"
+      "0000000000000000000000000000000000000000000000000000000000000000");
+
+  const AbiDecodePlan plan(
+      Type ("(string,string,uint256,address,bytes32[],(uint64,bool)[])"));
+
+  AbiValue val;
+  ASSERT_TRUE (plan.Decode (data, val));
+  ASSERT_EQ (val.elements.size (), 6);
+
+  EXPECT_EQ (val.elements[0].data, "p");
+  EXPECT_EQ (val.elements[1].data, "domob");
+  EXPECT_EQ (val.elements[1].data.data (), data.data () + 9 * 32)
+      << "Decoded string is not a view into the data";
+  EXPECT_EQ (Hexlify (std::string (val.elements[2].data)),
+             "00000000000001000000000000000000"
+             "00000000000000000000000000000000");
+  EXPECT_EQ (val.elements[3].GetAddress (),
+             Address ("0x14e663e1531e0f438840952d18720c74c28d4f20"));
+
+  const auto& hashes = val.elements[4].elements;
+  ASSERT_EQ (hashes.size (), 2);
+  EXPECT_EQ (hashes[0].data, std::string (32, '\x11'));
+  EXPECT_EQ (hashes[1].data, std::string (32, '\x22'));
+
+  const auto& pairs = val.elements[5].elements;
+  ASSERT_EQ (pairs.size (), 2);
+  EXPECT_EQ (pairs[0].elements[0].GetUint64 (), 5);
+  EXPECT_TRUE (pairs[0].elements[1].GetBool ());
+  EXPECT_EQ (pairs[1].elements[0].GetUint64 (), UINT64_MAX);
+  EXPECT_FALSE (pairs[1].elements[1].GetBool ());
+
+  /* The plan can be reused.  */
+  AbiValue val2;
+  ASSERT_TRUE (plan.Decode (data, val2));
+  EXPECT_EQ (val2.elements[1].data, "domob");
+}
+
+TEST_F (AbiDecodePlanTests, StaticTypes)
+{
+  /* (-2, -1000, "abc", [(1, false), (255, true)], ["x", ""]) for types
+     (int8,int256,bytes3,(uint8,bool)[2],string[2]) with eth_abi.  */
+  const std::string data = Bin (
+      "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffe"
+      "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffc18"
+      "6162630000000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "0000000000000000000000000000000000000000000000000000000000000000"
+      "00000000000000000000000000000000000000000000000000000000000000ff"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "0000000000000000000000000000000000000000000000000000000000000100"
+      "0000000000000000000000000000000000000000000000000000000000000040"
+      "0000000000000000000000000000000000000000000000000000000000000080"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "7800000000000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000000");
+
+  const AbiDecodePlan plan(
+      Type ("(int8,int256,bytes3,(uint8,bool)[2],string[2])"));
+
+  AbiValue val;
+  ASSERT_TRUE (plan.Decode (data, val));
+  ASSERT_EQ (val.elements.size (), 5);
+
+  EXPECT_EQ (val.elements[0].GetInt64 (), -2);
+  EXPECT_EQ (val.elements[1].GetInt64 (), -1000);
+  EXPECT_EQ (val.elements[2].data, "abc");
+
+  const auto& pairs = val.elements[3].elements;
+  ASSERT_EQ (pairs.size (), 2);
+  EXPECT_EQ (pairs[0].elements[0].GetUint64 (), 1);
+  EXPECT_FALSE (pairs[0].elements[1].GetBool ());
+  EXPECT_EQ (pairs[1].elements[0].GetUint64 (), 255);
+  EXPECT_TRUE (pairs[1].elements[1].GetBool ());
+
+  const auto& strs = val.elements[4].elements;
+  ASSERT_EQ (strs.size (), 2);
+  EXPECT_EQ (strs[0].data, "x");
+  EXPECT_EQ (strs[1].data, "");
+}
+
+TEST_F (AbiDecodePlanTests, InvalidData)
+{
+  AbiValue val;
+
+  const AbiDecodePlan uints(Type ("(uint8,bool,address)"));
+  const std::string zero(32, '\0');
+  const std::string one = Bin (
+      "0000000000000000000000000000000000000000000000000000000000000001");
+  const std::string big = Bin (
+      "0000000000000000000000000000000000000000000000000000000000000100");
+  EXPECT_TRUE (uints.Decode (one + one + one, val));
+  EXPECT_FALSE (uints.Decode (one + one, val));
+  EXPECT_FALSE (uints.Decode (big + one + one, val));
+  EXPECT_FALSE (uints.Decode (one + big + one, val));
+  EXPECT_FALSE (uints.Decode (one + one + std::string (32, '\xff'), val));
+
+  const AbiDecodePlan ints(Type ("(int8)"));
+  EXPECT_TRUE (ints.Decode (std::string (32, '\xff'), val));
+  EXPECT_FALSE (ints.Decode (std::string (31, '\xff') + '\x7f', val));
+  EXPECT_FALSE (ints.Decode (zero.substr (1) + '\x80', val));
+
+  const AbiDecodePlan bytes3(Type ("(bytes3)"));
+  EXPECT_TRUE (bytes3.Decode ("abc" + zero.substr (3), val));
+  EXPECT_FALSE (bytes3.Decode ("abcd" + zero.substr (4), val));
+
+  const std::string ptr = Bin (
+      "0000000000000000000000000000000000000000000000000000000000000020");
+  const AbiDecodePlan str(Type ("(string)"));
+  const std::string strData = ptr + one + "x" + zero.substr (1);
+  EXPECT_TRUE (str.Decode (strData, val));
+  EXPECT_EQ (val.elements[0].data, "x");
+  EXPECT_FALSE (str.Decode (ptr + one + "xy" + zero.substr (2), val));
+  EXPECT_FALSE (str.Decode (ptr + one + "x", val));
+  EXPECT_FALSE (str.Decode (big + one + "x" + zero.substr (1), val));
+  EXPECT_FALSE (str.Decode (ptr + big + "x" + zero.substr (1), val));
+
+  /* An array with huge length is rejected without allocating for it.  */
+  const AbiDecodePlan arr(Type ("(uint256[])"));
+  EXPECT_TRUE (arr.Decode (ptr + one + one, val));
+  EXPECT_FALSE (arr.Decode (ptr + big + one, val));
+  EXPECT_FALSE (arr.Decode (ptr + std::string (32, '\xff') + one, val));
+}
+
+TEST_F (AbiDecodePlanTests, AliasedTailData)
+{
+  const AbiDecodePlan plan(Type ("(uint256[][][])"));
+  AbiValue val;
+
+  /* With a single element per array, nothing is actually shared.  */
+  const std::string single = AliasedArrays (1);
+  ASSERT_TRUE (plan.Decode (single, val));
+  EXPECT_EQ (val.elements[0].elements[0].elements[0].elements[0].GetUint64 (),
+             0);
+
+  EXPECT_FALSE (plan.Decode (AliasedArrays (2), val));
+  EXPECT_FALSE (plan.Decode (AliasedArrays (100), val));
+}
+
+} // anonymous namespace
+} // namespace ethutils
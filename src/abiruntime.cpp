@@ -0,0 +1,26 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "abiruntime.hpp"
+
+#include <glog/logging.h>
+
+#include <cstdlib>
+
+namespace ethutils
+{
+namespace abigen
+{
+
+void
+IntegerOutOfRange (const unsigned bits, const bool isSigned)
+{
+  LOG (FATAL)
+      << "Value out of range for " << (isSigned ? "int" : "uint") << bits;
+  /* LOG (FATAL) aborts, but is not marked as noreturn.  */
+  std::abort ();
+}
+
+} // namespace abigen
+} // namespace ethutils
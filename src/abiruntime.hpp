@@ -0,0 +1,462 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ETHUTILS_ABIRUNTIME_HPP
+#define ETHUTILS_ABIRUNTIME_HPP
+
+#include "address.hpp"
+#include "uint256.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ethutils
+{
+
+/**
+ * Low-level helpers for reading and writing ABI words in binary buffers.
+ * These are used by the code that the abigen tool generates, which
+ * computes all static offsets itself and calls these with constant
+ * positions, so they are inline and do no more than needed.
+ *
+ * The Read functions return false if the data is out of range or does not
+ * fit the requested type.  The Put functions write into a buffer that has
+ * already been sized (and zero-filled) for the head, and the Append
+ * functions extend it with tail data.  Integers are checked against their
+ * declared bit size when written, and values that do not fit (e.g. 2^24
+ * in a uint32_t field for a uint24) CHECK-fail, since they would yield
+ * data that does not decode again.
+ */
+namespace abigen
+{
+
+/** Size of an ABI word.  */
+constexpr size_t WORD = 32;
+
+/** A raw 32-byte ABI word (e.g. for 256-bit integers or topic hashes).  */
+using Word = std::array<unsigned char, WORD>;
+
+/**
+ * Aborts the process for an integer value that does not fit into its
+ * declared type of the given bits.  This is kept out of line, so that
+ * the header does not depend on glog.
+ */
+[[noreturn]] void IntegerOutOfRange (unsigned bits, bool isSigned);
+
+/**
+ * Returns true if there is a full word at pos.
+ */
+inline bool
+HasWord (const std::string_view bin, const size_t pos)
+{
+  return pos <= bin.size () && bin.size () - pos >= WORD;
+}
+
+/**
+ * Returns a pointer to the bytes at pos as unsigned char.
+ */
+inline const unsigned char*
+Bytes (const std::string_view bin, const size_t pos)
+{
+  return reinterpret_cast<const unsigned char*> (bin.data ()) + pos;
+}
+
+/**
+ * Returns true if the n bytes at ptr are all equal to b.
+ */
+inline bool
+AllBytes (const unsigned char* ptr, const size_t n, const unsigned char b)
+{
+  for (size_t i = 0; i < n; ++i)
+    if (ptr[i] != b)
+      return false;
+  return true;
+}
+
+/**
+ * Reads the low 64 bits of the word at ptr as big-endian number.
+ */
+inline uint64_t
+Low64 (const unsigned char* ptr)
+{
+  uint64_t res = 0;
+  for (size_t i = WORD - 8; i < WORD; ++i)
+    res = (res << 8) | ptr[i];
+  return res;
+}
+
+/**
+ * Reads an unsigned integer of the given bit size (at most 64).
+ */
+template <typename T>
+  inline bool
+  ReadUint (const std::string_view bin, const size_t pos, const unsigned bits,
+            T& out)
+{
+  if (!HasWord (bin, pos))
+    return false;
+
+  const unsigned char* ptr = Bytes (bin, pos);
+  if (!AllBytes (ptr, WORD - bits / 8, 0))
+    return false;
+
+  out = static_cast<T> (Low64 (ptr));
+  return true;
+}
+
+/**
+ * Reads an unsigned integer of any bit size into a Uint256.
+ */
+inline bool
+ReadUint (const std::string_view bin, const size_t pos, const unsigned bits,
+          Uint256& out)
+{
+  if (!HasWord (bin, pos))
+    return false;
+
+  const unsigned char* ptr = Bytes (bin, pos);
+  if (!AllBytes (ptr, WORD - bits / 8, 0))
+    return false;
+
+  out = Uint256::FromBinary (ptr);
+  return true;
+}
+
+/**
+ * Reads a signed integer of the given bit size (at most 64).  The word must
+ * be correctly sign-extended.
+ */
+template <typename T>
+  inline bool
+  ReadInt (const std::string_view bin, const size_t pos, const unsigned bits,
+           T& out)
+{
+  if (!HasWord (bin, pos))
+    return false;
+
+  const unsigned char* ptr = Bytes (bin, pos);
+  const size_t pad = WORD - bits / 8;
+  if (!AllBytes (ptr, pad, (ptr[pad] & 0x80) ? 0xFF : 0))
+    return false;
+
+  out = static_cast<T> (static_cast<int64_t> (Low64 (ptr)));
+  return true;
+}
+
+/**
+ * Reads a raw word for an integer of more than 64 bits, checking that
+ * it fits into the given bit size (signed or unsigned).  This is used
+ * for signed integers, which have no native type here.
+ */
+inline bool
+ReadWideWord (const std::string_view bin, const size_t pos,
+              const unsigned bits, const bool isSigned, Word& out)
+{
+  if (!HasWord (bin, pos))
+    return false;
+
+  const unsigned char* ptr = Bytes (bin, pos);
+  const size_t pad = WORD - bits / 8;
+  const unsigned char fill = (isSigned && (ptr[pad] & 0x80)) ? 0xFF : 0;
+  if (!AllBytes (ptr, pad, fill))
+    return false;
+
+  std::copy (ptr, ptr + WORD, out.begin ());
+  return true;
+}
+
+inline bool
+ReadBool (const std::string_view bin, const size_t pos, bool& out)
+{
+  if (!HasWord (bin, pos))
+    return false;
+
+  const unsigned char* ptr = Bytes (bin, pos);
+  if (!AllBytes (ptr, WORD - 1, 0) || ptr[WORD - 1] > 1)
+    return false;
+
+  out = (ptr[WORD - 1] != 0);
+  return true;
+}
+
+/**
+ * Reads an address.  The padding is not checked, since the value is fully
+ * determined by the low 20 bytes.
+ */
+inline bool
+ReadAddress (const std::string_view bin, const size_t pos,
+             Address::Binary& out)
+{
+  if (!HasWord (bin, pos))
+    return false;
+
+  const unsigned char* ptr = Bytes (bin, pos) + WORD - Address::BINARY_SIZE;
+  std::copy (ptr, ptr + Address::BINARY_SIZE, out.begin ());
+  return true;
+}
+
+/**
+ * Reads a bytesN value.  Like for addresses, the padding is not checked.
+ */
+template <size_t N>
+  inline bool
+  ReadFixedBytes (const std::string_view bin, const size_t pos,
+                  std::array<unsigned char, N>& out)
+{
+  static_assert (N >= 1 && N <= WORD, "invalid bytesN size");
+
+  if (!HasWord (bin, pos))
+    return false;
+
+  const unsigned char* ptr = Bytes (bin, pos);
+  std::copy (ptr, ptr + N, out.begin ());
+  return true;
+}
+
+/**
+ * Reads a word used as size or offset.  Such values must be at most
+ * the data size to be valid.
+ */
+inline bool
+ReadSize (const std::string_view bin, const size_t pos, size_t& out)
+{
+  if (!HasWord (bin, pos))
+    return false;
+
+  const unsigned char* ptr = Bytes (bin, pos);
+  if (!AllBytes (ptr, WORD - 8, 0))
+    return false;
+
+  const uint64_t val = Low64 (ptr);
+  if (val > bin.size ())
+    return false;
+
+  out = val;
+  return true;
+}
+
+/**
+ * Reads the offset in the head slot at slot, and returns the absolute
+ * position of the dynamic data (relative to base) in out.
+ */
+inline bool
+ReadOffset (const std::string_view bin, const size_t base, const size_t slot,
+            size_t& out)
+{
+  size_t ptr;
+  if (!ReadSize (bin, slot, ptr) || ptr > bin.size () - base)
+    return false;
+
+  out = base + ptr;
+  return true;
+}
+
+/**
+ * Charges the given cost against the remaining budget of a decode call.
+ * Returns false if it is exhausted.
+ *
+ * The generated code starts with the data size as budget, and charges
+ * each dynamic array and bytes value with the size of its encoding.
+ * This is never exceeded if their tail data does not overlap, but rejects
+ * crafted data that points many offsets at the same tail data (and would
+ * otherwise expand to a huge number of values).
+ */
+inline bool
+Charge (size_t& budget, const size_t cost)
+{
+  if (cost > budget)
+    return false;
+
+  budget -= cost;
+  return true;
+}
+
+/**
+ * Reads dynamic bytes or string data (length word and padded content)
+ * at pos, and charges its size against budget.
+ */
+inline bool
+ReadBytes (const std::string_view bin, const size_t pos, size_t& budget,
+           std::string& out)
+{
+  size_t len;
+  if (!ReadSize (bin, pos, len))
+    return false;
+
+  const size_t start = pos + WORD;
+  const size_t padded = (len + WORD - 1) / WORD * WORD;
+  if (bin.size () - start < padded
+        || !AllBytes (Bytes (bin, start + len), padded - len, 0)
+        || !Charge (budget, WORD + padded))
+    return false;
+
+  out.assign (bin.data () + start, len);
+  return true;
+}
+
+/**
+ * Reads the length of a dynamic array at pos, and sets base to the start
+ * of its elements.  The length is checked against the remaining data,
+ * based on the head size of each element, and the array is charged
+ * against budget (with elements without head data counting as one byte).
+ */
+inline bool
+ReadArrayLength (const std::string_view bin, const size_t pos,
+                 const size_t elemHead, size_t& budget,
+                 size_t& len, size_t& base)
+{
+  if (!ReadSize (bin, pos, len))
+    return false;
+
+  base = pos + WORD;
+  if (elemHead != 0 && len > (bin.size () - base) / elemHead)
+    return false;
+
+  return Charge (budget, WORD + len * std::max<size_t> (elemHead, 1));
+}
+
+/**
+ * Writes the low 64 bits of a word at pos.  The word must be zero-filled
+ * already, or filled with 0xFF for negative numbers.
+ */
+inline void
+PutLow64 (std::string& out, const size_t pos, uint64_t val)
+{
+  for (size_t i = 0; i < 8; ++i)
+    {
+      out[pos + WORD - 1 - i] = static_cast<char> (val & 0xFF);
+      val >>= 8;
+    }
+}
+
+/**
+ * Writes an unsigned integer of the given bit size (at most 64).
+ */
+inline void
+PutUint (std::string& out, const size_t pos, const unsigned bits,
+         const uint64_t val)
+{
+  if (bits < 64 && (val >> bits) != 0)
+    IntegerOutOfRange (bits, false);
+  PutLow64 (out, pos, val);
+}
+
+/**
+ * Writes an unsigned integer of any bit size from a Uint256.
+ */
+inline void
+PutUint (std::string& out, const size_t pos, const unsigned bits,
+         const Uint256& val)
+{
+  unsigned char* ptr = reinterpret_cast<unsigned char*> (&out[pos]);
+  val.ToBinary (ptr);
+  if (!AllBytes (ptr, WORD - bits / 8, 0))
+    IntegerOutOfRange (bits, false);
+}
+
+/**
+ * Writes a signed integer of the given bit size (at most 64).
+ */
+inline void
+PutInt (std::string& out, const size_t pos, const unsigned bits,
+        const int64_t val)
+{
+  if (bits < 64)
+    {
+      const int64_t limit = int64_t (1) << (bits - 1);
+      if (val < -limit || val >= limit)
+        IntegerOutOfRange (bits, true);
+    }
+
+  if (val < 0)
+    std::fill (&out[pos], &out[pos] + WORD - 8, '\xFF');
+  PutLow64 (out, pos, static_cast<uint64_t> (val));
+}
+
+/**
+ * Writes a raw word for a signed integer of more than 64 bits, which must
+ * be correctly sign-extended from the given bit size.
+ */
+inline void
+PutWideInt (std::string& out, const size_t pos, const unsigned bits,
+            const Word& val)
+{
+  const size_t pad = WORD - bits / 8;
+  if (!AllBytes (val.data (), pad, (val[pad] & 0x80) ? 0xFF : 0))
+    IntegerOutOfRange (bits, true);
+  std::copy (val.begin (), val.end (), &out[pos]);
+}
+
+inline void
+PutBool (std::string& out, const size_t pos, const bool val)
+{
+  out[pos + WORD - 1] = val ? 1 : 0;
+}
+
+inline void
+PutAddress (std::string& out, const size_t pos, const Address::Binary& val)
+{
+  std::copy (val.begin (), val.end (),
+             &out[pos + WORD - Address::BINARY_SIZE]);
+}
+
+template <size_t N>
+  inline void
+  PutFixedBytes (std::string& out, const size_t pos,
+                 const std::array<unsigned char, N>& val)
+{
+  std::copy (val.begin (), val.end (), &out[pos]);
+}
+
+/**
+ * Writes the offset of dynamic data that starts at the current end of
+ * the buffer into the head slot at slot, relative to base.
+ */
+inline void
+PutOffset (std::string& out, const size_t base, const size_t slot)
+{
+  PutLow64 (out, slot, out.size () - base);
+}
+
+/**
+ * Extends the buffer by n zero bytes, and returns the position
+ * where they start.
+ */
+inline size_t
+Reserve (std::string& out, const size_t n)
+{
+  const size_t pos = out.size ();
+  out.resize (pos + n, '\0');
+  return pos;
+}
+
+/**
+ * Appends a length (or other size) word.
+ */
+inline void
+AppendSize (std::string& out, const size_t val)
+{
+  PutLow64 (out, Reserve (out, WORD), val);
+}
+
+/**
+ * Appends dynamic bytes or string data (length word and padded content).
+ */
+inline void
+AppendBytes (std::string& out, const std::string_view data)
+{
+  AppendSize (out, data.size ());
+  const size_t pos = Reserve (out, (data.size () + WORD - 1) / WORD * WORD);
+  std::copy (data.begin (), data.end (), &out[pos]);
+}
+
+} // namespace abigen
+
+} // namespace ethutils
+
+#endif // ETHUTILS_ABIRUNTIME_HPP
@@ -0,0 +1,283 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "abitype.hpp"
+
+#include <glog/logging.h>
+
+#include <utility>
+
+namespace ethutils
+{
+
+namespace
+{
+
+/**
+ * Maximum static encoding size we allow for types.  This prevents overflows
+ * in the size computation for absurd fixed arrays.
+ */
+constexpr size_t MAX_STATIC_SIZE = 1 << 30;
+
+bool
+IsDigit (const char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+/**
+ * Parses a decimal number without leading zeros from the start of str.
+ * Returns false if there is none or it is larger than MAX_STATIC_SIZE.
+ */
+bool
+ParseNumber (std::string_view& str, size_t& val)
+{
+  if (str.empty () || !IsDigit (str[0]) || (str[0] == '0' && str.size () > 1
+                                               && IsDigit (str[1])))
+    return false;
+
+  val = 0;
+  while (!str.empty () && IsDigit (str[0]))
+    {
+      val = 10 * val + (str[0] - '0');
+      if (val > MAX_STATIC_SIZE)
+        return false;
+      str.remove_prefix (1);
+    }
+
+  return true;
+}
+
+/**
+ * Parses an elementary type name (e.g. "uint64" or "bytes") from
+ * the given string, which must be the full name.
+ */
+bool
+ParseElementary (std::string_view name, AbiType::Kind& kind, size_t& size)
+{
+  using Kind = AbiType::Kind;
+
+  if (name == "address")
+    {
+      kind = Kind::ADDRESS;
+      return true;
+    }
+  if (name == "bool")
+    {
+      kind = Kind::BOOL;
+      return true;
+    }
+  if (name == "string")
+    {
+      kind = Kind::STRING;
+      return true;
+    }
+  if (name == "bytes")
+    {
+      kind = Kind::BYTES;
+      return true;
+    }
+
+  std::string_view rest;
+  if (name.substr (0, 4) == "uint")
+    {
+      kind = Kind::UINT;
+      rest = name.substr (4);
+    }
+  else if (name.substr (0, 3) == "int")
+    {
+      kind = Kind::INT;
+      rest = name.substr (3);
+    }
+  else if (name.substr (0, 5) == "bytes")
+    {
+      kind = Kind::FIXED_BYTES;
+      rest = name.substr (5);
+    }
+  else
+    return false;
+
+  if (rest.empty () && kind != Kind::FIXED_BYTES)
+    {
+      size = 256;
+      return true;
+    }
+
+  if (!ParseNumber (rest, size) || !rest.empty ())
+    return false;
+
+  if (kind == Kind::FIXED_BYTES)
+    return size >= 1 && size <= 32;
+
+  return size >= 8 && size <= 256 && size % 8 == 0;
+}
+
+} // anonymous namespace
+
+bool
+AbiType::ComputeLayout ()
+{
+  switch (kind)
+    {
+    case Kind::BYTES:
+    case Kind::STRING:
+    case Kind::ARRAY:
+      dynamic = true;
+      return true;
+
+    case Kind::FIXED_ARRAY:
+      dynamic = components[0].dynamic;
+      if (!dynamic)
+        {
+          if (size > 0
+                && components[0].staticSize > MAX_STATIC_SIZE / size)
+            return false;
+          staticSize = size * components[0].staticSize;
+        }
+      return true;
+
+    case Kind::TUPLE:
+      dynamic = false;
+      staticSize = 0;
+      for (const auto& c : components)
+        {
+          if (c.dynamic)
+            dynamic = true;
+          staticSize += c.GetHeadSize ();
+          if (staticSize > MAX_STATIC_SIZE)
+            return false;
+        }
+      return true;
+
+    default:
+      dynamic = false;
+      staticSize = 32;
+      return true;
+    }
+}
+
+bool
+AbiType::ParseInternal (std::string_view& str, AbiType& out)
+{
+  out = AbiType ();
+
+  if (!str.empty () && str[0] == '(')
+    {
+      out.kind = Kind::TUPLE;
+      str.remove_prefix (1);
+
+      if (!str.empty () && str[0] == ')')
+        str.remove_prefix (1);
+      else
+        while (true)
+          {
+            out.components.emplace_back ();
+            if (!ParseInternal (str, out.components.back ()))
+              return false;
+
+            if (str.empty ())
+              return false;
+            const char sep = str[0];
+            str.remove_prefix (1);
+            if (sep == ')')
+              break;
+            if (sep != ',')
+              return false;
+          }
+    }
+  else
+    {
+      const size_t end = str.find_first_of ("[,)");
+      const std::string_view name = str.substr (0, end);
+      if (!ParseElementary (name, out.kind, out.size))
+        return false;
+      str.remove_prefix (name.size ());
+    }
+
+  if (!out.ComputeLayout ())
+    return false;
+
+  /* Apply any array suffixes.  Each wraps the type parsed so far.  */
+  while (!str.empty () && str[0] == '[')
+    {
+      str.remove_prefix (1);
+
+      AbiType arr;
+      if (!str.empty () && str[0] == ']')
+        arr.kind = Kind::ARRAY;
+      else
+        {
+          arr.kind = Kind::FIXED_ARRAY;
+          if (!ParseNumber (str, arr.size) || arr.size == 0)
+            return false;
+        }
+
+      if (str.empty () || str[0] != ']')
+        return false;
+      str.remove_prefix (1);
+
+      arr.components.push_back (std::move (out));
+      if (!arr.ComputeLayout ())
+        return false;
+      out = std::move (arr);
+    }
+
+  return true;
+}
+
+bool
+AbiType::Parse (std::string_view str, AbiType& out)
+{
+  return ParseInternal (str, out) && str.empty ();
+}
+
+const AbiType&
+AbiType::GetElement () const
+{
+  CHECK (kind == Kind::ARRAY || kind == Kind::FIXED_ARRAY)
+      << "Type is not an array: " << ToString ();
+  return components[0];
+}
+
+std::string
+AbiType::ToString () const
+{
+  switch (kind)
+    {
+    case Kind::UINT:
+      return "uint" + std::to_string (size);
+    case Kind::INT:
+      return "int" + std::to_string (size);
+    case Kind::ADDRESS:
+      return "address";
+    case Kind::BOOL:
+      return "bool";
+    case Kind::FIXED_BYTES:
+      return "bytes" + std::to_string (size);
+    case Kind::BYTES:
+      return "bytes";
+    case Kind::STRING:
+      return "string";
+    case Kind::FIXED_ARRAY:
+      return components[0].ToString () + "[" + std::to_string (size) + "]";
+    case Kind::ARRAY:
+      return components[0].ToString () + "[]";
+    case Kind::TUPLE:
+      {
+        std::string res = "(";
+        for (size_t i = 0; i < components.size (); ++i)
+          {
+            if (i > 0)
+              res += ',';
+            res += components[i].ToString ();
+          }
+        return res + ")";
+      }
+    }
+
+  LOG (FATAL) << "Unexpected type kind: " << static_cast<int> (kind);
+  return "";
+}
+
+} // namespace ethutils
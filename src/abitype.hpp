@@ -0,0 +1,152 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ETHUTILS_ABITYPE_HPP
+#define ETHUTILS_ABITYPE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ethutils
+{
+
+/**
+ * A Solidity ABI type, as parsed from a type string such as "uint256",
+ * "bytes32[]" or "(string,(uint64,bool)[])".  The layout properties that
+ * the encoding depends on (whether the type is dynamic and its static size)
+ * are computed once when parsing.
+ */
+class AbiType
+{
+
+public:
+
+  /** The different kinds of types.  */
+  enum class Kind
+  {
+    UINT,
+    INT,
+    ADDRESS,
+    BOOL,
+    /** bytesN with 1 <= N <= 32.  */
+    FIXED_BYTES,
+    BYTES,
+    STRING,
+    /** T[k] with a fixed length k.  */
+    FIXED_ARRAY,
+    /** T[] with dynamic length.  */
+    ARRAY,
+    TUPLE,
+  };
+
+private:
+
+  Kind kind = Kind::TUPLE;
+
+  /**
+   * The size parameter of the type.  This is the number of bits for
+   * integers, the number of bytes for bytesN, and the length of fixed arrays.
+   */
+  size_t size = 0;
+
+  /**
+   * The components of a tuple, or the single element type of an array.
+   */
+  std::vector<AbiType> components;
+
+  /** Whether or not the type is dynamic in the ABI sense.  */
+  bool dynamic = false;
+
+  /** For static types, the size of their encoding in bytes.  */
+  size_t staticSize = 0;
+
+  /**
+   * Parses a type from the start of str, and advances str past it.
+   */
+  static bool ParseInternal (std::string_view& str, AbiType& out);
+
+  /**
+   * Computes dynamic and staticSize from the other fields.  Returns false
+   * if the static size is too large.
+   */
+  bool ComputeLayout ();
+
+public:
+
+  /**
+   * Constructs the empty tuple type "()".
+   */
+  AbiType () = default;
+
+  AbiType (const AbiType&) = default;
+  AbiType (AbiType&&) = default;
+  AbiType& operator= (const AbiType&) = default;
+  AbiType& operator= (AbiType&&) = default;
+
+  /**
+   * Parses a type string in canonical form (without spaces and parameter
+   * names).  "uint" and "int" are accepted as aliases for their 256-bit
+   * versions.  Returns false if the string is not a valid type.
+   */
+  static bool Parse (std::string_view str, AbiType& out);
+
+  Kind
+  GetKind () const
+  {
+    return kind;
+  }
+
+  /**
+   * Returns the bit size for integers, byte size for bytesN and the length
+   * for fixed arrays.
+   */
+  size_t
+  GetSize () const
+  {
+    return size;
+  }
+
+  /**
+   * Returns the components of a tuple type.
+   */
+  const std::vector<AbiType>&
+  GetComponents () const
+  {
+    return components;
+  }
+
+  /**
+   * Returns the element type of an array type.
+   */
+  const AbiType& GetElement () const;
+
+  bool
+  IsDynamic () const
+  {
+    return dynamic;
+  }
+
+  /**
+   * Returns the number of bytes a value of this type takes up in the head
+   * part of an enclosing tuple or array.  This is 32 for dynamic types
+   * (the offset pointer) and the full encoding size for static ones.
+   */
+  size_t
+  GetHeadSize () const
+  {
+    return dynamic ? 32 : staticSize;
+  }
+
+  /**
+   * Returns the canonical type string, e.g. "(uint256,bytes32[])".
+   */
+  std::string ToString () const;
+
+};
+
+} // namespace ethutils
+
+#endif // ETHUTILS_ABITYPE_HPP
@@ -0,0 +1,107 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "abitype.hpp"
+
+#include <gtest/gtest.h>
+
+namespace ethutils
+{
+namespace
+{
+
+using AbiTypeTests = testing::Test;
+
+TEST_F (AbiTypeTests, Elementary)
+{
+  AbiType t;
+
+  ASSERT_TRUE (AbiType::Parse ("uint64", t));
+  EXPECT_EQ (t.GetKind (), AbiType::Kind::UINT);
+  EXPECT_EQ (t.GetSize (), 64);
+  EXPECT_FALSE (t.IsDynamic ());
+  EXPECT_EQ (t.GetHeadSize (), 32);
+
+  ASSERT_TRUE (AbiType::Parse ("uint", t));
+  EXPECT_EQ (t.ToString (), "uint256");
+  ASSERT_TRUE (AbiType::Parse ("int", t));
+  EXPECT_EQ (t.ToString (), "int256");
+
+  ASSERT_TRUE (AbiType::Parse ("bytes7", t));
+  EXPECT_EQ (t.GetKind (), AbiType::Kind::FIXED_BYTES);
+  EXPECT_EQ (t.GetSize (), 7);
+
+  ASSERT_TRUE (AbiType::Parse ("bytes", t));
+  EXPECT_EQ (t.GetKind (), AbiType::Kind::BYTES);
+  EXPECT_TRUE (t.IsDynamic ());
+
+  ASSERT_TRUE (AbiType::Parse ("string", t));
+  EXPECT_TRUE (t.IsDynamic ());
+  EXPECT_EQ (t.GetHeadSize (), 32);
+
+  for (const std::string str : {"address", "bool", "int8", "uint256",
+                                "bytes32"})
+    {
+      ASSERT_TRUE (AbiType::Parse (str, t)) << str;
+      EXPECT_EQ (t.ToString (), str);
+    }
+}
+
+TEST_F (AbiTypeTests, Composite)
+{
+  AbiType t;
+
+  ASSERT_TRUE (AbiType::Parse ("uint8[3]", t));
+  EXPECT_EQ (t.GetKind (), AbiType::Kind::FIXED_ARRAY);
+  EXPECT_EQ (t.GetSize (), 3);
+  EXPECT_EQ (t.GetElement ().GetKind (), AbiType::Kind::UINT);
+  EXPECT_FALSE (t.IsDynamic ());
+  EXPECT_EQ (t.GetHeadSize (), 3 * 32);
+
+  ASSERT_TRUE (AbiType::Parse ("bytes32[][2]", t));
+  EXPECT_EQ (t.GetKind (), AbiType::Kind::FIXED_ARRAY);
+  EXPECT_EQ (t.GetElement ().GetKind (), AbiType::Kind::ARRAY);
+  EXPECT_TRUE (t.IsDynamic ());
+
+  ASSERT_TRUE (AbiType::Parse ("(uint64,bool)[2][]", t));
+  EXPECT_EQ (t.GetKind (), AbiType::Kind::ARRAY);
+  EXPECT_EQ (t.GetElement ().GetHeadSize (), 4 * 32);
+
+  ASSERT_TRUE (AbiType::Parse ("(uint64,(bool,address),bytes3[2])", t));
+  EXPECT_EQ (t.GetKind (), AbiType::Kind::TUPLE);
+  EXPECT_EQ (t.GetComponents ().size (), 3);
+  EXPECT_FALSE (t.IsDynamic ());
+  EXPECT_EQ (t.GetHeadSize (), 5 * 32);
+
+  ASSERT_TRUE (AbiType::Parse ("(uint64,string)", t));
+  EXPECT_TRUE (t.IsDynamic ());
+  EXPECT_EQ (t.GetHeadSize (), 32);
+
+  ASSERT_TRUE (AbiType::Parse ("()", t));
+  EXPECT_TRUE (t.GetComponents ().empty ());
+  EXPECT_FALSE (t.IsDynamic ());
+  EXPECT_EQ (t.GetHeadSize (), 0);
+
+  const std::string full
+      = "(string,string,uint256,address,bytes32[],(uint64,bool)[])";
+  ASSERT_TRUE (AbiType::Parse (full, t));
+  EXPECT_EQ (t.ToString (), full);
+}
+
+TEST_F (AbiTypeTests, Invalid)
+{
+  AbiType t;
+  for (const std::string str : {"", "foo", "uint7", "uint264", "uint0",
+                                "uint08", "bytes0", "bytes33",
+                                "uint256[", "uint256]", "uint256[0]",
+                                "uint256[01]", "uint256[x]", "(", ")",
+                                "(uint256", "(uint256,)", "(,uint256)",
+                                "(uint256))", "uint256 ", " uint256",
+                                "(uint256, bool)", "address[2]x",
+                                "uint8[1000000000][1000000000]"})
+    EXPECT_FALSE (AbiType::Parse (str, t)) << str;
+}
+
+} // anonymous namespace
+} // namespace ethutils
@@ -1,4 +1,4 @@
-// Copyright (C) 2021 The Xaya developers
+// Copyright (C) 2021-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -9,6 +9,8 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+
 namespace ethutils
 {
 
@@ -48,7 +50,7 @@ Address::Address (const std::string& addr)
       LOG (WARNING) << "Address is not valid hex: " << addr;
       return;
     }
-  if (bytes.size () != 20)
+  if (bytes.size () != BINARY_SIZE)
     {
       LOG (WARNING) << "Address has invalid size: " << addr;
       return;
@@ -81,6 +83,7 @@ Address::Address (const std::string& addr)
     }
 
   address = res;
+  std::copy (bytes.begin (), bytes.end (), binary.begin ());
 }
 
 const std::string&
@@ -96,6 +99,32 @@ Address::GetLowerCase () const
   return ToLower (GetChecksummed ());
 }
 
+const Address::Binary&
+Address::GetBinary () const
+{
+  CHECK (*this) << "Address is not valid";
+  return binary;
+}
+
+void
+Address::FormatChecksummed (const Binary& bin, char* out)
+{
+  Hexlify (bin.data (), bin.size (), out);
+
+  unsigned char hash[32];
+  Keccak256 (reinterpret_cast<const unsigned char*> (out), 2 * bin.size (),
+             hash);
+
+  for (size_t i = 0; i < 2 * bin.size (); ++i)
+    {
+      uint8_t byte = hash[i / 2];
+      if (i % 2 == 0)
+        byte >>= 4;
+      if (byte & 0x8)
+        out[i] = std::toupper (out[i]);
+    }
+}
+
 bool
 operator== (const Address& a, const Address& b)
 {
@@ -1,10 +1,12 @@
-// Copyright (C) 2021 The Xaya developers
+// Copyright (C) 2021-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #ifndef ETHUTILS_ADDRESS_HPP
 #define ETHUTILS_ADDRESS_HPP
 
+#include <array>
+#include <cstddef>
 #include <ostream>
 #include <string>
 
@@ -17,11 +19,22 @@ namespace ethutils
 class Address
 {
 
+public:
+
+  /** Size of an address in raw binary form.  */
+  static constexpr size_t BINARY_SIZE = 20;
+
+  /** Type for the raw binary form of an address.  */
+  using Binary = std::array<unsigned char, BINARY_SIZE>;
+
 private:
 
   /** The address in checksum format.  Empty string if it is invalid.  */
   std::string address;
 
+  /** The raw 20 bytes of the address (if it is valid).  */
+  Binary binary = {};
+
 public:
 
   /**
@@ -62,6 +75,18 @@ public:
    */
   std::string GetLowerCase () const;
 
+  /**
+   * Returns the raw 20 bytes of the address.  The address must be valid.
+   */
+  const Binary& GetBinary () const;
+
+  /**
+   * Writes the checksummed hex form of a raw address (without 0x prefix,
+   * i.e. 40 characters) to out.  This does not allocate, and can be used
+   * to check a given address string against a raw address cheaply.
+   */
+  static void FormatChecksummed (const Binary& bin, char* out);
+
   /**
    * Compares two addresses for equality.  An invalid address compares inequal
    * to any other (including other invalid's).
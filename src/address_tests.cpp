@@ -1,4 +1,4 @@
-// Copyright (C) 2021 The Xaya developers
+// Copyright (C) 2021-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -52,6 +52,34 @@ TEST_F (AddressTests, ReturnInChosenFormat)
              "0x5aAeb6053F3E94C9b9A09f33669435E7Ef1BeAed");
 }
 
+TEST_F (AddressTests, Binary)
+{
+  const Address addr("0x5aAeb6053F3E94C9b9A09f33669435E7Ef1BeAed");
+  ASSERT_TRUE (addr);
+
+  const auto& bin = addr.GetBinary ();
+  ASSERT_EQ (bin.size (), 20);
+  EXPECT_EQ (bin[0], 0x5a);
+  EXPECT_EQ (bin[1], 0xae);
+  EXPECT_EQ (bin[19], 0xed);
+
+  EXPECT_DEATH (Address ().GetBinary (), "not valid");
+}
+
+TEST_F (AddressTests, FormatChecksummed)
+{
+  for (const std::string str : {"0x5aAeb6053F3E94C9b9A09f33669435E7Ef1BeAed",
+                                "0xfB6916095ca1df60bB79Ce92cE3Ea74c37c5d359"})
+    {
+      const Address addr(str);
+      ASSERT_TRUE (addr);
+
+      char out[40];
+      Address::FormatChecksummed (addr.GetBinary (), out);
+      EXPECT_EQ ("0x" + std::string (out, sizeof (out)), str);
+    }
+}
+
 TEST_F (AddressTests, Roundtrip)
 {
   const Address addr("0x5aaeb6053f3e94c9b9a09f33669435e7ef1beaed");
@@ -0,0 +1,183 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "asyncverifier.hpp"
+
+#include "parallel.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <memory>
+
+namespace ethutils
+{
+
+namespace
+{
+
+/**
+ * Returns the given percentile (between 0 and 1) of the samples.  The vector
+ * is partially reordered in the process.
+ */
+double
+Percentile (std::vector<double>& samples, const double p)
+{
+  if (samples.empty ())
+    return 0.0;
+
+  const size_t idx = static_cast<size_t> (p * (samples.size () - 1));
+  std::nth_element (samples.begin (), samples.begin () + idx, samples.end ());
+  return samples[idx];
+}
+
+} // anonymous namespace
+
+AsyncVerifier::AsyncVerifier (const ECDSA& e, const Options& o)
+  : ec(e), opt(o)
+{
+  CHECK_GT (opt.maxQueue, 0) << "Queue size must be positive";
+  CHECK_GT (opt.batchSize, 0) << "Batch size must be positive";
+
+  latencies.reserve (LATENCY_SAMPLES);
+
+  const unsigned numWorkers = NumThreads (opt.workers);
+  workers.reserve (numWorkers);
+  for (unsigned i = 0; i < numWorkers; ++i)
+    workers.emplace_back (&AsyncVerifier::RunWorker, this);
+}
+
+AsyncVerifier::~AsyncVerifier ()
+{
+  {
+    std::lock_guard<std::mutex> lock(mut);
+    stop = true;
+  }
+  cvQueue.notify_all ();
+
+  for (auto& w : workers)
+    w.join ();
+}
+
+void
+AsyncVerifier::RunWorker ()
+{
+  std::vector<Request> batch;
+  std::vector<Address> results;
+  std::vector<double> batchLatencies;
+  batch.reserve (opt.batchSize);
+  results.reserve (opt.batchSize);
+  batchLatencies.reserve (opt.batchSize);
+
+  while (true)
+    {
+      batch.clear ();
+      {
+        std::unique_lock<std::mutex> lock(mut);
+        cvQueue.wait (lock, [this] () { return stop || !queue.empty (); });
+
+        /* When stopping, we still process all remaining requests and only
+           exit once the queue is empty.  */
+        if (queue.empty ())
+          return;
+
+        while (!queue.empty () && batch.size () < opt.batchSize)
+          {
+            batch.push_back (std::move (queue.front ()));
+            queue.pop_front ();
+          }
+      }
+
+      results.clear ();
+      batchLatencies.clear ();
+      for (const auto& r : batch)
+        {
+          results.push_back (ec.VerifyMessage (r.msg, r.sgnHex, opt.allowCompact));
+
+          using Micro = std::chrono::duration<double, std::micro>;
+          const auto d = Clock::now () - r.submitted;
+          batchLatencies.push_back (
+              std::chrono::duration_cast<Micro> (d).count ());
+        }
+
+      /* Update the statistics before invoking the callbacks, so that they
+         are already consistent once a caller sees the result.  */
+      {
+        std::lock_guard<std::mutex> lock(mut);
+        for (const double l : batchLatencies)
+          {
+            if (latencies.size () < LATENCY_SAMPLES)
+              latencies.push_back (l);
+            else
+              latencies[completed % LATENCY_SAMPLES] = l;
+            ++completed;
+          }
+      }
+
+      for (size_t i = 0; i < batch.size (); ++i)
+        batch[i].cb (results[i]);
+    }
+}
+
+bool
+AsyncVerifier::Submit (const std::string& msg, const std::string& sgnHex,
+                       Callback cb)
+{
+  {
+    std::lock_guard<std::mutex> lock(mut);
+    CHECK (!stop) << "AsyncVerifier is shutting down";
+
+    if (queue.size () >= opt.maxQueue)
+      {
+        ++rejected;
+        return false;
+      }
+
+    queue.push_back ({msg, sgnHex, std::move (cb), Clock::now ()});
+    ++accepted;
+  }
+
+  cvQueue.notify_one ();
+  return true;
+}
+
+std::future<Address>
+AsyncVerifier::Submit (const std::string& msg, const std::string& sgnHex)
+{
+  auto promise = std::make_shared<std::promise<Address>> ();
+  auto res = promise->get_future ();
+
+  const auto cb = [promise] (const Address& signer)
+    {
+      promise->set_value (signer);
+    };
+  if (!Submit (msg, sgnHex, cb))
+    return std::future<Address> ();
+
+  return res;
+}
+
+AsyncVerifier::Stats
+AsyncVerifier::GetStats () const
+{
+  Stats res;
+  std::vector<double> samples;
+
+  {
+    std::lock_guard<std::mutex> lock(mut);
+    res.queueDepth = queue.size ();
+    res.accepted = accepted;
+    res.rejected = rejected;
+    res.completed = completed;
+    samples = latencies;
+  }
+
+  res.latencyP50 = Percentile (samples, 0.5);
+  res.latencyP90 = Percentile (samples, 0.9);
+  res.latencyP99 = Percentile (samples, 0.99);
+
+  return res;
+}
+
+} // namespace ethutils
@@ -0,0 +1,191 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ETHUTILS_ASYNCVERIFIER_HPP
+#define ETHUTILS_ASYNCVERIFIER_HPP
+
+#include "address.hpp"
+#include "ecdsa.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ethutils
+{
+
+/**
+ * Service that verifies message signatures (like ECDSA::VerifyMessage)
+ * asynchronously on a fixed pool of worker threads.  Submissions go into
+ * a bounded queue.  When the queue is full, they are rejected right
+ * away instead of buffering without limit.  This lets callers apply
+ * back-pressure.
+ *
+ * Workers take small batches of requests from the queue at once.  Results
+ * are delivered either through a callback (invoked on the worker thread)
+ * or a future.
+ */
+class AsyncVerifier
+{
+
+public:
+
+  /** Callback invoked with the recovered signer (or an invalid address).  */
+  using Callback = std::function<void (const Address& signer)>;
+
+  /**
+   * Configuration options for the service.
+   */
+  struct Options
+  {
+
+    /** Maximum number of requests waiting in the queue.  */
+    size_t maxQueue = 1'024;
+
+    /** Number of worker threads.  Zero means the hardware concurrency.  */
+    unsigned workers = 0;
+
+    /** Maximum number of requests a worker takes from the queue at once.  */
+    size_t batchSize = 16;
+
+    /** Whether or not EIP-2098 compact signatures are accepted.  */
+    bool allowCompact = false;
+
+  };
+
+  /**
+   * Statistics about the service.
+   */
+  struct Stats
+  {
+
+    /** Number of requests currently waiting in the queue.  */
+    size_t queueDepth = 0;
+
+    /** Number of requests accepted into the queue so far.  */
+    uint64_t accepted = 0;
+
+    /** Number of requests rejected so far because the queue was full.  */
+    uint64_t rejected = 0;
+
+    /** Number of requests completed so far.  */
+    uint64_t completed = 0;
+
+    /**
+     * Percentiles of the latency (from submission until the verification
+     * is done, not including the callback) over the most recently
+     * completed requests, in microseconds.  They are zero
+     * if no request has been completed yet.
+     */
+    double latencyP50 = 0.0;
+    double latencyP90 = 0.0;
+    double latencyP99 = 0.0;
+
+  };
+
+private:
+
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * A single request in the queue.
+   */
+  struct Request
+  {
+    std::string msg;
+    std::string sgnHex;
+    Callback cb;
+    Clock::time_point submitted;
+  };
+
+  /** Number of recent latency samples kept for the percentiles.  */
+  static constexpr size_t LATENCY_SAMPLES = 1'024;
+
+  /** The ECDSA instance used for verification.  */
+  const ECDSA& ec;
+
+  /** The options used.  */
+  const Options opt;
+
+  /** Lock for the queue and statistics.  */
+  mutable std::mutex mut;
+
+  /** Condition variable notified when requests are added or we stop.  */
+  std::condition_variable cvQueue;
+
+  /** The queue of pending requests.  */
+  std::deque<Request> queue;
+
+  /** Set to true when the service is shutting down.  */
+  bool stop = false;
+
+  /** Counters for the statistics.  */
+  uint64_t accepted = 0;
+  uint64_t rejected = 0;
+  uint64_t completed = 0;
+
+  /**
+   * Ring buffer of recent latencies (in microseconds).  The next sample
+   * will be written at index completed % LATENCY_SAMPLES.
+   */
+  std::vector<double> latencies;
+
+  /** The worker threads.  */
+  std::vector<std::thread> workers;
+
+  /**
+   * Main loop of each worker thread.
+   */
+  void RunWorker ();
+
+public:
+
+  explicit AsyncVerifier (const ECDSA& e)
+    : AsyncVerifier(e, Options ())
+  {}
+
+  explicit AsyncVerifier (const ECDSA& e, const Options& o);
+
+  /**
+   * Stops the service.  Requests still in the queue are processed
+   * before the workers are joined.
+   */
+  ~AsyncVerifier ();
+
+  AsyncVerifier (const AsyncVerifier&) = delete;
+  void operator= (const AsyncVerifier&) = delete;
+
+  /**
+   * Submits a request to verify the given message and signature (as
+   * 0x-prefixed hex string).  The callback is invoked on a worker thread with
+   * the result.  Returns false (and does not invoke the callback) if the
+   * request is rejected because the queue is full.
+   */
+  bool Submit (const std::string& msg, const std::string& sgnHex, Callback cb);
+
+  /**
+   * Submits a request and returns a future for the result.  If the request
+   * is rejected, the returned future is not valid.
+   */
+  std::future<Address> Submit (const std::string& msg,
+                               const std::string& sgnHex);
+
+  /**
+   * Returns the current statistics.
+   */
+  Stats GetStats () const;
+
+};
+
+} // namespace ethutils
+
+#endif // ETHUTILS_ASYNCVERIFIER_HPP
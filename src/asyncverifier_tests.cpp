@@ -0,0 +1,155 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "asyncverifier.hpp"
+
+#include "hexutils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <vector>
+
+namespace ethutils
+{
+namespace
+{
+
+class AsyncVerifierTests : public testing::Test
+{
+
+protected:
+
+  ECDSA ec;
+  ECDSA::Key key;
+
+  AsyncVerifierTests ()
+  {
+    key = ec.SecretKey ("0x"
+        "918fb30e03abd86ddbfcffb1ec3ea86607d56f307e2ffac71ffb41cbc813d093");
+  }
+
+};
+
+TEST_F (AsyncVerifierTests, Futures)
+{
+  AsyncVerifier verifier(ec);
+
+  std::vector<std::future<Address>> results;
+  for (unsigned i = 0; i < 100; ++i)
+    {
+      const std::string msg = "message " + std::to_string (i);
+      const std::string sgn = ec.SignMessage (msg, key);
+      results.push_back (verifier.Submit (msg, i % 2 == 0 ? sgn : "0x1234"));
+      ASSERT_TRUE (results.back ().valid ());
+    }
+
+  for (unsigned i = 0; i < results.size (); ++i)
+    {
+      const Address signer = results[i].get ();
+      if (i % 2 == 0)
+        EXPECT_EQ (signer, key.GetAddress ());
+      else
+        EXPECT_FALSE (signer);
+    }
+
+  const auto stats = verifier.GetStats ();
+  EXPECT_EQ (stats.accepted, 100);
+  EXPECT_EQ (stats.completed, 100);
+  EXPECT_EQ (stats.rejected, 0);
+  EXPECT_EQ (stats.queueDepth, 0);
+  EXPECT_GT (stats.latencyP50, 0.0);
+  EXPECT_LE (stats.latencyP50, stats.latencyP90);
+  EXPECT_LE (stats.latencyP90, stats.latencyP99);
+}
+
+TEST_F (AsyncVerifierTests, CallbacksAndShutdown)
+{
+  std::atomic<unsigned> valid(0);
+  {
+    AsyncVerifier::Options opt;
+    opt.workers = 3;
+    opt.batchSize = 4;
+    AsyncVerifier verifier(ec, opt);
+
+    const std::string sgn = ec.SignMessage ("foo", key);
+    for (unsigned i = 0; i < 50; ++i)
+      ASSERT_TRUE (verifier.Submit ("foo", sgn, [&] (const Address& signer)
+        {
+          if (signer == key.GetAddress ())
+            ++valid;
+        }));
+  }
+
+  /* The destructor processes all pending requests.  */
+  EXPECT_EQ (valid, 50);
+}
+
+TEST_F (AsyncVerifierTests, BackPressure)
+{
+  AsyncVerifier::Options opt;
+  opt.workers = 1;
+  opt.batchSize = 1;
+  opt.maxQueue = 2;
+  AsyncVerifier verifier(ec, opt);
+
+  const std::string sgn = ec.SignMessage ("foo", key);
+
+  /* Block the single worker in a callback, so that further requests
+     stay in the queue.  */
+  std::promise<void> started;
+  std::promise<void> release;
+  auto releaseFuture = release.get_future ().share ();
+  ASSERT_TRUE (verifier.Submit ("foo", sgn, [&] (const Address&)
+    {
+      started.set_value ();
+      releaseFuture.wait ();
+    }));
+  started.get_future ().wait ();
+
+  auto f1 = verifier.Submit ("foo", sgn);
+  auto f2 = verifier.Submit ("foo", sgn);
+  auto f3 = verifier.Submit ("foo", sgn);
+  EXPECT_TRUE (f1.valid ());
+  EXPECT_TRUE (f2.valid ());
+  EXPECT_FALSE (f3.valid ());
+  EXPECT_FALSE (verifier.Submit ("foo", sgn, [] (const Address&) {}));
+
+  auto stats = verifier.GetStats ();
+  EXPECT_EQ (stats.queueDepth, 2);
+  EXPECT_EQ (stats.accepted, 3);
+  EXPECT_EQ (stats.rejected, 2);
+
+  release.set_value ();
+  EXPECT_EQ (f1.get (), key.GetAddress ());
+  EXPECT_EQ (f2.get (), key.GetAddress ());
+
+  stats = verifier.GetStats ();
+  EXPECT_EQ (stats.queueDepth, 0);
+  EXPECT_EQ (stats.completed, 3);
+}
+
+TEST_F (AsyncVerifierTests, CompactSignatures)
+{
+  const std::string sgnHex = ec.SignMessage ("foo", key);
+  std::string sgn;
+  ASSERT_TRUE (Unhexlify (sgnHex.substr (2), sgn));
+  const std::string compact
+      = "0x" + Hexlify (ECDSA::CompactSignature (sgn));
+  ASSERT_EQ (compact.size (), 2 + 2 * 64);
+
+  AsyncVerifier strict(ec);
+  EXPECT_FALSE (strict.Submit ("foo", compact).get ());
+  EXPECT_EQ (strict.Submit ("foo", sgnHex).get (), key.GetAddress ());
+
+  AsyncVerifier::Options opt;
+  opt.allowCompact = true;
+  AsyncVerifier verifier(ec, opt);
+  EXPECT_EQ (verifier.Submit ("foo", compact).get (), key.GetAddress ());
+  EXPECT_EQ (verifier.Submit ("foo", sgnHex).get (), key.GetAddress ());
+}
+
+} // anonymous namespace
+} // namespace ethutils
@@ -0,0 +1,232 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bip32.hpp"
+
+#include "parallel.hpp"
+#include "sha512.hpp"
+
+#include <secp256k1.h>
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <sstream>
+
+namespace ethutils
+{
+
+namespace
+{
+
+/** The HMAC key used for deriving the master node from the seed.  */
+constexpr char MASTER_KEY[] = "Bitcoin seed";
+
+} // anonymous namespace
+
+Bip32Deriver::Bip32Deriver (const ECDSA& e, const std::string& seed)
+  : ec(e)
+{
+  CHECK (ec.CanSign ())
+      << "Cannot use secret keys with a verify-only ECDSA instance";
+  CHECK (seed.size () >= 16 && seed.size () <= 64)
+      << "Seed must be between 16 and 64 bytes";
+
+  unsigned char hmac[64];
+  HmacSha512 (reinterpret_cast<const unsigned char*> (MASTER_KEY),
+              sizeof (MASTER_KEY) - 1,
+              reinterpret_cast<const unsigned char*> (seed.data ()),
+              seed.size (), hmac);
+
+  Node master;
+  std::copy (hmac, hmac + 32, master.secret.begin ());
+  std::copy (hmac + 32, hmac + 64, master.chainCode.begin ());
+  master.valid = secp256k1_ec_seckey_verify (secp256k1_context_static,
+                                             master.secret.data ());
+  CHECK (master.valid) << "Seed yields an invalid master key";
+  ComputePubkey (master);
+
+  cache.emplace (Path (), master);
+}
+
+void
+Bip32Deriver::ComputePubkey (Node& node) const
+{
+  CHECK (node.valid);
+
+  const std::string secret(node.secret.begin (), node.secret.end ());
+  const auto key = ec.SecretKey (secret);
+  const auto& full = key.GetPublicKey ();
+
+  node.pubkey[0] = (full[64] & 1) ? 0x03 : 0x02;
+  std::copy (full.begin () + 1, full.begin () + 33, node.pubkey.begin () + 1);
+}
+
+Bip32Deriver::Node
+Bip32Deriver::DeriveChild (const Node& parent, const uint32_t index)
+{
+  Node res;
+  if (!parent.valid)
+    return res;
+
+  /* The HMAC data is either the secret key (with a zero byte before) for
+     hardened children, or the compressed public key.  Both are 33 bytes,
+     and followed by the index.  */
+  unsigned char data[37];
+  if (index & HARDENED)
+    {
+      data[0] = 0x00;
+      std::copy (parent.secret.begin (), parent.secret.end (), data + 1);
+    }
+  else
+    std::copy (parent.pubkey.begin (), parent.pubkey.end (), data);
+  for (size_t b = 0; b < 4; ++b)
+    data[33 + b] = (index >> (24 - 8 * b)) & 0xFF;
+
+  unsigned char hmac[64];
+  HmacSha512 (parent.chainCode.data (), parent.chainCode.size (),
+              data, sizeof (data), hmac);
+
+  /* The tweak fails exactly when BIP-32 says that the child is invalid:
+     if the left half is not below the curve order, or if the resulting
+     key is zero.  It does not need any precomputed tables, so the static
+     context is enough.  */
+  res.secret = parent.secret;
+  res.valid = secp256k1_ec_seckey_tweak_add (secp256k1_context_static,
+                                             res.secret.data (), hmac);
+  std::copy (hmac + 32, hmac + 64, res.chainCode.begin ());
+
+  return res;
+}
+
+const Bip32Deriver::Node&
+Bip32Deriver::GetNode (const Path& path) const
+{
+  const auto mit = cache.find (path);
+  if (mit != cache.end ())
+    return mit->second;
+
+  const Path parentPath(path.begin (), path.end () - 1);
+  Node node = DeriveChild (GetNode (parentPath), path.back ());
+  if (node.valid)
+    ComputePubkey (node);
+
+  return cache.emplace (path, node).first->second;
+}
+
+bool
+Bip32Deriver::ParsePath (const std::string& str, Path& path)
+{
+  path.clear ();
+
+  std::istringstream in(str);
+  std::string part;
+  if (!std::getline (in, part, '/') || part != "m")
+    return false;
+
+  while (std::getline (in, part, '/'))
+    {
+      uint32_t offset = 0;
+      if (!part.empty ()
+            && (part.back () == '\'' || part.back () == 'h'
+                  || part.back () == 'H'))
+        {
+          offset = HARDENED;
+          part.pop_back ();
+        }
+
+      if (part.empty () || part.size () > 10
+            || !std::all_of (part.begin (), part.end (),
+                             [] (const char c) { return c >= '0' && c <= '9'; })
+            || (part.size () > 1 && part[0] == '0'))
+        return false;
+
+      const uint64_t index = std::stoull (part);
+      if (index >= HARDENED)
+        return false;
+
+      path.push_back (offset + static_cast<uint32_t> (index));
+    }
+
+  /* A trailing slash is not valid.  */
+  return str.empty () || str.back () != '/';
+}
+
+ECDSA::Key
+Bip32Deriver::Derive (const Path& path) const
+{
+  Node node;
+  if (path.empty ())
+    {
+      std::lock_guard<std::mutex> lock(mut);
+      node = GetNode (path);
+    }
+  else
+    {
+      Node parent;
+      {
+        std::lock_guard<std::mutex> lock(mut);
+        parent = GetNode (Path (path.begin (), path.end () - 1));
+      }
+      node = DeriveChild (parent, path.back ());
+    }
+
+  if (!node.valid)
+    {
+      LOG (WARNING) << "BIP-32 derivation yields an invalid key";
+      return ECDSA::Key ();
+    }
+
+  return ec.SecretKey (std::string (node.secret.begin (), node.secret.end ()));
+}
+
+ECDSA::Key
+Bip32Deriver::Derive (const std::string& path) const
+{
+  Path parsed;
+  if (!ParsePath (path, parsed))
+    {
+      LOG (WARNING) << "Invalid BIP-32 path: " << path;
+      return ECDSA::Key ();
+    }
+
+  return Derive (parsed);
+}
+
+std::vector<Address::Binary>
+Bip32Deriver::DeriveAddresses (const Path& parent, const uint32_t first,
+                               const size_t count,
+                               const unsigned threads) const
+{
+  if (count == 0)
+    return {};
+
+  const uint64_t last = static_cast<uint64_t> (first) + count - 1;
+  CHECK (last <= UINT32_MAX && ((first ^ last) & HARDENED) == 0)
+      << "Child index range must not cross the hardened boundary";
+
+  Node parentNode;
+  {
+    std::lock_guard<std::mutex> lock(mut);
+    parentNode = GetNode (parent);
+  }
+
+  /* Derive all child secrets first, and then compute the addresses
+     with the batched ECDSA::SecretsToAddresses.  Invalid children
+     get an empty string there, which yields a zero address.  */
+  std::vector<std::string> secrets(count);
+  ParallelFor (count, threads, [&] (const size_t begin, const size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+        {
+          const Node child = DeriveChild (parentNode, first + i);
+          if (child.valid)
+            secrets[i].assign (child.secret.begin (), child.secret.end ());
+        }
+    });
+
+  return ec.SecretsToAddresses (secrets, threads);
+}
+
+} // namespace ethutils
@@ -0,0 +1,142 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ETHUTILS_BIP32_HPP
+#define ETHUTILS_BIP32_HPP
+
+#include "address.hpp"
+#include "ecdsa.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ethutils
+{
+
+/**
+ * Hierarchical deterministic key derivation as per BIP-32, producing
+ * ECDSA keys from a master seed (e.g. for deposit addresses derived
+ * along m/44'/60'/0'/0/i).
+ *
+ * The nodes of all parent paths that are used are cached, so deriving many
+ * children of the same parent only costs one derivation step each.  The
+ * cache holds secret keys in memory for the lifetime of the instance.
+ * It is thread-safe.
+ */
+class Bip32Deriver
+{
+
+public:
+
+  /** Offset of hardened child indices.  */
+  static constexpr uint32_t HARDENED = 0x8000'0000;
+
+  /** A derivation path as sequence of child indices below the master.  */
+  using Path = std::vector<uint32_t>;
+
+private:
+
+  /**
+   * An extended private key in the derivation tree.
+   */
+  struct Node
+  {
+
+    /** The secret key.  */
+    std::array<unsigned char, 32> secret;
+
+    /** The chain code.  */
+    std::array<unsigned char, 32> chainCode;
+
+    /** The compressed public key, needed for non-hardened children.  */
+    std::array<unsigned char, 33> pubkey;
+
+    /**
+     * False if derivation of this node failed (which happens with
+     * negligible probability, but is defined by BIP-32).
+     */
+    bool valid = false;
+
+  };
+
+  /** The ECDSA instance used for computing public keys.  */
+  const ECDSA& ec;
+
+  /** Lock for the cache.  */
+  mutable std::mutex mut;
+
+  /** Cached nodes by their path.  The master node has the empty path.  */
+  mutable std::map<Path, Node> cache;
+
+  /**
+   * Fills in the public key of a node from its secret key.
+   */
+  void ComputePubkey (Node& node) const;
+
+  /**
+   * Returns the node for the given path, deriving and caching it (and
+   * all its ancestors) if necessary.  mut must be held.
+   */
+  const Node& GetNode (const Path& path) const;
+
+  /**
+   * Derives the child with the given index of a node.  Only the secret key
+   * and chain code are filled in, not the public key.
+   */
+  static Node DeriveChild (const Node& parent, uint32_t index);
+
+public:
+
+  /**
+   * Constructs the deriver for a master seed, which must be a binary string
+   * between 16 and 64 bytes long (e.g. a BIP-39 seed).  The ECDSA instance
+   * must support signing.
+   */
+  explicit Bip32Deriver (const ECDSA& e, const std::string& seed);
+
+  Bip32Deriver (const Bip32Deriver&) = delete;
+  void operator= (const Bip32Deriver&) = delete;
+
+  /**
+   * Parses a path in the usual notation, like "m/44'/60'/0'/0/5".  Hardened
+   * indices can be marked with ', h or H.  Returns false if the path
+   * is invalid.
+   */
+  static bool ParsePath (const std::string& str, Path& path);
+
+  /**
+   * Derives the key at the given path.  The parent nodes are cached, but the
+   * final node itself is not.  Returns an invalid key if derivation fails.
+   */
+  ECDSA::Key Derive (const Path& path) const;
+
+  /**
+   * Derives the key at the given path in string notation.  Returns an
+   * invalid key if the path is invalid.
+   */
+  ECDSA::Key Derive (const std::string& path) const;
+
+  /**
+   * Derives the addresses of the children first, first + 1, ...,
+   * first + count - 1 of the node at the given parent path.  The indices
+   * must either all be hardened or all be non-hardened.
+   *
+   * The work is split across up to the given number of threads (zero means
+   * to use the hardware concurrency).  The returned addresses are in order of
+   * the child index, and all zeros for children whose derivation fails.
+   */
+  std::vector<Address::Binary> DeriveAddresses (const Path& parent,
+                                                uint32_t first, size_t count,
+                                                unsigned threads = 0) const;
+
+};
+
+} // namespace ethutils
+
+#endif // ETHUTILS_BIP32_HPP
@@ -0,0 +1,152 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bip32.hpp"
+
+#include "hexutils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <glog/logging.h>
+
+namespace ethutils
+{
+namespace
+{
+
+using Path = Bip32Deriver::Path;
+constexpr uint32_t H = Bip32Deriver::HARDENED;
+
+class Bip32Tests : public testing::Test
+{
+
+protected:
+
+  ECDSA ec;
+
+  static std::string
+  Bin (const std::string& hex)
+  {
+    std::string res;
+    CHECK (Unhexlify (hex, res));
+    return res;
+  }
+
+  /**
+   * Expects that the given key matches the secret key given as hex.
+   */
+  void
+  ExpectKey (const ECDSA::Key& key, const std::string& secretHex) const
+  {
+    ASSERT_TRUE (key);
+    EXPECT_EQ (key.GetAddress (),
+               ec.SecretKey ("0x" + secretHex).GetAddress ());
+  }
+
+};
+
+TEST_F (Bip32Tests, TestVector1)
+{
+  const Bip32Deriver d(ec, Bin ("000102030405060708090a0b0c0d0e0f"));
+
+  ExpectKey (d.Derive (Path ()),
+      "e8f32e723decf4051aefac8e2c93c9c5b214313817cdb01a1494b917c8436b35");
+  ExpectKey (d.Derive (Path ({H})),
+      "edb2e14f9ee77d26dd93b4ecede8d16ed408ce149b6cd80b0715a2d911a0afea");
+  ExpectKey (d.Derive (Path ({H, 1})),
+      "3c6cb8d0f6a264c91ea8b5030fadaa8e538b020f0a387421a12de9319dc93368");
+  ExpectKey (d.Derive (Path ({H, 1, H + 2})),
+      "cbce0d719ecf7431d88e6a89fa1483e02e35092af60c042b1df2ff59fa424dca");
+  ExpectKey (d.Derive (Path ({H, 1, H + 2, 2})),
+      "0f479245fb19a38a1954c5c7c0ebab2f9bdfd96a17563ef28a6a4b1a2a764ef4");
+  ExpectKey (d.Derive ("m/0'/1/2'/2/1000000000"),
+      "471b76e389e528d6de6d816857e012c5455051cad6660850e58372a6c3e6e7c8");
+}
+
+TEST_F (Bip32Tests, TestVector2)
+{
+  const Bip32Deriver d(ec, Bin (
+      "fffcf9f6f3f0edeae7e4e1dedbd8d5d2cfccc9c6c3c0bdbab7b4b1aeaba8a5a2"
+      "9f9c999693908d8a8784817e7b7875726f6c696663605d5a5754514e4b484542"));
+
+  ExpectKey (d.Derive ("m"),
+      "4b03d6fc340455b363f51020ad3ecca4f0850280cf436c70c727923f6db46c3e");
+  ExpectKey (d.Derive ("m/0"),
+      "abe74a98f6c7eabee0428f53798f0ab8aa1bd37873999041703c742f15ac7e1e");
+  ExpectKey (d.Derive ("m/0/2147483647H"),
+      "877c779ad9687164e9c2f4f0f4ff0340814392330693ce95a58fe18fd52e6e93");
+  ExpectKey (d.Derive ("m/0/2147483647h/1"),
+      "704addf544a06e5ee4bea37098463c23613da32020d604506da8c0518e1da4b7");
+}
+
+TEST_F (Bip32Tests, EthereumPath)
+{
+  /* The BIP-39 seed of "abandon abandon ... about", whose first Ethereum
+     account is well known.  */
+  const Bip32Deriver d(ec, Bin (
+      "5eb00bbddcf069084889a8ab9155568165f5c453ccb85e70811aaed6f6da5fc1"
+      "9a5ac40b389cd370d086206dec8aa6c43daea6690f20ad3d8d48b2d2ce9e38e4"));
+
+  EXPECT_EQ (d.Derive ("m/44'/60'/0'/0/0").GetAddress (),
+             Address ("0x9858EfFD232B4033E47d90003D41EC34EcaEda94"));
+  ExpectKey (d.Derive ("m/44'/60'/0'/0/1"),
+      "9a983cb3d832fbde5ab49d692b7a8bf5b5d232479c99333d0fc8e1d21f1b55b6");
+}
+
+TEST_F (Bip32Tests, ParsePath)
+{
+  Path path;
+
+  ASSERT_TRUE (Bip32Deriver::ParsePath ("m", path));
+  EXPECT_TRUE (path.empty ());
+
+  ASSERT_TRUE (Bip32Deriver::ParsePath ("m/44'/60h/0H/0/2147483647", path));
+  EXPECT_EQ (path, Path ({H + 44, H + 60, H, 0, H - 1}));
+
+  for (const std::string invalid : {"", "M", "m/", "m//1", "1/2", "m/x",
+                                    "m/-1", "m/01", "m/2147483648", "m/1''",
+                                    "m/'", "m/99999999999", "m/1/"})
+    EXPECT_FALSE (Bip32Deriver::ParsePath (invalid, path)) << invalid;
+
+  const Bip32Deriver d(ec, std::string (16, 'x'));
+  EXPECT_FALSE (d.Derive ("m/foo"));
+}
+
+TEST_F (Bip32Tests, AddressRange)
+{
+  const Bip32Deriver d(ec, std::string (32, '\x42'));
+  const Path parent = {H + 44, H + 60, H, 0};
+
+  for (const uint32_t first : {0u, 1'000u, H + 5})
+    for (const unsigned threads : {1u, 3u, 0u})
+      {
+        const auto addresses = d.DeriveAddresses (parent, first, 10, threads);
+        ASSERT_EQ (addresses.size (), 10);
+        for (uint32_t i = 0; i < addresses.size (); ++i)
+          {
+            Path path = parent;
+            path.push_back (first + i);
+            EXPECT_EQ (addresses[i],
+                       d.Derive (path).GetAddress ().GetBinary ());
+          }
+      }
+
+  EXPECT_TRUE (d.DeriveAddresses (parent, 0, 0).empty ());
+  EXPECT_EQ (d.DeriveAddresses (parent, H - 1, 1).size (), 1);
+  EXPECT_DEATH (d.DeriveAddresses (parent, H - 1, 2), "hardened");
+  EXPECT_DEATH (d.DeriveAddresses (parent, UINT32_MAX, 2), "hardened");
+}
+
+TEST_F (Bip32Tests, InvalidSetup)
+{
+  EXPECT_DEATH (Bip32Deriver (ec, std::string (15, 'x')), "Seed");
+  EXPECT_DEATH (Bip32Deriver (ec, std::string (65, 'x')), "Seed");
+
+  const ECDSA verifier(ECDSA::ContextMode::VERIFY_ONLY);
+  EXPECT_DEATH (Bip32Deriver (verifier, std::string (16, 'x')),
+                "verify-only");
+}
+
+} // anonymous namespace
+} // namespace ethutils
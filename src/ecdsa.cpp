@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2022 The Xaya developers
+// Copyright (C) 2021-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -6,13 +6,15 @@
 
 #include "hexutils.hpp"
 #include "keccak.hpp"
+#include "parallel.hpp"
 
 #include <secp256k1.h>
 #include <secp256k1_recovery.h>
 
 #include <glog/logging.h>
 
-#include <sstream>
+#include <algorithm>
+#include <string>
 
 namespace ethutils
 {
@@ -22,6 +24,17 @@ namespace
 
 /* ************************************************************************** */
 
+/**
+ * Half the order of the secp256k1 curve.  Signatures with larger s values
+ * are invalid since EIP-2, and cannot be represented in EIP-2098 form.
+ */
+constexpr unsigned char HALF_ORDER[32] = {
+  0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0x5D, 0x57, 0x6E, 0x73, 0x57, 0xA4, 0x50, 0x1D,
+  0xDF, 0xE9, 0x2F, 0x46, 0x68, 0x1B, 0x20, 0xA0,
+};
+
 /**
  * Returns the bytes of a string as unsigned char (as used for libsecp256k1).
  */
@@ -41,40 +54,300 @@ UChar (std::string& str)
 }
 
 /**
- * Converts a secp256k1 pubkey into an address.
+ * Serialises a parsed pubkey to the 64-byte form (without 0x04 prefix)
+ * that is hashed for the address.
  */
-Address
-PubkeyToAddress (const secp256k1_context* ctx, const secp256k1_pubkey& pubkey)
+void
+SerialisePubkeyForAddress (const secp256k1_context* ctx,
+                           const secp256k1_pubkey& pubkey, unsigned char* out)
 {
-  std::string pubkeyBin(65, '\0');
-  size_t pubkeyBinLen = pubkeyBin.size ();
+  unsigned char pubkeyBin[65];
+  size_t pubkeyBinLen = sizeof (pubkeyBin);
   CHECK (secp256k1_ec_pubkey_serialize (
-            ctx, UChar (pubkeyBin), &pubkeyBinLen,
+            ctx, pubkeyBin, &pubkeyBinLen,
             &pubkey, SECP256K1_EC_UNCOMPRESSED))
       << "Serialising the pubkey failed";
   CHECK_EQ (pubkeyBinLen, 65) << "Unexpected serialised pubkey length returned";
-  CHECK_EQ (pubkeyBin[0], '\x04')
+  CHECK_EQ (pubkeyBin[0], 0x04)
       << "Unexpected first byte in serialised uncompressed pubkey";
+  std::copy (pubkeyBin + 1, pubkeyBin + 65, out);
+}
 
-  const std::string pubkeyHash = Keccak256 (pubkeyBin.substr (1));
-  CHECK_EQ (pubkeyHash.size (), 32);
-  return Address ("0x" + Hexlify (pubkeyHash.substr (12)));
+/**
+ * Converts a secp256k1 pubkey into the raw bytes of the corresponding
+ * address, without constructing a checksummed Address.
+ */
+void
+PubkeyToBinaryAddress (const secp256k1_context* ctx,
+                       const secp256k1_pubkey& pubkey, Address::Binary& out)
+{
+  unsigned char pubkeyBin[64];
+  SerialisePubkeyForAddress (ctx, pubkey, pubkeyBin);
+
+  unsigned char pubkeyHash[32];
+  Keccak256 (pubkeyBin, sizeof (pubkeyBin), pubkeyHash);
+  std::copy (pubkeyHash + 32 - out.size (), pubkeyHash + 32, out.begin ());
 }
 
 /**
- * Converts a message to the corresponding hash that is signed with ECDSA.
+ * Converts a secp256k1 pubkey into an address.
  */
-std::string
-MessageHash (const std::string& msg)
+Address
+PubkeyToAddress (const secp256k1_context* ctx, const secp256k1_pubkey& pubkey)
+{
+  Address::Binary bin;
+  PubkeyToBinaryAddress (ctx, pubkey, bin);
+
+  const std::string binStr(bin.begin (), bin.end ());
+  return Address ("0x" + Hexlify (binStr));
+}
+
+/**
+ * Computes the legacy message hash (see ECDSA::MessageHash) and writes
+ * it to out.  The prefix and message are hashed incrementally, without
+ * copying them together.
+ */
+void
+MessageHashRaw (const std::string_view msg, unsigned char* out)
 {
-  std::ostringstream msgToHash;
-  msgToHash << '\x19' << "Ethereum Signed Message:\n"
-            << msg.size () << msg;
+  constexpr std::string_view prefix = "\x19" "Ethereum Signed Message:\n";
 
-  std::string msgHash = Keccak256 (msgToHash.str ());
-  CHECK_EQ (msgHash.size (), 32);
+  /* Format the length as decimal into a local buffer.  */
+  char len[24];
+  size_t lenPos = sizeof (len);
+  size_t rem = msg.size ();
+  do
+    {
+      len[--lenPos] = '0' + rem % 10;
+      rem /= 10;
+    }
+  while (rem > 0);
 
-  return msgHash;
+  Keccak256Hasher hasher;
+  hasher.Update (prefix);
+  hasher.Update (std::string_view (len + lenPos, sizeof (len) - lenPos));
+  hasher.Update (msg);
+  hasher.Finish (out);
+}
+
+/**
+ * Signs a 32-byte hash with the given secret key, and writes the
+ * 65-byte Ethereum signature to out.
+ */
+void
+SignHashRaw (const secp256k1_context* ctx, const unsigned char* hash,
+             const unsigned char* secret, unsigned char* out)
+{
+  /* The secret key is verified to be valid already, and we are using the
+     default nonce construction.  Thus signing must succeed.  */
+  secp256k1_ecdsa_recoverable_signature sig;
+  CHECK (secp256k1_ecdsa_sign_recoverable (
+      ctx, &sig, hash, secret, nullptr, nullptr))
+      << "ECDSA signature failed";
+
+  /* Serialise the signature as curve point and recovery ID.  The Ethereum
+     signature is then the curve point (64 bytes) plus the recovery ID appended
+     as another byte, but using 27 or 28 instead of 0 or 1.  */
+  int recoveryId;
+  CHECK (secp256k1_ecdsa_recoverable_signature_serialize_compact (
+      ctx, out, &recoveryId, &sig))
+      << "Failed to serialise ECDSA signature";
+  CHECK (recoveryId >= 0 && recoveryId <= 1)
+      << "Unexpected recovery ID: " << recoveryId;
+  out[64] = static_cast<unsigned char> (recoveryId + 27);
+}
+
+/**
+ * Derives addresses for a batch of items in parallel.  For each index i,
+ * serialise(i, buf) should write the 64-byte uncompressed public key
+ * (without the 0x04 prefix) to buf and return true, or return false
+ * if the item is invalid.
+ */
+template <typename Fcn>
+  std::vector<Address::Binary>
+  DeriveAddresses (const size_t n, const unsigned threads,
+                   const Fcn& serialise)
+{
+  std::vector<Address::Binary> res(n);
+
+  ParallelFor (n, threads, [&] (const size_t begin, const size_t end)
+    {
+      /* Items are serialised into one contiguous buffer per worker, and then
+         hashed all together.  Invalid items are left as zeros and their
+         hashes ignored.  */
+      const size_t num = end - begin;
+      std::vector<unsigned char> keys(64 * num);
+      std::vector<unsigned char> hashes(32 * num);
+      std::vector<bool> valid(num);
+
+      for (size_t i = 0; i < num; ++i)
+        valid[i] = serialise (begin + i, &keys[64 * i]);
+
+      Keccak256Batch (keys.data (), 64, num, hashes.data ());
+
+      for (size_t i = 0; i < num; ++i)
+        {
+          auto& out = res[begin + i];
+          if (!valid[i])
+            {
+              out.fill (0);
+              continue;
+            }
+
+          const unsigned char* hash = &hashes[32 * i];
+          std::copy (hash + 32 - out.size (), hash + 32, out.begin ());
+        }
+    });
+
+  return res;
+}
+
+/**
+ * Writes a 65-byte signature (as returned by SignHashRaw) to out,
+ * converted to the given format.  out must have room for
+ * ECDSA::SignatureSize(fmt) bytes.
+ */
+void
+FormatSignature (const unsigned char* sgn, const ECDSA::SignatureFormat fmt,
+                 char* out)
+{
+  unsigned char compact[64];
+
+  switch (fmt)
+    {
+    case ECDSA::SignatureFormat::BINARY:
+      std::copy (sgn, sgn + 65, out);
+      return;
+
+    case ECDSA::SignatureFormat::HEX:
+      out[0] = '0';
+      out[1] = 'x';
+      Hexlify (sgn, 65, out + 2);
+      return;
+
+    case ECDSA::SignatureFormat::COMPACT:
+    case ECDSA::SignatureFormat::COMPACT_HEX:
+      /* libsecp256k1 produces low s values, so the highest bit of s
+         is always free for the recovery ID.  */
+      std::copy (sgn, sgn + 64, compact);
+      CHECK_EQ (compact[32] & 0x80, 0);
+      if (sgn[64] == 28)
+        compact[32] |= 0x80;
+
+      if (fmt == ECDSA::SignatureFormat::COMPACT)
+        std::copy (compact, compact + 64, out);
+      else
+        {
+          out[0] = '0';
+          out[1] = 'x';
+          Hexlify (compact, 64, out + 2);
+        }
+      return;
+    }
+
+  LOG (FATAL) << "Unexpected signature format: " << static_cast<int> (fmt);
+}
+
+/**
+ * Parses a signature given as hex string with 0x prefix into the binary
+ * form.  Returns false if it is invalid.
+ */
+bool
+ParseHexSignature (const std::string& sgnHex, std::string& sgnBin)
+{
+  if (sgnHex.substr (0, 2) != "0x")
+    {
+      LOG (WARNING) << "Signature string is missing 0x prefix";
+      return false;
+    }
+  if (!Unhexlify (sgnHex.substr (2), sgnBin))
+    {
+      LOG (WARNING) << "Signature string is invalid hex";
+      return false;
+    }
+
+  return true;
+}
+
+/**
+ * Splits a binary signature into the 64-byte r and s values and the
+ * recovery ID (as 0 or 1).  The signature must be 65 bytes, or it can also
+ * be in the 64-byte compact form if allowCompact is set.  Returns false
+ * if the signature is malformed.
+ */
+bool
+SplitSignature (const std::string& sgnBin, const bool allowCompact,
+                unsigned char* rs, int& recoveryId)
+{
+  switch (sgnBin.size ())
+    {
+    case 65:
+      /* The recovery ID is the 65th byte, and it is 27 or 28 while
+         libsecp256k1 expects it as 0 or 1.  */
+      recoveryId = static_cast<int> (sgnBin[64]);
+      if (recoveryId != 27 && recoveryId != 28)
+        {
+          LOG (WARNING) << "Signature v has unexpected value";
+          return false;
+        }
+      recoveryId -= 27;
+      std::copy (sgnBin.begin (), sgnBin.begin () + 64, rs);
+      return true;
+
+    case 64:
+      if (!allowCompact)
+        break;
+
+      /* In the EIP-2098 compact form, the recovery ID is the highest
+         bit of s.  */
+      std::copy (sgnBin.begin (), sgnBin.end (), rs);
+      recoveryId = rs[32] >> 7;
+      rs[32] &= 0x7F;
+      return true;
+
+    default:
+      break;
+    }
+
+  LOG (WARNING) << "Signature has wrong size";
+  return false;
+}
+
+/**
+ * Recovers the public key that signed a given 32-byte hash with a
+ * binary signature (65 bytes, or also compact if allowCompact is set).
+ * Returns false if the signature is invalid.
+ */
+bool
+RecoverPubkey (const secp256k1_context* ctx, const std::string& hash,
+               const std::string& sgnBin, const bool allowCompact,
+               secp256k1_pubkey& pubkey)
+{
+  CHECK_EQ (hash.size (), 32) << "Signed hash must be 32 bytes";
+
+  /* Parse the Ethereum signature into the 64-byte curve point and the
+     recovery ID.  */
+  unsigned char rs[64];
+  int recoveryId;
+  if (!SplitSignature (sgnBin, allowCompact, rs, recoveryId))
+    return false;
+  CHECK (recoveryId >= 0 && recoveryId <= 1);
+
+  secp256k1_ecdsa_recoverable_signature sig;
+  if (!secp256k1_ecdsa_recoverable_signature_parse_compact (
+          ctx, &sig, rs, recoveryId))
+    {
+      LOG (WARNING) << "Failed to parse recoverable signature";
+      return false;
+    }
+
+  if (!secp256k1_ecdsa_recover (ctx, &pubkey, &sig, UChar (hash)))
+    {
+      LOG (WARNING) << "Failed to recover public key from signature";
+      return false;
+    }
+
+  return true;
 }
 
 } // anonymous namespace
@@ -90,37 +363,103 @@ class ECDSA::Context
 
 private:
 
-  /** The actual libsecp256k1 context.  */
-  secp256k1_context* ctx;
+  /**
+   * The libsecp256k1 context we created ourselves and have to destroy,
+   * or null if we just reference another one.
+   */
+  secp256k1_context* owned = nullptr;
+
+  /** The actual libsecp256k1 context to use.  */
+  const secp256k1_context* ctx;
+
+  /** Whether or not the context supports signing.  */
+  bool canSign;
+
+  /**
+   * Returns the process-wide shared context with full capabilities.
+   * It is created on first use and never destroyed, so that it stays valid
+   * even while other static objects are torn down at exit.
+   */
+  static const Context&
+  Shared ()
+  {
+    static const Context* instance = new Context (ContextMode::OWNED);
+    return *instance;
+  }
 
 public:
 
-  Context ()
+  explicit Context (const ContextMode mode)
   {
-    const unsigned flags = SECP256K1_CONTEXT_VERIFY | SECP256K1_CONTEXT_SIGN;
-    ctx = secp256k1_context_create (flags);
+    switch (mode)
+      {
+      case ContextMode::OWNED:
+        {
+          const unsigned flags
+              = SECP256K1_CONTEXT_VERIFY | SECP256K1_CONTEXT_SIGN;
+          owned = secp256k1_context_create (flags);
+          CHECK (owned != nullptr) << "Failed to create secp256k1 context";
+          ctx = owned;
+          canSign = true;
+          break;
+        }
+
+      case ContextMode::VERIFY_ONLY:
+        ctx = secp256k1_context_static;
+        canSign = false;
+        break;
+
+      case ContextMode::SHARED:
+        ctx = *Shared ();
+        canSign = true;
+        break;
+
+      default:
+        LOG (FATAL) << "Unexpected context mode: " << static_cast<int> (mode);
+        break;
+      }
   }
 
   ~Context ()
   {
-    secp256k1_context_destroy (ctx);
+    if (owned != nullptr)
+      secp256k1_context_destroy (owned);
   }
 
+  Context (const Context&) = delete;
+  void operator= (const Context&) = delete;
+
   const secp256k1_context*
   operator* () const
   {
     return ctx;
   }
 
+  bool
+  CanSign () const
+  {
+    return canSign;
+  }
+
 };
 
 ECDSA::ECDSA ()
+  : ECDSA(ContextMode::OWNED)
+{}
+
+ECDSA::ECDSA (const ContextMode mode)
 {
-  ctx = std::make_unique<Context> ();
+  ctx = std::make_unique<Context> (mode);
 }
 
 ECDSA::~ECDSA () = default;
 
+bool
+ECDSA::CanSign () const
+{
+  return ctx->CanSign ();
+}
+
 ECDSA::Key
 ECDSA::SecretKey (const std::string& inp) const
 {
@@ -130,8 +469,10 @@ ECDSA::SecretKey (const std::string& inp) const
 /* ************************************************************************** */
 
 ECDSA::Key::Key (const ECDSA& p, const std::string& inp)
-  : parent(&p)
 {
+  CHECK (p.CanSign ())
+      << "Cannot use secret keys with a verify-only ECDSA instance";
+
   std::string binKey;
 
   if (inp.size () == 32)
@@ -156,111 +497,303 @@ ECDSA::Key::Key (const ECDSA& p, const std::string& inp)
       return;
     }
 
-  const unsigned char* buf = UChar (binKey);
-  std::vector<unsigned char> bytes(buf, buf + binKey.size ());
-  CHECK_EQ (bytes.size (), 32);
+  CHECK_EQ (binKey.size (), secret.size ());
+  if (!secp256k1_ec_seckey_verify (**p.ctx, UChar (binKey)))
+    {
+      LOG (WARNING) << "Secret key is invalid";
+      return;
+    }
+  std::copy (binKey.begin (), binKey.end (), secret.begin ());
 
-  if (secp256k1_ec_seckey_verify (**parent->ctx, bytes.data ()))
-    data = std::move (bytes);
-  else
-    LOG (WARNING) << "Secret key is invalid";
+  /* The secret key is valid, and thus the pubkey conversion
+     should never fail.  */
+  secp256k1_pubkey pk;
+  CHECK (secp256k1_ec_pubkey_create (**p.ctx, &pk, secret.data ()))
+      << "Conversion of secret to public key failed";
+
+  size_t pubkeyLen = pubkey.size ();
+  CHECK (secp256k1_ec_pubkey_serialize (
+            **p.ctx, pubkey.data (), &pubkeyLen,
+            &pk, SECP256K1_EC_UNCOMPRESSED))
+      << "Serialising the pubkey failed";
+  CHECK_EQ (pubkeyLen, pubkey.size ());
+
+  address = std::make_shared<const Address> (PubkeyToAddress (**p.ctx, pk));
 }
 
-Address
+const Address&
 ECDSA::Key::GetAddress () const
 {
   CHECK (*this) << "Key is not valid";
+  return *address;
+}
 
-  /* Note that the secret key is validated by libsecp256k1 whenever
-     the instance is initialised already.  So at this point, it is always
-     valid and thus the pubkey conversion should never fail.  */
-  secp256k1_pubkey pubkey;
-  CHECK (secp256k1_ec_pubkey_create (**parent->ctx, &pubkey, data.data ()))
-      << "Conversion of secret to public key failed";
-
-  return PubkeyToAddress (**parent->ctx, pubkey);
+const ECDSA::Key::PublicKey&
+ECDSA::Key::GetPublicKey () const
+{
+  CHECK (*this) << "Key is not valid";
+  return pubkey;
 }
 
 /* ************************************************************************** */
 
 Address
-ECDSA::VerifyMessage (const std::string& msg, const std::string& sgnHex) const
+ECDSA::VerifyMessage (const std::string& msg, const std::string& sgnHex,
+                      const bool allowCompact) const
 {
-  /* Parse the Ethereum signature into the 64-byte curve point and the
-     recovery ID.  The recovery ID is the 65th byte, and it is 27 or 28
-     while libsecp256k1 expects it as 0 or 1.  */
-  if (sgnHex.substr (0, 2) != "0x")
-    {
-      LOG (WARNING) << "Signature string is missing 0x prefix";
-      return Address ();
-    }
   std::string sgnBin;
-  if (!Unhexlify (sgnHex.substr (2), sgnBin))
+  if (!ParseHexSignature (sgnHex, sgnBin))
+    return Address ();
+
+  return VerifyMessageBinary (msg, sgnBin, allowCompact);
+}
+
+Address
+ECDSA::VerifyMessageBinary (const std::string& msg, const std::string& sgnBin,
+                            const bool allowCompact) const
+{
+  return VerifyHash (MessageHash (msg), sgnBin, allowCompact);
+}
+
+Address
+ECDSA::VerifyHash (const std::string& hash, const std::string& sgnBin,
+                   const bool allowCompact) const
+{
+  secp256k1_pubkey pubkey;
+  if (!RecoverPubkey (**ctx, hash, sgnBin, allowCompact, pubkey))
+    return Address ();
+
+  return PubkeyToAddress (**ctx, pubkey);
+}
+
+bool
+ECDSA::RecoverSigner (const std::string& hash, const std::string& sgnBin,
+                      Address::Binary& signer, const bool allowCompact) const
+{
+  secp256k1_pubkey pubkey;
+  if (!RecoverPubkey (**ctx, hash, sgnBin, allowCompact, pubkey))
+    return false;
+
+  PubkeyToBinaryAddress (**ctx, pubkey, signer);
+  return true;
+}
+
+bool
+ECDSA::VerifyMessageFrom (const std::string& msg, const std::string& sgnHex,
+                          const Address& expected,
+                          const bool allowCompact) const
+{
+  if (!expected)
+    return false;
+
+  std::string sgnBin;
+  if (!ParseHexSignature (sgnHex, sgnBin))
+    return false;
+
+  Address::Binary signer;
+  if (!RecoverSigner (MessageHash (msg), sgnBin, signer, allowCompact))
+    return false;
+
+  return signer == expected.GetBinary ();
+}
+
+std::string
+ECDSA::SignMessage (const std::string& msg, const Key& key) const
+{
+  return "0x" + Hexlify (SignMessageBinary (msg, key));
+}
+
+std::string
+ECDSA::SignMessageBinary (const std::string& msg, const Key& key) const
+{
+  return SignHash (MessageHash (msg), key);
+}
+
+std::string
+ECDSA::SignMessage (const std::string& msg, const Key& key,
+                    const SignatureFormat fmt) const
+{
+  const std::string sgnBin = SignMessageBinary (msg, key);
+
+  std::string res(SignatureSize (fmt), '\0');
+  FormatSignature (UChar (sgnBin), fmt, &res[0]);
+
+  return res;
+}
+
+std::string
+ECDSA::SignMessages (const std::vector<std::string>& msgs, const Key& key,
+                     const SignatureFormat fmt, const unsigned threads) const
+{
+  CHECK (key) << "The secret key must be valid";
+  CHECK (CanSign ()) << "Cannot sign with a verify-only ECDSA instance";
+
+  const size_t sgnSize = SignatureSize (fmt);
+  std::string res(msgs.size () * sgnSize, '\0');
+
+  ParallelFor (msgs.size (), threads, [&] (const size_t begin, const size_t end)
     {
-      LOG (WARNING) << "Signature string is invalid hex";
-      return Address ();
+      unsigned char hash[32];
+      unsigned char sgn[65];
+
+      for (size_t i = begin; i < end; ++i)
+        {
+          MessageHashRaw (msgs[i], hash);
+          SignHashRaw (**ctx, hash, key.secret.data (), sgn);
+          FormatSignature (sgn, fmt, &res[i * sgnSize]);
+        }
+    });
+
+  return res;
+}
+
+std::string
+ECDSA::SignHash (const std::string& hash, const Key& key) const
+{
+  CHECK_EQ (hash.size (), 32) << "Signed hash must be 32 bytes";
+  CHECK (key) << "The secret key must be valid";
+  CHECK (CanSign ()) << "Cannot sign with a verify-only ECDSA instance";
+
+  std::string sgnBin(65, '\0');
+  SignHashRaw (**ctx, UChar (hash), key.secret.data (), UChar (sgnBin));
+
+  return sgnBin;
+}
+
+std::vector<Address::Binary>
+ECDSA::PubkeysToAddresses (const std::vector<std::string>& pubkeys,
+                           const unsigned threads) const
+{
+  return DeriveAddresses (pubkeys.size (), threads,
+      [&] (const size_t i, unsigned char* out)
+        {
+          secp256k1_pubkey pubkey;
+          if (!secp256k1_ec_pubkey_parse (**ctx, &pubkey, UChar (pubkeys[i]),
+                                          pubkeys[i].size ()))
+            {
+              LOG (WARNING) << "Invalid pubkey at index " << i;
+              return false;
+            }
+
+          SerialisePubkeyForAddress (**ctx, pubkey, out);
+          return true;
+        });
+}
+
+std::vector<Address::Binary>
+ECDSA::PubkeysToAddresses (const std::vector<PublicKey>& pubkeys,
+                           const unsigned threads)
+{
+  return DeriveAddresses (pubkeys.size (), threads,
+      [&] (const size_t i, unsigned char* out)
+        {
+          if (pubkeys[i][0] != 0x04)
+            {
+              LOG (WARNING)
+                  << "Pubkey at index " << i << " is not uncompressed";
+              return false;
+            }
+
+          std::copy (pubkeys[i].begin () + 1, pubkeys[i].end (), out);
+          return true;
+        });
+}
+
+std::vector<Address::Binary>
+ECDSA::SecretsToAddresses (const std::vector<std::string>& secrets,
+                           const unsigned threads) const
+{
+  CHECK (CanSign ())
+      << "Cannot use secret keys with a verify-only ECDSA instance";
+
+  return DeriveAddresses (secrets.size (), threads,
+      [&] (const size_t i, unsigned char* out)
+        {
+          secp256k1_pubkey pubkey;
+          if (secrets[i].size () != 32
+                || !secp256k1_ec_pubkey_create (**ctx, &pubkey,
+                                                UChar (secrets[i])))
+            {
+              LOG (WARNING) << "Invalid secret key at index " << i;
+              return false;
+            }
+
+          SerialisePubkeyForAddress (**ctx, pubkey, out);
+          return true;
+        });
+}
+
+std::string
+ECDSA::MessageHash (const std::string_view msg)
+{
+  std::string msgHash(32, '\0');
+  MessageHashRaw (msg, UChar (msgHash));
+
+  return msgHash;
+}
+
+size_t
+ECDSA::SignatureSize (const SignatureFormat fmt)
+{
+  switch (fmt)
+    {
+    case SignatureFormat::BINARY:
+      return 65;
+    case SignatureFormat::HEX:
+      return 2 + 2 * 65;
+    case SignatureFormat::COMPACT:
+      return 64;
+    case SignatureFormat::COMPACT_HEX:
+      return 2 + 2 * 64;
     }
+
+  LOG (FATAL) << "Unexpected signature format: " << static_cast<int> (fmt);
+  return 0;
+}
+
+std::string
+ECDSA::CompactSignature (const std::string& sgnBin)
+{
   if (sgnBin.size () != 65)
     {
       LOG (WARNING) << "Signature has wrong size";
-      return Address ();
+      return "";
     }
-  int recoveryId = static_cast<int> (sgnBin[64]);
-  if (recoveryId != 27 && recoveryId != 28)
-    {
-      LOG (WARNING) << "Signature v has unexpected value";
-      return Address ();
-    }
-  recoveryId -= 27;
-  CHECK (recoveryId >= 0 && recoveryId <= 1);
 
-  secp256k1_ecdsa_recoverable_signature sig;
-  if (!secp256k1_ecdsa_recoverable_signature_parse_compact (
-          **ctx, &sig, UChar (sgnBin), recoveryId))
-    {
-      LOG (WARNING) << "Failed to parse recoverable signature";
-      return Address ();
-    }
+  unsigned char rs[64];
+  int recoveryId;
+  if (!SplitSignature (sgnBin, false, rs, recoveryId))
+    return "";
 
-  const std::string msgHash = MessageHash (msg);
-  secp256k1_pubkey pubkey;
-  if (!secp256k1_ecdsa_recover (
-      **ctx, &pubkey, &sig, UChar (msgHash)))
+  if (std::lexicographical_compare (HALF_ORDER, HALF_ORDER + 32,
+                                    rs + 32, rs + 64))
     {
-      LOG (WARNING) << "Failed to recover public key from signature";
-      return Address ();
+      LOG (WARNING) << "Signature with high s cannot be made compact";
+      return "";
     }
+  if (recoveryId == 1)
+    rs[32] |= 0x80;
 
-  return PubkeyToAddress (**ctx, pubkey);
+  return std::string (reinterpret_cast<const char*> (rs), sizeof (rs));
 }
 
 std::string
-ECDSA::SignMessage (const std::string& msg, const Key& key) const
+ECDSA::ExpandSignature (const std::string& compact)
 {
-  CHECK (key) << "The secret key must be valid";
-
-  /* We already verified that the key is valid, and are using the default
-     nonce construction.  Thus signing must succeed.  */
-  const std::string msgHash = MessageHash (msg);
-  secp256k1_ecdsa_recoverable_signature sig;
-  CHECK (secp256k1_ecdsa_sign_recoverable (
-      **ctx, &sig, UChar (msgHash), key.data.data (), nullptr, nullptr))
-      << "ECDSA signature failed";
+  if (compact.size () != 64)
+    {
+      LOG (WARNING) << "Compact signature has wrong size";
+      return "";
+    }
 
-  /* Serialise the signature as curve point and recovery ID.  The Ethereum
-     signature is then the curve point (64 bytes) plus the recovery ID appended
-     as another byte, but using 27 or 28 instead of 0 or 1.  */
-  std::string sgnBin(65, '\0');
+  unsigned char rs[64];
   int recoveryId;
-  CHECK (secp256k1_ecdsa_recoverable_signature_serialize_compact (
-      **ctx, UChar (sgnBin), &recoveryId, &sig))
-      << "Failed to serialise ECDSA signature";
-  CHECK (recoveryId >= 0 && recoveryId <= 1)
-      << "Unexpected recovery ID: " << recoveryId;
-  recoveryId += 27;
-  sgnBin[64] = static_cast<char> (recoveryId);
+  CHECK (SplitSignature (compact, true, rs, recoveryId));
+
+  std::string res(reinterpret_cast<const char*> (rs), sizeof (rs));
+  res.push_back (static_cast<char> (27 + recoveryId));
 
-  return "0x" + Hexlify (sgnBin);
+  return res;
 }
 
 /* ************************************************************************** */
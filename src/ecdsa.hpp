@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2022 The Xaya developers
+// Copyright (C) 2021-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -7,8 +7,11 @@
 
 #include "address.hpp"
 
+#include <array>
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace ethutils
@@ -20,10 +23,62 @@ namespace ethutils
  * some precomputation tables (a context from the underlying libsecp256k1
  * library), which is more efficient to keep around than recreate on
  * every operation.
+ *
+ * Instances that only verify signatures can avoid building their own context
+ * by using ContextMode::VERIFY_ONLY, and instances that need signing as well
+ * can share a single process-wide context with ContextMode::SHARED.
  */
 class ECDSA
 {
 
+public:
+
+  /**
+   * The different ways in which an instance can obtain the underlying
+   * libsecp256k1 context.
+   */
+  enum class ContextMode
+  {
+
+    /** The instance creates and owns a new context with full capabilities.  */
+    OWNED,
+
+    /**
+     * The instance uses the static context of libsecp256k1.  This requires
+     * no allocation or precomputation, but only supports verification.
+     * Signing or using secret keys with such an instance CHECK-fails.
+     */
+    VERIFY_ONLY,
+
+    /**
+     * The instance references a process-wide context with full capabilities,
+     * which is created once on first use and then shared.
+     */
+    SHARED,
+
+  };
+
+  /** Formats in which batch signing can return signatures.  */
+  enum class SignatureFormat
+  {
+
+    /** Raw 65-byte binary signatures.  */
+    BINARY,
+
+    /** Hex strings with 0x prefix (132 characters per signature).  */
+    HEX,
+
+    /**
+     * Raw 64-byte compact signatures as per EIP-2098, where the recovery ID
+     * is folded into the highest bit of s.
+     */
+    COMPACT,
+
+    /** Compact signatures as hex with 0x prefix (130 characters each).  */
+    COMPACT_HEX,
+
+  };
+
 private:
 
   class Context;
@@ -35,16 +90,35 @@ public:
 
   class Key;
 
+  /**
+   * Type for a public key, serialised in uncompressed form (a 0x04 byte
+   * followed by the 32-byte x and y coordinates).
+   */
+  using PublicKey = std::array<unsigned char, 65>;
+
+  /**
+   * Constructs an instance that owns its context (ContextMode::OWNED).
+   */
   ECDSA ();
+
+  explicit ECDSA (ContextMode mode);
+
   ~ECDSA ();
 
   ECDSA (const ECDSA&) = delete;
   void operator= (const ECDSA&) = delete;
 
+  /**
+   * Returns true if this instance can be used for signing (i.e. it is not
+   * verify-only).
+   */
+  bool CanSign () const;
+
   /**
    * Constructs and returns a secret key for this context from a string.
    * The string can either be a raw binary string with 32 bytes, or a
-   * hex-encoded string with 0x prefix.
+   * hex-encoded string with 0x prefix.  This must not be called on
+   * a verify-only instance.
    */
   Key SecretKey (const std::string& inp) const;
 
@@ -54,10 +128,49 @@ public:
    * if the signature is invalid in general.
    *
    * The message is a general byte string, and the signature is given as
-   * 65-byte hex string with 0x prefix.
+   * 65-byte hex string with 0x prefix.  If allowCompact is set, the 64-byte
+   * compact form of EIP-2098 is accepted as well.
    */
-   Address VerifyMessage (const std::string& msg,
-                          const std::string& sgnHex) const;
+   Address VerifyMessage (const std::string& msg, const std::string& sgnHex,
+                          bool allowCompact = false) const;
+
+  /**
+   * Verifies a signature on a message like VerifyMessage, but with the
+   * signature given as raw 65-byte binary string (or 64 bytes for the
+   * compact form if allowCompact is set).
+   */
+  Address VerifyMessageBinary (const std::string& msg,
+                               const std::string& sgnBin,
+                               bool allowCompact = false) const;
+
+  /**
+   * Recovers the signer address of a signature made directly on the
+   * given 32-byte hash (e.g. the result of MessageHash).  The signature
+   * is a raw 65-byte binary string, or also a 64-byte compact signature
+   * if allowCompact is set.  Returns an invalid address if the signature
+   * is invalid.
+   */
+  Address VerifyHash (const std::string& hash, const std::string& sgnBin,
+                      bool allowCompact = false) const;
+
+  /**
+   * Recovers the signer of a signature on a 32-byte hash like VerifyHash,
+   * but returns the raw address bytes in signer instead of constructing
+   * a checksummed Address.  Returns false if the signature is invalid.
+   */
+  bool RecoverSigner (const std::string& hash, const std::string& sgnBin,
+                      Address::Binary& signer,
+                      bool allowCompact = false) const;
+
+  /**
+   * Verifies that a signature (given as hex string with 0x prefix) on a
+   * message has been made by the given expected address.  This is faster
+   * than comparing the result of VerifyMessage, as it compares the
+   * raw address bytes and does not construct a checksummed Address.
+   */
+  bool VerifyMessageFrom (const std::string& msg, const std::string& sgnHex,
+                          const Address& expected,
+                          bool allowCompact = false) const;
 
   /**
    * Signs a message with the given key (using the legacy message encoding).
@@ -68,21 +181,122 @@ public:
    */
   std::string SignMessage (const std::string& msg, const Key& key) const;
 
+  /**
+   * Signs a message like SignMessage, but returns the signature as raw
+   * 65-byte binary string.
+   */
+  std::string SignMessageBinary (const std::string& msg, const Key& key) const;
+
+  /**
+   * Signs a message like SignMessage, but returns the signature in the
+   * given format (e.g. compact).
+   */
+  std::string SignMessage (const std::string& msg, const Key& key,
+                           SignatureFormat fmt) const;
+
+  /**
+   * Signs a batch of messages with the same key (using the legacy message
+   * encoding).  The work is split across up to the given number of threads
+   * (zero means to use the hardware concurrency).
+   *
+   * The signatures are returned in one buffer and in the order of the input
+   * messages.  Each takes SignatureSize(fmt) bytes, i.e. the signature
+   * for msgs[i] starts at offset i * SignatureSize(fmt).
+   */
+  std::string SignMessages (const std::vector<std::string>& msgs,
+                            const Key& key, SignatureFormat fmt,
+                            unsigned threads = 0) const;
+
+  /**
+   * Signs the given 32-byte hash directly, and returns the signature
+   * as raw 65-byte binary string.
+   */
+  std::string SignHash (const std::string& hash, const Key& key) const;
+
+  /**
+   * Derives the addresses for a batch of serialised public keys (each
+   * either 33 bytes compressed or 65 bytes uncompressed).  The work is
+   * split across up to the given number of threads (zero means to use the
+   * hardware concurrency), and the hashing is done with Keccak256Batch.
+   *
+   * Returns the raw address for each pubkey, in order.  For invalid
+   * pubkeys, the returned address is all zeros.
+   */
+  std::vector<Address::Binary> PubkeysToAddresses (
+      const std::vector<std::string>& pubkeys, unsigned threads = 0) const;
+
+  /**
+   * Derives the addresses for a batch of uncompressed public keys (e.g. as
+   * returned from Key::GetPublicKey).  They are hashed directly and not
+   * parsed, so they are not checked to be valid curve points.
+   */
+  static std::vector<Address::Binary> PubkeysToAddresses (
+      const std::vector<PublicKey>& pubkeys, unsigned threads = 0);
+
+  /**
+   * Derives the addresses for a batch of raw 32-byte secret keys.  For
+   * invalid secret keys, the returned address is all zeros.  This must not
+   * be called on a verify-only instance.
+   */
+  std::vector<Address::Binary> SecretsToAddresses (
+      const std::vector<std::string>& secrets, unsigned threads = 0) const;
+
+  /**
+   * Computes the 32-byte hash that is signed for a message with the
+   * legacy "Ethereum Signed Message" encoding.
+   */
+  static std::string MessageHash (std::string_view msg);
+
+  /**
+   * Returns the size in bytes of one signature in the given format.
+   */
+  static size_t SignatureSize (SignatureFormat fmt);
+
+  /**
+   * Converts a raw 65-byte signature to the 64-byte compact form of
+   * EIP-2098.  Returns an empty string if the signature is malformed
+   * (including if it has a high s value, which cannot be represented).
+   */
+  static std::string CompactSignature (const std::string& sgnBin);
+
+  /**
+   * Converts a 64-byte compact signature back to the raw 65-byte form.
+   * Returns an empty string if the input has the wrong size.
+   */
+  static std::string ExpandSignature (const std::string& compact);
+
 };
 
 /**
- * A private key for signing ECDSA messages.
+ * A private key for signing ECDSA messages.  The corresponding public key
+ * and address are computed once when the key is constructed and cached,
+ * so that querying them is cheap.  Copying a key does not allocate.
  */
 class ECDSA::Key
 {
 
+public:
+
+  /** Type for the raw 32-byte secret key.  */
+  using Secret = std::array<unsigned char, 32>;
+
+  /** Type for the uncompressed public key.  */
+  using PublicKey = ECDSA::PublicKey;
+
 private:
 
-  /** The corresponding ECDSA context.  */
-  const ECDSA* parent;
+  /** The underlying 32-byte secret key (if the key is valid).  */
+  Secret secret = {};
+
+  /** The cached public key (if the key is valid).  */
+  PublicKey pubkey = {};
 
-  /** The underlying 32-byte key or empty if the key is invalid.  */
-  std::vector<unsigned char> data;
+  /**
+   * The cached address corresponding to the key, or null if the key
+   * is invalid.  It is shared between copies of the key, so that copying
+   * does not need to allocate memory for the address string.
+   */
+  std::shared_ptr<const Address> address;
 
   /**
    * Constructs a key from given input.  The input should be either a raw
@@ -113,13 +327,18 @@ public:
   inline operator
   bool () const
   {
-    return !data.empty ();
+    return address != nullptr;
   }
 
   /**
-   * Returns the address corresponding to the key.
+   * Returns the address corresponding to the key.  The key must be valid.
+   */
+  const Address& GetAddress () const;
+
+  /**
+   * Returns the public key corresponding to the key.  The key must be valid.
    */
-  Address GetAddress () const;
+  const PublicKey& GetPublicKey () const;
 
 };
 
@@ -0,0 +1,130 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/* Simple benchmark for the cost of constructing ECDSA instances in their
+   various context modes, and for the verification speed with each of them.
+   This is not run as part of the tests, but built with "make check" and
+   can be run manually.  */
+
+#include "ecdsa.hpp"
+
+#include <secp256k1.h>
+#include <secp256k1_preallocated.h>
+
+#include <glog/logging.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+using ethutils::ECDSA;
+
+using Clock = std::chrono::steady_clock;
+
+/** Number of instances to construct for each mode.  */
+constexpr unsigned CONSTRUCTIONS = 1'000;
+
+/** Number of verifications to do for each mode.  */
+constexpr unsigned VERIFICATIONS = 1'000;
+
+/**
+ * Returns a human-readable name for the given context mode.
+ */
+std::string
+ModeName (const ECDSA::ContextMode mode)
+{
+  switch (mode)
+    {
+    case ECDSA::ContextMode::OWNED:
+      return "owned";
+    case ECDSA::ContextMode::VERIFY_ONLY:
+      return "verify-only";
+    case ECDSA::ContextMode::SHARED:
+      return "shared";
+    }
+
+  return "unknown";
+}
+
+/**
+ * Returns the number of bytes allocated by libsecp256k1 for the
+ * context of an instance in the given mode.
+ */
+size_t
+ContextBytes (const ECDSA::ContextMode mode)
+{
+  if (mode != ECDSA::ContextMode::OWNED)
+    return 0;
+
+  const unsigned flags = SECP256K1_CONTEXT_VERIFY | SECP256K1_CONTEXT_SIGN;
+  return secp256k1_context_preallocated_size (flags);
+}
+
+/**
+ * Returns the average time in microseconds per iteration.
+ */
+double
+Micros (const Clock::duration d, const unsigned iterations)
+{
+  using Micro = std::chrono::duration<double, std::micro>;
+  return std::chrono::duration_cast<Micro> (d).count () / iterations;
+}
+
+void
+RunMode (const ECDSA::ContextMode mode, const std::string& msg,
+         const std::string& sgn)
+{
+  const auto startConstruct = Clock::now ();
+  for (unsigned i = 0; i < CONSTRUCTIONS; ++i)
+    ECDSA ec(mode);
+  const auto construct = Clock::now () - startConstruct;
+
+  const ECDSA ec(mode);
+  const auto startVerify = Clock::now ();
+  for (unsigned i = 0; i < VERIFICATIONS; ++i)
+    CHECK (ec.VerifyMessage (msg, sgn));
+  const auto verify = Clock::now () - startVerify;
+
+  std::cout << std::setw (12) << ModeName (mode)
+            << std::setw (16) << Micros (construct, CONSTRUCTIONS)
+            << std::setw (16) << ContextBytes (mode)
+            << std::setw (16) << Micros (verify, VERIFICATIONS)
+            << std::endl;
+}
+
+} // anonymous namespace
+
+int
+main (int argc, char** argv)
+{
+  google::InitGoogleLogging (argv[0]);
+
+  const std::string msg = "benchmark message";
+  std::string sgn;
+  {
+    const ECDSA ec;
+    const auto key = ec.SecretKey ("0x"
+        "918fb30e03abd86ddbfcffb1ec3ea86607d56f307e2ffac71ffb41cbc813d093");
+    CHECK (key);
+    sgn = ec.SignMessage (msg, key);
+  }
+
+  std::cout << std::fixed << std::setprecision (2);
+  std::cout << std::setw (12) << "mode"
+            << std::setw (16) << "construct (us)"
+            << std::setw (16) << "context bytes"
+            << std::setw (16) << "verify (us)"
+            << std::endl;
+
+  RunMode (ECDSA::ContextMode::OWNED, msg, sgn);
+  RunMode (ECDSA::ContextMode::VERIFY_ONLY, msg, sgn);
+  RunMode (ECDSA::ContextMode::SHARED, msg, sgn);
+
+  return EXIT_SUCCESS;
+}
@@ -1,10 +1,11 @@
-// Copyright (C) 2021 The Xaya developers
+// Copyright (C) 2021-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "ecdsa.hpp"
 
 #include "hexutils.hpp"
+#include "keccak.hpp"
 
 #include <glog/logging.h>
 #include <gtest/gtest.h>
@@ -77,6 +78,30 @@ TEST_F (EcdsaTests, SecretKeys)
   EXPECT_EQ (k2.GetAddress (), ADDRESS);
 }
 
+TEST_F (EcdsaTests, CachedKeyData)
+{
+  const auto key = ec.SecretKey (SECRET);
+  ASSERT_TRUE (key);
+
+  const auto& pubkey = key.GetPublicKey ();
+  EXPECT_EQ (pubkey[0], 0x04);
+  const std::string pubkeyBin(pubkey.begin () + 1, pubkey.end ());
+  EXPECT_EQ (Keccak256 (pubkeyBin).substr (12),
+             std::string (ADDRESS.GetBinary ().begin (),
+                          ADDRESS.GetBinary ().end ()));
+
+  ECDSA::Key copy;
+  EXPECT_FALSE (copy);
+  copy = key;
+  ASSERT_TRUE (copy);
+  EXPECT_EQ (copy.GetAddress (), ADDRESS);
+  EXPECT_EQ (&copy.GetAddress (), &key.GetAddress ());
+  EXPECT_EQ (copy.GetPublicKey (), pubkey);
+
+  EXPECT_DEATH (ECDSA::Key ().GetAddress (), "not valid");
+  EXPECT_DEATH (ECDSA::Key ().GetPublicKey (), "not valid");
+}
+
 TEST_F (EcdsaTests, Signing)
 {
   const auto key = ec.SecretKey (SECRET);
@@ -84,5 +109,316 @@ TEST_F (EcdsaTests, Signing)
   EXPECT_EQ (ec.VerifyMessage ("foobar", sgn), ADDRESS);
 }
 
+TEST_F (EcdsaTests, BinarySignatures)
+{
+  const auto key = ec.SecretKey (SECRET);
+
+  const auto sgnBin = ec.SignMessageBinary ("foobar", key);
+  ASSERT_EQ (sgnBin.size (), 65);
+  EXPECT_EQ ("0x" + Hexlify (sgnBin), ec.SignMessage ("foobar", key));
+  EXPECT_EQ (ec.VerifyMessageBinary ("foobar", sgnBin), ADDRESS);
+  EXPECT_FALSE (ec.VerifyMessageBinary ("foobar", sgnBin.substr (1)));
+  EXPECT_FALSE (ec.VerifyMessageBinary ("foobar", sgnBin.substr (0, 64)));
+  /* With compact signatures allowed, 64 bytes are parsed as such,
+     which does not match.  */
+  EXPECT_NE (ec.VerifyMessageBinary ("foobar", sgnBin.substr (1), true),
+             ADDRESS);
+
+  std::string sgnHexBin;
+  ASSERT_TRUE (Unhexlify (
+      "08d7f4d7959eaa2abbd8cc6c0d7f57091d93eed4cdade4d0e763dc6be0d59aa7"
+      "0accd2e4f72553763d6ebe867aceb5543c45c9a59194f1fb71c564356f5dd6f0"
+      "1c", sgnHexBin));
+  EXPECT_EQ (ec.VerifyMessageBinary ("foobar", sgnHexBin),
+             Address ("0x14e663e1531e0f438840952d18720c74c28d4f20"));
+}
+
+TEST_F (EcdsaTests, MessageHash)
+{
+  EXPECT_EQ (Hexlify (ECDSA::MessageHash ("foobar")),
+             Hexlify (Keccak256 ("\x19" "Ethereum Signed Message:\n6foobar")));
+  EXPECT_EQ (Hexlify (ECDSA::MessageHash ("")),
+             Hexlify (Keccak256 ("\x19" "Ethereum Signed Message:\n0")));
+}
+
+TEST_F (EcdsaTests, Hashes)
+{
+  const auto key = ec.SecretKey (SECRET);
+  const std::string hash = Keccak256 ("some data");
+
+  const auto sgn = ec.SignHash (hash, key);
+  EXPECT_EQ (ec.VerifyHash (hash, sgn), ADDRESS);
+  EXPECT_NE (ec.VerifyHash (Keccak256 ("other data"), sgn), ADDRESS);
+  EXPECT_FALSE (ec.VerifyHash (hash, sgn.substr (0, 64) + "\x1d"));
+
+  EXPECT_EQ (ec.SignHash (ECDSA::MessageHash ("foobar"), key),
+             ec.SignMessageBinary ("foobar", key));
+
+  EXPECT_DEATH (ec.SignHash ("foo", key), "32 bytes");
+  EXPECT_DEATH (ec.VerifyHash ("foo", sgn), "32 bytes");
+}
+
+TEST_F (EcdsaTests, VerifyMessageFrom)
+{
+  const auto key = ec.SecretKey (SECRET);
+  const auto sgn = ec.SignMessage ("foobar", key);
+  const Address other("0x14e663e1531e0f438840952d18720c74c28d4f20");
+
+  EXPECT_TRUE (ec.VerifyMessageFrom ("foobar", sgn, ADDRESS));
+  EXPECT_FALSE (ec.VerifyMessageFrom ("foobar", sgn, other));
+  EXPECT_FALSE (ec.VerifyMessageFrom ("foo", sgn, ADDRESS));
+  EXPECT_FALSE (ec.VerifyMessageFrom ("foobar", sgn, Address ()));
+  EXPECT_FALSE (ec.VerifyMessageFrom ("foobar", "0x1234", ADDRESS));
+  EXPECT_FALSE (ec.VerifyMessageFrom ("foobar", sgn.substr (2), ADDRESS));
+
+  EXPECT_TRUE (ec.VerifyMessageFrom ("foobar", "0x"
+      "08d7f4d7959eaa2abbd8cc6c0d7f57091d93eed4cdade4d0e763dc6be0d59aa7"
+      "0accd2e4f72553763d6ebe867aceb5543c45c9a59194f1fb71c564356f5dd6f0"
+      "1c", other));
+}
+
+TEST_F (EcdsaTests, SignMessagesBatch)
+{
+  const auto key = ec.SecretKey (SECRET);
+
+  std::vector<std::string> msgs;
+  for (unsigned i = 0; i < 50; ++i)
+    msgs.push_back ("message " + std::to_string (i));
+  msgs.push_back ("");
+
+  const size_t binSize = ECDSA::SignatureSize (ECDSA::SignatureFormat::BINARY);
+  const size_t hexSize = ECDSA::SignatureSize (ECDSA::SignatureFormat::HEX);
+  const size_t compactSize
+      = ECDSA::SignatureSize (ECDSA::SignatureFormat::COMPACT);
+  const size_t compactHexSize
+      = ECDSA::SignatureSize (ECDSA::SignatureFormat::COMPACT_HEX);
+  ASSERT_EQ (binSize, 65);
+  ASSERT_EQ (hexSize, 132);
+  ASSERT_EQ (compactSize, 64);
+  ASSERT_EQ (compactHexSize, 130);
+
+  for (const unsigned threads : {0u, 1u, 4u})
+    {
+      const auto bin = ec.SignMessages (msgs, key,
+                                        ECDSA::SignatureFormat::BINARY,
+                                        threads);
+      const auto hex = ec.SignMessages (msgs, key,
+                                        ECDSA::SignatureFormat::HEX,
+                                        threads);
+      const auto compact = ec.SignMessages (msgs, key,
+                                            ECDSA::SignatureFormat::COMPACT,
+                                            threads);
+      const auto compactHex
+          = ec.SignMessages (msgs, key, ECDSA::SignatureFormat::COMPACT_HEX,
+                             threads);
+      ASSERT_EQ (bin.size (), msgs.size () * binSize);
+      ASSERT_EQ (hex.size (), msgs.size () * hexSize);
+      ASSERT_EQ (compact.size (), msgs.size () * compactSize);
+      ASSERT_EQ (compactHex.size (), msgs.size () * compactHexSize);
+
+      for (size_t i = 0; i < msgs.size (); ++i)
+        {
+          const std::string sgnBin = bin.substr (i * binSize, binSize);
+          EXPECT_EQ (sgnBin, ec.SignMessageBinary (msgs[i], key));
+          const std::string sgnHex = hex.substr (i * hexSize, hexSize);
+          EXPECT_EQ (sgnHex, ec.SignMessage (msgs[i], key));
+          EXPECT_EQ (ec.VerifyMessage (msgs[i], sgnHex), ADDRESS);
+
+          const std::string sgnCompact
+              = compact.substr (i * compactSize, compactSize);
+          EXPECT_EQ (sgnCompact, ECDSA::CompactSignature (sgnBin));
+          const std::string sgnCompactHex
+              = compactHex.substr (i * compactHexSize, compactHexSize);
+          EXPECT_EQ (sgnCompactHex, "0x" + Hexlify (sgnCompact));
+          EXPECT_EQ (ec.VerifyMessage (msgs[i], sgnCompactHex, true),
+                     ADDRESS);
+        }
+    }
+
+  EXPECT_EQ (ec.SignMessages ({}, key, ECDSA::SignatureFormat::HEX), "");
+}
+
+TEST_F (EcdsaTests, CompactSignatureVectors)
+{
+  /* Test vectors from EIP-2098.  */
+  const auto key = ec.SecretKey (
+      "0x1234567890123456789012345678901234567890123456789012345678901234");
+  const std::string r1
+      = "68a020a209d3d56c46f38cc50a33f704f4a9a10a59377f8dd762ac66910e9b90";
+  const std::string s1
+      = "7e865ad05c4035ab5792787d4a0297a43617ae897930a6fe4d822b8faea52064";
+  const std::string r2
+      = "9328da16089fcba9bececa81663203989f2df5fe1faa6291a45381c81bd17f76";
+  const std::string s2
+      = "139c6d6b623b42da56557e5e734a43dc83345ddfadec52cbe24d0cc64f550793";
+  const std::string ys2
+      = "939c6d6b623b42da56557e5e734a43dc83345ddfadec52cbe24d0cc64f550793";
+
+  const std::string msg1 = "Hello World";
+  const std::string msg2 = "It's a small(er) world";
+
+  EXPECT_EQ (ec.SignMessage (msg1, key), "0x" + r1 + s1 + "1b");
+  EXPECT_EQ (ec.SignMessage (msg2, key), "0x" + r2 + s2 + "1c");
+  EXPECT_EQ (ec.SignMessage (msg1, key, ECDSA::SignatureFormat::COMPACT_HEX),
+             "0x" + r1 + s1);
+  EXPECT_EQ (ec.SignMessage (msg2, key, ECDSA::SignatureFormat::COMPACT_HEX),
+             "0x" + r2 + ys2);
+
+  EXPECT_EQ (ec.VerifyMessage (msg1, "0x" + r1 + s1, true),
+             key.GetAddress ());
+  EXPECT_EQ (ec.VerifyMessage (msg2, "0x" + r2 + ys2, true),
+             key.GetAddress ());
+  EXPECT_NE (ec.VerifyMessage (msg2, "0x" + r2 + s2, true),
+             key.GetAddress ());
+  EXPECT_TRUE (ec.VerifyMessageFrom (msg2, "0x" + r2 + ys2,
+                                     key.GetAddress (), true));
+
+  /* Without opting in, compact signatures are rejected.  */
+  EXPECT_FALSE (ec.VerifyMessage (msg1, "0x" + r1 + s1));
+  EXPECT_FALSE (ec.VerifyMessageFrom (msg2, "0x" + r2 + ys2,
+                                      key.GetAddress ()));
+}
+
+TEST_F (EcdsaTests, CompactSignatureConversion)
+{
+  const auto key = ec.SecretKey (SECRET);
+
+  for (const std::string msg : {"foo", "bar", "baz", "foobar"})
+    {
+      const auto full = ec.SignMessageBinary (msg, key);
+      const auto compact
+          = ec.SignMessage (msg, key, ECDSA::SignatureFormat::COMPACT);
+      ASSERT_EQ (compact.size (), 64);
+
+      EXPECT_EQ (ECDSA::CompactSignature (full), compact);
+      EXPECT_EQ (ECDSA::ExpandSignature (compact), full);
+      EXPECT_EQ (ec.VerifyMessageBinary (msg, compact, true), ADDRESS);
+      EXPECT_EQ (ec.VerifyHash (ECDSA::MessageHash (msg), compact, true),
+                 ADDRESS);
+      EXPECT_FALSE (ec.VerifyHash (ECDSA::MessageHash (msg), compact));
+
+      EXPECT_EQ (ec.SignMessage (msg, key, ECDSA::SignatureFormat::BINARY),
+                 full);
+      EXPECT_EQ (ec.SignMessage (msg, key, ECDSA::SignatureFormat::HEX),
+                 ec.SignMessage (msg, key));
+    }
+
+  const auto full = ec.SignMessageBinary ("foo", key);
+  EXPECT_EQ (ECDSA::CompactSignature (full.substr (1)), "");
+  EXPECT_EQ (ECDSA::CompactSignature (full.substr (0, 64) + "\x1d"), "");
+  std::string highS = full;
+  highS[32] |= 0x80;
+  EXPECT_EQ (ECDSA::CompactSignature (highS), "");
+
+  /* s values between n/2 and 2^255 are high as well, even though their
+     top bit is not set.  Exactly n/2 is still fine.  */
+  std::string halfOrder;
+  ASSERT_TRUE (Unhexlify (
+      "7fffffffffffffffffffffffffffffff5d576e7357a4501ddfe92f46681b20a0",
+      halfOrder));
+  std::string s = halfOrder;
+  s.back () += 1;
+  highS = full.substr (0, 32) + s + full.substr (64);
+  EXPECT_EQ (ECDSA::CompactSignature (highS), "");
+  const std::string lowS = full.substr (0, 32) + halfOrder + full.substr (64);
+  EXPECT_EQ (ECDSA::ExpandSignature (ECDSA::CompactSignature (lowS)), lowS);
+  EXPECT_EQ (ECDSA::ExpandSignature (full), "");
+}
+
+TEST_F (EcdsaTests, BatchAddressDerivation)
+{
+  std::vector<ECDSA::Key> keys;
+  std::vector<std::string> secrets;
+  std::vector<std::string> pubkeys;
+  std::vector<ECDSA::PublicKey> parsed;
+  for (unsigned i = 1; i <= 13; ++i)
+    {
+      secrets.push_back (std::string (31, '\0') + static_cast<char> (i));
+      keys.push_back (ec.SecretKey (secrets.back ()));
+      parsed.push_back (keys.back ().GetPublicKey ());
+
+      /* Alternate between uncompressed and compressed serialisation.  */
+      const auto& pk = parsed.back ();
+      if (i % 2 == 0)
+        pubkeys.emplace_back (pk.begin (), pk.end ());
+      else
+        {
+          const char prefix = (pk[64] & 1) ? '\x03' : '\x02';
+          pubkeys.push_back (prefix + std::string (pk.begin () + 1,
+                                                   pk.begin () + 33));
+        }
+    }
+
+  /* Some invalid entries, which should yield zero addresses.  */
+  secrets.push_back (std::string (32, '\0'));
+  secrets.push_back ("short");
+  pubkeys.push_back ('\x05' + std::string (32, '\x02'));
+  pubkeys.push_back ("");
+  parsed.push_back (ECDSA::PublicKey ());
+
+  const Address::Binary zero = {};
+  for (const unsigned threads : {1u, 3u, 0u})
+    {
+      const auto fromSecrets = ec.SecretsToAddresses (secrets, threads);
+      const auto fromPubkeys = ec.PubkeysToAddresses (pubkeys, threads);
+      const auto fromParsed = ECDSA::PubkeysToAddresses (parsed, threads);
+      ASSERT_EQ (fromSecrets.size (), secrets.size ());
+      ASSERT_EQ (fromPubkeys.size (), pubkeys.size ());
+      ASSERT_EQ (fromParsed.size (), parsed.size ());
+
+      for (size_t i = 0; i < keys.size (); ++i)
+        {
+          const auto& expected = keys[i].GetAddress ().GetBinary ();
+          EXPECT_EQ (fromSecrets[i], expected);
+          EXPECT_EQ (fromPubkeys[i], expected);
+          EXPECT_EQ (fromParsed[i], expected);
+        }
+
+      EXPECT_EQ (fromSecrets[keys.size ()], zero);
+      EXPECT_EQ (fromSecrets[keys.size () + 1], zero);
+      EXPECT_EQ (fromPubkeys[keys.size ()], zero);
+      EXPECT_EQ (fromPubkeys[keys.size () + 1], zero);
+      EXPECT_EQ (fromParsed[keys.size ()], zero);
+    }
+
+  EXPECT_TRUE (ec.PubkeysToAddresses (std::vector<std::string> ()).empty ());
+}
+
+TEST_F (EcdsaTests, VerifyOnly)
+{
+  const ECDSA verifier(ECDSA::ContextMode::VERIFY_ONLY);
+  EXPECT_FALSE (verifier.CanSign ());
+  EXPECT_TRUE (ec.CanSign ());
+
+  const auto key = ec.SecretKey (SECRET);
+  const auto sgn = ec.SignMessage ("foobar", key);
+  EXPECT_EQ (verifier.VerifyMessage ("foobar", sgn), ADDRESS);
+  EXPECT_FALSE (verifier.VerifyMessage ("", sgn) == ADDRESS);
+
+  EXPECT_DEATH (verifier.SignMessage ("foobar", key), "verify-only");
+  EXPECT_DEATH (verifier.SecretKey (SECRET), "verify-only");
+  EXPECT_DEATH (verifier.SecretsToAddresses ({}), "verify-only");
+
+  const std::vector<std::string> pubkeys =
+    {
+      std::string (key.GetPublicKey ().begin (), key.GetPublicKey ().end ()),
+    };
+  EXPECT_EQ (verifier.PubkeysToAddresses (pubkeys)[0], ADDRESS.GetBinary ());
+}
+
+TEST_F (EcdsaTests, SharedContext)
+{
+  const ECDSA shared1(ECDSA::ContextMode::SHARED);
+  const ECDSA shared2(ECDSA::ContextMode::SHARED);
+  EXPECT_TRUE (shared1.CanSign ());
+
+  const auto key = shared1.SecretKey (SECRET);
+  EXPECT_EQ (key.GetAddress (), ADDRESS);
+
+  const auto sgn = shared1.SignMessage ("foobar", key);
+  EXPECT_EQ (shared2.VerifyMessage ("foobar", sgn), ADDRESS);
+  EXPECT_EQ (ec.VerifyMessage ("foobar", sgn), ADDRESS);
+}
+
 } // anonymous namespace
 } // namespace ethutils
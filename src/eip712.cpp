@@ -0,0 +1,423 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "eip712.hpp"
+
+#include "keccak.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cctype>
+
+namespace ethutils
+{
+
+namespace
+{
+
+/**
+ * Returns the bytes of a string as unsigned char.
+ */
+const unsigned char*
+UChar (const std::string& str)
+{
+  return reinterpret_cast<const unsigned char*> (str.data ());
+}
+
+/**
+ * Parses the numeric suffix of a type name like "uint256" after the
+ * given prefix.  Returns -1 if there is no valid number.
+ */
+int
+TypeSuffix (const std::string& type, const std::string& prefix)
+{
+  if (type.substr (0, prefix.size ()) != prefix)
+    return -1;
+
+  const std::string suffix = type.substr (prefix.size ());
+  if (suffix.empty () || suffix.size () > 3 || suffix[0] == '0')
+    return -1;
+  for (const char c : suffix)
+    if (!std::isdigit (c))
+      return -1;
+
+  return std::stoi (suffix);
+}
+
+/**
+ * Parses an atomic type name, and returns its base type and size parameter.
+ * Returns false if the type is not atomic.
+ */
+bool
+ParseAtomic (const std::string& type, Eip712Type::Atomic& base,
+             unsigned& size)
+{
+  size = 0;
+  if (type == "bool")
+    {
+      base = Eip712Type::Atomic::BOOL;
+      return true;
+    }
+  if (type == "address")
+    {
+      base = Eip712Type::Atomic::ADDRESS;
+      return true;
+    }
+
+  const int bytes = TypeSuffix (type, "bytes");
+  if (bytes >= 1 && bytes <= 32)
+    {
+      base = Eip712Type::Atomic::FIXED_BYTES;
+      size = bytes;
+      return true;
+    }
+
+  for (const auto atomic : {Eip712Type::Atomic::UINT, Eip712Type::Atomic::INT})
+    {
+      const int bits = TypeSuffix (
+          type, atomic == Eip712Type::Atomic::UINT ? "uint" : "int");
+      if (bits >= 8 && bits <= 256 && bits % 8 == 0)
+        {
+          base = atomic;
+          size = bits;
+          return true;
+        }
+    }
+
+  base = Eip712Type::Atomic::NONE;
+  return false;
+}
+
+/**
+ * Returns true if the given type name is an atomic type.
+ */
+bool
+IsAtomic (const std::string& type)
+{
+  Eip712Type::Atomic base;
+  unsigned size;
+  return ParseAtomic (type, base, size);
+}
+
+/**
+ * Strips all array suffixes ("[]" or "[n]") from a type name.
+ */
+std::string
+BaseType (const std::string& type)
+{
+  return type.substr (0, type.find ('['));
+}
+
+} // anonymous namespace
+
+/* ************************************************************************** */
+
+void
+Eip712Schema::CollectReferenced (
+    const Eip712Type& type,
+    std::map<std::string, const Eip712Type*>& out) const
+{
+  for (const auto& m : type.members)
+    {
+      const auto mit = types.find (BaseType (m.type));
+      if (mit == types.end () || out.count (mit->first) > 0)
+        continue;
+
+      out.emplace (mit->first, mit->second.get ());
+      CollectReferenced (*mit->second, out);
+    }
+}
+
+const Eip712Type&
+Eip712Schema::AddType (const std::string& name,
+                       const std::vector<Eip712Type::Member>& members)
+{
+  CHECK_EQ (types.count (name), 0) << "Type already defined: " << name;
+  CHECK (!name.empty () && !IsAtomic (name)
+            && name != "bytes" && name != "string")
+      << "Invalid struct type name: " << name;
+
+  std::unique_ptr<Eip712Type> type(new Eip712Type ());
+  type->name = name;
+  type->members = members;
+
+  for (const auto& m : members)
+    {
+      CHECK (!m.name.empty ()) << "Missing member name in " << name;
+
+      Eip712Type::Atomic atomic = Eip712Type::Atomic::NONE;
+      unsigned size = 0;
+      if (m.type.find ('[') != std::string::npos)
+        {
+          CHECK_EQ (m.type.back (), ']') << "Invalid array type: " << m.type;
+          type->kinds.push_back (Eip712Type::Kind::ARRAY);
+        }
+      else if (m.type == "bytes" || m.type == "string")
+        type->kinds.push_back (Eip712Type::Kind::DYNAMIC);
+      else if (ParseAtomic (m.type, atomic, size))
+        type->kinds.push_back (Eip712Type::Kind::ATOMIC);
+      else
+        type->kinds.push_back (Eip712Type::Kind::STRUCT);
+      type->atomics.push_back (atomic);
+      type->sizes.push_back (size);
+
+      const std::string base = BaseType (m.type);
+      CHECK (IsAtomic (base) || base == "bytes" || base == "string"
+                || types.count (base) > 0)
+          << "Unknown member type " << m.type << " in " << name;
+    }
+
+  /* The encodeType of a struct is its own definition followed by the
+     definitions of all referenced structs, sorted by name.  */
+  const auto encodeSingle = [] (const Eip712Type& t)
+    {
+      std::string res = t.name + "(";
+      for (size_t i = 0; i < t.members.size (); ++i)
+        {
+          if (i > 0)
+            res += ',';
+          res += t.members[i].type + " " + t.members[i].name;
+        }
+      return res + ")";
+    };
+
+  std::map<std::string, const Eip712Type*> referenced;
+  CollectReferenced (*type, referenced);
+
+  type->encodedType = encodeSingle (*type);
+  for (const auto& entry : referenced)
+    type->encodedType += encodeSingle (*entry.second);
+  type->typeHash = Keccak256 (type->encodedType);
+
+  const Eip712Type& res = *type;
+  types.emplace (name, std::move (type));
+
+  return res;
+}
+
+const Eip712Type&
+Eip712Schema::Get (const std::string& name) const
+{
+  const auto mit = types.find (name);
+  CHECK (mit != types.end ()) << "Undefined type: " << name;
+  return *mit->second;
+}
+
+/* ************************************************************************** */
+
+void
+Eip712Hasher::Begin (const Eip712Type& t)
+{
+  type = &t;
+  next = 0;
+
+  buf.clear ();
+  buf.reserve (32 * (1 + t.GetMembers ().size ()));
+  buf.append (t.GetTypeHash ());
+}
+
+size_t
+Eip712Hasher::NextMember (const Eip712Type::Kind kind)
+{
+  CHECK (type != nullptr) << "No struct is being encoded";
+  CHECK_LT (next, type->GetMembers ().size ())
+      << "Too many members written for " << type->GetName ();
+
+  const bool ok = (type->GetKind (next) == kind)
+      || (kind == Eip712Type::Kind::STRUCT
+            && type->GetKind (next) == Eip712Type::Kind::ARRAY);
+  CHECK (ok)
+      << "Member " << type->GetMembers ()[next].name
+      << " of " << type->GetName () << " has type "
+      << type->GetMembers ()[next].type;
+
+  return next++;
+}
+
+unsigned
+Eip712Hasher::NextAtomic (const Eip712Type::Atomic base)
+{
+  const size_t i = NextMember (Eip712Type::Kind::ATOMIC);
+  CHECK (type->GetAtomic (i) == base)
+      << "Member " << type->GetMembers ()[i].name
+      << " of " << type->GetName () << " has type "
+      << type->GetMembers ()[i].type;
+
+  return type->GetSize (i);
+}
+
+void
+Eip712Hasher::AppendWord (const unsigned char* word)
+{
+  buf.append (reinterpret_cast<const char*> (word), 32);
+}
+
+void
+Eip712Hasher::WriteWord (const std::string& word)
+{
+  CHECK_EQ (word.size (), 32) << "Words must be 32 bytes";
+  NextMember (Eip712Type::Kind::ATOMIC);
+  AppendWord (UChar (word));
+}
+
+void
+Eip712Hasher::WriteUint (const uint64_t val)
+{
+  const unsigned bits = NextAtomic (Eip712Type::Atomic::UINT);
+  CHECK (bits >= 64 || (val >> bits) == 0)
+      << "Value out of range for uint" << bits << ": " << val;
+
+  unsigned char word[32] = {};
+  for (unsigned i = 0; i < 8; ++i)
+    word[31 - i] = static_cast<unsigned char> (val >> (8 * i));
+  AppendWord (word);
+}
+
+void
+Eip712Hasher::WriteInt (const int64_t val)
+{
+  const unsigned bits = NextAtomic (Eip712Type::Atomic::INT);
+  if (bits < 64)
+    {
+      const int64_t limit = int64_t (1) << (bits - 1);
+      CHECK (val >= -limit && val < limit)
+          << "Value out of range for int" << bits << ": " << val;
+    }
+
+  /* Negative numbers are sign-extended (two's complement) to 256 bits.  */
+  const uint64_t raw = static_cast<uint64_t> (val);
+  unsigned char word[32];
+  std::fill (word, word + 24, val < 0 ? 0xFF : 0x00);
+  for (unsigned i = 0; i < 8; ++i)
+    word[31 - i] = static_cast<unsigned char> (raw >> (8 * i));
+  AppendWord (word);
+}
+
+void
+Eip712Hasher::WriteBool (const bool val)
+{
+  NextAtomic (Eip712Type::Atomic::BOOL);
+
+  unsigned char word[32] = {};
+  word[31] = val ? 1 : 0;
+  AppendWord (word);
+}
+
+void
+Eip712Hasher::WriteAddress (const Address& addr)
+{
+  NextAtomic (Eip712Type::Atomic::ADDRESS);
+
+  const auto& bin = addr.GetBinary ();
+  unsigned char word[32] = {};
+  std::copy (bin.begin (), bin.end (), word + 32 - bin.size ());
+  AppendWord (word);
+}
+
+void
+Eip712Hasher::WriteFixedBytes (const std::string& data)
+{
+  const unsigned size = NextAtomic (Eip712Type::Atomic::FIXED_BYTES);
+  CHECK_EQ (data.size (), size)
+      << "Invalid data size for bytes" << size;
+
+  /* bytesN values are left-aligned and padded with zeros on the right.  */
+  unsigned char word[32] = {};
+  std::copy (data.begin (), data.end (), word);
+  AppendWord (word);
+}
+
+void
+Eip712Hasher::WriteBytes (const std::string& data)
+{
+  NextMember (Eip712Type::Kind::DYNAMIC);
+
+  const size_t pos = buf.size ();
+  buf.resize (pos + 32);
+  Keccak256 (UChar (data), data.size (),
+             reinterpret_cast<unsigned char*> (&buf[pos]));
+}
+
+void
+Eip712Hasher::WriteHash (const std::string& hash)
+{
+  CHECK_EQ (hash.size (), 32) << "Hashes must be 32 bytes";
+  NextMember (Eip712Type::Kind::STRUCT);
+  AppendWord (UChar (hash));
+}
+
+std::string
+Eip712Hasher::Finish ()
+{
+  CHECK (type != nullptr) << "No struct is being encoded";
+  CHECK_EQ (next, type->GetMembers ().size ())
+      << "Not all members written for " << type->GetName ();
+  type = nullptr;
+
+  return Keccak256 (buf);
+}
+
+/* ************************************************************************** */
+
+Eip712Domain::Eip712Domain (const std::string& name,
+                            const std::string& version,
+                            const uint64_t chainId,
+                            const Address& verifyingContract)
+{
+  static const Eip712Schema* schema = [] ()
+    {
+      auto* res = new Eip712Schema ();
+      res->AddType ("EIP712Domain",
+        {
+          {"string", "name"},
+          {"string", "version"},
+          {"uint256", "chainId"},
+          {"address", "verifyingContract"},
+        });
+      return res;
+    } ();
+
+  Eip712Hasher hasher;
+  hasher.Begin (schema->Get ("EIP712Domain"));
+  hasher.WriteBytes (name);
+  hasher.WriteBytes (version);
+  hasher.WriteUint (chainId);
+  hasher.WriteAddress (verifyingContract);
+  separator = hasher.Finish ();
+}
+
+Eip712Domain::Eip712Domain (const std::string& sep)
+  : separator(sep)
+{
+  CHECK_EQ (separator.size (), 32) << "Domain separator must be 32 bytes";
+}
+
+std::string
+Eip712Domain::GetDigest (const std::string& structHash) const
+{
+  CHECK_EQ (structHash.size (), 32) << "Struct hash must be 32 bytes";
+
+  std::string data;
+  data.reserve (2 + 32 + 32);
+  data.append ("\x19\x01").append (separator).append (structHash);
+
+  return Keccak256 (data);
+}
+
+std::string
+Eip712Domain::Sign (const ECDSA& ec, const ECDSA::Key& key,
+                    const std::string& structHash) const
+{
+  return ec.SignHash (GetDigest (structHash), key);
+}
+
+Address
+Eip712Domain::Verify (const ECDSA& ec, const std::string& structHash,
+                      const std::string& sgnBin, const bool allowCompact) const
+{
+  return ec.VerifyHash (GetDigest (structHash), sgnBin, allowCompact);
+}
+
+} // namespace ethutils
@@ -0,0 +1,374 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ETHUTILS_EIP712_HPP
+#define ETHUTILS_EIP712_HPP
+
+#include "address.hpp"
+#include "ecdsa.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ethutils
+{
+
+/**
+ * A struct type for EIP-712 typed-data hashing.  Its encodeType string and
+ * type hash are computed once when the type is defined (as part of an
+ * Eip712Schema), so that hashing many instances of it does not need to
+ * re-derive them.
+ */
+class Eip712Type
+{
+
+public:
+
+  /**
+   * A member of the struct.
+   */
+  struct Member
+  {
+
+    /** The member's type, e.g. "uint256", "string" or "Person[]".  */
+    std::string type;
+
+    /** The member's name.  */
+    std::string name;
+
+  };
+
+  /**
+   * The ways in which members are encoded in hashStruct.
+   */
+  enum class Kind
+  {
+
+    /** Atomic types (uintN, intN, address, bool, bytesN) as 32-byte word.  */
+    ATOMIC,
+
+    /** Dynamic "bytes" and "string", encoded as their Keccak hash.  */
+    DYNAMIC,
+
+    /** Nested structs, encoded as their hashStruct.  */
+    STRUCT,
+
+    /** Arrays, encoded as Keccak hash of the concatenated elements.  */
+    ARRAY,
+
+  };
+
+  /**
+   * The base types of atomic members.
+   */
+  enum class Atomic
+  {
+
+    /** The member is not atomic.  */
+    NONE,
+
+    UINT,
+    INT,
+    ADDRESS,
+    BOOL,
+
+    /** bytesN with 1 <= N <= 32.  */
+    FIXED_BYTES,
+
+  };
+
+private:
+
+  /** The name of the struct type.  */
+  std::string name;
+
+  /** The members of the struct.  */
+  std::vector<Member> members;
+
+  /** The encoding kinds of each member.  */
+  std::vector<Kind> kinds;
+
+  /** The atomic base types of each member (NONE for non-atomic ones).  */
+  std::vector<Atomic> atomics;
+
+  /**
+   * The size parameter of each atomic member.  This is the number of bits
+   * for integers and the number of bytes for bytesN, and zero otherwise.
+   */
+  std::vector<unsigned> sizes;
+
+  /** The full encodeType string (including referenced types).  */
+  std::string encodedType;
+
+  /** The 32-byte type hash.  */
+  std::string typeHash;
+
+  Eip712Type () = default;
+
+  friend class Eip712Schema;
+
+public:
+
+  Eip712Type (const Eip712Type&) = delete;
+  void operator= (const Eip712Type&) = delete;
+
+  const std::string&
+  GetName () const
+  {
+    return name;
+  }
+
+  const std::vector<Member>&
+  GetMembers () const
+  {
+    return members;
+  }
+
+  Kind
+  GetKind (const size_t i) const
+  {
+    return kinds[i];
+  }
+
+  Atomic
+  GetAtomic (const size_t i) const
+  {
+    return atomics[i];
+  }
+
+  unsigned
+  GetSize (const size_t i) const
+  {
+    return sizes[i];
+  }
+
+  /**
+   * Returns the encodeType string, e.g.
+   * "Mail(Person from,Person to,string contents)Person(string name,...)".
+   */
+  const std::string&
+  GetEncodedType () const
+  {
+    return encodedType;
+  }
+
+  /**
+   * Returns the 32-byte type hash (Keccak of the encodeType string).
+   */
+  const std::string&
+  GetTypeHash () const
+  {
+    return typeHash;
+  }
+
+};
+
+/**
+ * A set of EIP-712 struct types that can reference each other.
+ */
+class Eip712Schema
+{
+
+private:
+
+  /** The types defined, by name.  */
+  std::map<std::string, std::unique_ptr<Eip712Type>> types;
+
+  /**
+   * Collects the names of all struct types referenced by the given
+   * type (directly or indirectly), not including the type itself.
+   */
+  void CollectReferenced (const Eip712Type& type,
+                          std::map<std::string, const Eip712Type*>& out) const;
+
+public:
+
+  Eip712Schema () = default;
+
+  Eip712Schema (const Eip712Schema&) = delete;
+  void operator= (const Eip712Schema&) = delete;
+
+  /**
+   * Defines a new struct type.  All struct types referenced by its members
+   * must have been defined already.  CHECK-fails if the type is invalid
+   * or already defined.
+   */
+  const Eip712Type& AddType (const std::string& name,
+                             const std::vector<Eip712Type::Member>& members);
+
+  /**
+   * Returns a type by name.  CHECK-fails if it is not defined.
+   */
+  const Eip712Type& Get (const std::string& name) const;
+
+};
+
+/**
+ * Helper for computing hashStruct of struct values.  Members are written
+ * in order with the Write* methods, and then Finish returns the hash.
+ * The encoding buffer is reused between structs, so that hashing many
+ * values does not allocate per member.
+ *
+ * Nested structs and arrays have to be hashed beforehand, and their hashes
+ * are then written with WriteHash.
+ */
+class Eip712Hasher
+{
+
+private:
+
+  /** The buffer with encodeData of the current struct.  */
+  std::string buf;
+
+  /** The type currently being encoded, or null if none.  */
+  const Eip712Type* type = nullptr;
+
+  /** The index of the next member to write.  */
+  size_t next = 0;
+
+  /**
+   * Checks that the next member has the given kind, and advances
+   * to the following member.  Returns the index of the checked member.
+   */
+  size_t NextMember (Eip712Type::Kind kind);
+
+  /**
+   * Checks that the next member is atomic with the given base type,
+   * and advances to the following member.  Returns its size parameter.
+   */
+  unsigned NextAtomic (Eip712Type::Atomic base);
+
+  /**
+   * Appends a 32-byte word to the buffer.
+   */
+  void AppendWord (const unsigned char* word);
+
+public:
+
+  Eip712Hasher () = default;
+
+  Eip712Hasher (const Eip712Hasher&) = delete;
+  void operator= (const Eip712Hasher&) = delete;
+
+  /**
+   * Starts encoding a value of the given type.
+   */
+  void Begin (const Eip712Type& t);
+
+  /**
+   * Writes an atomic member of any type as raw 32-byte word (already
+   * padded as needed).  This can be used for integers wider than 64 bits.
+   */
+  void WriteWord (const std::string& word);
+
+  /**
+   * Writes a uintN member.  CHECK-fails if the value does not fit N bits.
+   */
+  void WriteUint (uint64_t val);
+
+  /**
+   * Writes an intN member.  CHECK-fails if the value does not fit N bits.
+   */
+  void WriteInt (int64_t val);
+
+  /**
+   * Writes a bool member.
+   */
+  void WriteBool (bool val);
+
+  /**
+   * Writes an address member.  The address must be valid.
+   */
+  void WriteAddress (const Address& addr);
+
+  /**
+   * Writes a bytesN member.  The data must be exactly N bytes long.
+   */
+  void WriteFixedBytes (const std::string& data);
+
+  /**
+   * Writes a "bytes" or "string" member.  The data is hashed directly
+   * into the encoding buffer.
+   */
+  void WriteBytes (const std::string& data);
+
+  /**
+   * Writes a struct or array member by its precomputed 32-byte hash.
+   */
+  void WriteHash (const std::string& hash);
+
+  /**
+   * Finishes encoding the current value, and returns its 32-byte hashStruct.
+   * All members must have been written.
+   */
+  std::string Finish ();
+
+};
+
+/**
+ * An EIP-712 domain, with its domain separator precomputed.  It can be
+ * used to sign and verify struct hashes in that domain.
+ */
+class Eip712Domain
+{
+
+private:
+
+  /** The 32-byte domain separator.  */
+  std::string separator;
+
+public:
+
+  /**
+   * Constructs the domain with the common fields name, version, chainId and
+   * verifyingContract (as defined by the "EIP712Domain" struct with these
+   * four members).
+   */
+  explicit Eip712Domain (const std::string& name, const std::string& version,
+                         uint64_t chainId, const Address& verifyingContract);
+
+  /**
+   * Constructs the domain from a precomputed 32-byte separator.  This can
+   * be used for domains with a different set of fields, whose separator
+   * is computed with an Eip712Schema and Eip712Hasher.
+   */
+  explicit Eip712Domain (const std::string& sep);
+
+  const std::string&
+  GetSeparator () const
+  {
+    return separator;
+  }
+
+  /**
+   * Returns the 32-byte digest that is signed for a struct with the given
+   * hashStruct in this domain.
+   */
+  std::string GetDigest (const std::string& structHash) const;
+
+  /**
+   * Signs a struct with the given hashStruct.  Returns the signature
+   * as raw 65-byte binary string.
+   */
+  std::string Sign (const ECDSA& ec, const ECDSA::Key& key,
+                    const std::string& structHash) const;
+
+  /**
+   * Recovers the signer of a struct with the given hashStruct and
+   * raw 65-byte signature (or 64-byte EIP-2098 compact signature if
+   * allowCompact is set).  Returns an invalid address if the signature
+   * is invalid.
+   */
+  Address Verify (const ECDSA& ec, const std::string& structHash,
+                  const std::string& sgnBin, bool allowCompact = false) const;
+
+};
+
+} // namespace ethutils
+
+#endif // ETHUTILS_EIP712_HPP
@@ -0,0 +1,278 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "eip712.hpp"
+
+#include "hexutils.hpp"
+#include "keccak.hpp"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+
+namespace ethutils
+{
+namespace
+{
+
+/**
+ * Tests based on the "Mail" example from the EIP-712 specification.
+ */
+class Eip712Tests : public testing::Test
+{
+
+protected:
+
+  Eip712Schema schema;
+  const Eip712Type* person;
+  const Eip712Type* mail;
+
+  Eip712Hasher hasher;
+
+  Eip712Tests ()
+  {
+    person = &schema.AddType ("Person",
+      {
+        {"string", "name"},
+        {"address", "wallet"},
+      });
+    mail = &schema.AddType ("Mail",
+      {
+        {"Person", "from"},
+        {"Person", "to"},
+        {"string", "contents"},
+      });
+  }
+
+  /**
+   * Computes hashStruct for a Person.
+   */
+  std::string
+  HashPerson (const std::string& name, const std::string& wallet)
+  {
+    hasher.Begin (*person);
+    hasher.WriteBytes (name);
+    hasher.WriteAddress (Address (wallet));
+    return hasher.Finish ();
+  }
+
+  /**
+   * Returns the hash of the example mail.
+   */
+  std::string
+  HashExampleMail ()
+  {
+    const std::string from = HashPerson (
+        "Cow", "0xCD2a3d9F938E13CD947Ec05AbC7FE734Df8DD826");
+    const std::string to = HashPerson (
+        "Bob", "0xbBbBBBBbbBBBbbbBbbBbbbbBBbBbbbbBbBbbBBbB");
+
+    hasher.Begin (*mail);
+    hasher.WriteHash (from);
+    hasher.WriteHash (to);
+    hasher.WriteBytes ("Hello, Bob!");
+    return hasher.Finish ();
+  }
+
+  static Eip712Domain
+  ExampleDomain ()
+  {
+    return Eip712Domain ("Ether Mail", "1", 1,
+        Address ("0xCcCCccccCCCCcCCCCCCcCcCccCcCCCcCcccccccC"));
+  }
+
+  static std::string
+  HexHash (const std::string& hash)
+  {
+    return "0x" + Hexlify (hash);
+  }
+
+};
+
+TEST_F (Eip712Tests, EncodeType)
+{
+  EXPECT_EQ (person->GetEncodedType (), "Person(string name,address wallet)");
+  EXPECT_EQ (mail->GetEncodedType (),
+             "Mail(Person from,Person to,string contents)"
+             "Person(string name,address wallet)");
+  EXPECT_EQ (HexHash (mail->GetTypeHash ()),
+      "0xa0cedeb2dc280ba39b857546d74f5549c3a1d7bdc2dd96bf881f76108e23dac2");
+  EXPECT_EQ (&schema.Get ("Mail"), mail);
+}
+
+TEST_F (Eip712Tests, ReferencedTypesSorted)
+{
+  schema.AddType ("Zeta", {{"uint8", "z"}});
+  schema.AddType ("Alpha", {{"Zeta[]", "zs"}, {"bytes32", "x"}});
+  const auto& t = schema.AddType ("Top",
+    {
+      {"Zeta", "a"},
+      {"Alpha", "b"},
+      {"Mail[2]", "mails"},
+    });
+
+  EXPECT_EQ (t.GetEncodedType (),
+             "Top(Zeta a,Alpha b,Mail[2] mails)"
+             "Alpha(Zeta[] zs,bytes32 x)"
+             "Mail(Person from,Person to,string contents)"
+             "Person(string name,address wallet)"
+             "Zeta(uint8 z)");
+  EXPECT_EQ (t.GetKind (0), Eip712Type::Kind::STRUCT);
+  EXPECT_EQ (t.GetKind (2), Eip712Type::Kind::ARRAY);
+}
+
+TEST_F (Eip712Tests, InvalidTypes)
+{
+  EXPECT_DEATH (schema.AddType ("Person", {}), "already defined");
+  EXPECT_DEATH (schema.AddType ("Foo", {{"Bar", "x"}}), "Unknown member");
+  EXPECT_DEATH (schema.AddType ("Foo", {{"uint7", "x"}}), "Unknown member");
+  EXPECT_DEATH (schema.AddType ("Foo", {{"bytes33", "x"}}), "Unknown member");
+  EXPECT_DEATH (schema.AddType ("uint256", {}), "Invalid struct type");
+  EXPECT_DEATH (schema.Get ("Foo"), "Undefined type");
+}
+
+TEST_F (Eip712Tests, ExampleHashes)
+{
+  EXPECT_EQ (HexHash (ExampleDomain ().GetSeparator ()),
+      "0xf2cee375fa42b42143804025fc449deafd50cc031ca257e0b194a650a912090f");
+  EXPECT_EQ (HexHash (HashExampleMail ()),
+      "0xc52c0ee5d84264471806290a3f2c4cecfc5490626bf912d01f240d7a274b371e");
+  EXPECT_EQ (HexHash (ExampleDomain ().GetDigest (HashExampleMail ())),
+      "0xbe609aee343fb3c4b28e1df9e632fca64fcfaede20f02e86244efddf30957bd2");
+}
+
+TEST_F (Eip712Tests, HasherChecks)
+{
+  hasher.Begin (*person);
+  EXPECT_DEATH (hasher.WriteUint (42), "has type string");
+  EXPECT_DEATH (hasher.Finish (), "Not all members");
+  hasher.WriteBytes ("Cow");
+  EXPECT_DEATH (hasher.WriteBytes ("foo"), "has type address");
+  EXPECT_DEATH (hasher.WriteUint (42), "has type address");
+  hasher.WriteAddress (Address ("0xbBbBBBBbbBBBbbbBbbBbbbbBBbBbbbbBbBbbBBbB"));
+  EXPECT_DEATH (hasher.WriteUint (42), "Too many members");
+  hasher.Finish ();
+
+  EXPECT_DEATH (hasher.WriteUint (1), "No struct");
+}
+
+TEST_F (Eip712Tests, IntegerEncoding)
+{
+  const auto& t = schema.AddType ("Ints",
+    {
+      {"uint64", "a"},
+      {"int256", "b"},
+      {"bool", "c"},
+      {"bytes32", "d"},
+    });
+
+  const std::string word(32, '\xAB');
+  hasher.Begin (t);
+  hasher.WriteUint (0x0102);
+  hasher.WriteInt (-2);
+  hasher.WriteBool (true);
+  hasher.WriteWord (word);
+
+  std::string expected = t.GetTypeHash ();
+  expected += std::string (30, '\0') + "\x01\x02";
+  expected += std::string (31, '\xFF') + "\xFE";
+  expected += std::string (31, '\0') + "\x01";
+  expected += word;
+
+  EXPECT_EQ (hasher.Finish (), Keccak256 (expected));
+}
+
+TEST_F (Eip712Tests, AtomicTypeChecks)
+{
+  const auto& t = schema.AddType ("Atomics",
+    {
+      {"uint8", "u8"},
+      {"int16", "i16"},
+      {"uint256", "u256"},
+      {"int64", "i64"},
+      {"address", "addr"},
+      {"bytes32", "b32"},
+      {"bool", "flag"},
+      {"bytes3", "b3"},
+    });
+  const Address addr("0xbBbBBBBbbBBBbbbBbbBbbbbBBbBbbbbBbBbbBBbB");
+
+  hasher.Begin (t);
+  EXPECT_DEATH (hasher.WriteUint (256), "out of range for uint8");
+  EXPECT_DEATH (hasher.WriteInt (1), "has type uint8");
+  hasher.WriteUint (255);
+
+  EXPECT_DEATH (hasher.WriteInt (32768), "out of range for int16");
+  EXPECT_DEATH (hasher.WriteInt (-32769), "out of range for int16");
+  EXPECT_DEATH (hasher.WriteUint (1), "has type int16");
+  hasher.WriteInt (-32768);
+
+  EXPECT_DEATH (hasher.WriteInt (-1), "has type uint256");
+  hasher.WriteUint (std::numeric_limits<uint64_t>::max ());
+
+  hasher.WriteInt (std::numeric_limits<int64_t>::min ());
+
+  EXPECT_DEATH (hasher.WriteUint (1), "has type address");
+  hasher.WriteAddress (addr);
+
+  EXPECT_DEATH (hasher.WriteUint (1), "has type bytes32");
+  EXPECT_DEATH (hasher.WriteBool (true), "has type bytes32");
+  hasher.WriteWord (std::string (32, '\xAB'));
+
+  EXPECT_DEATH (hasher.WriteUint (1), "has type bool");
+  EXPECT_DEATH (hasher.WriteAddress (addr), "has type bool");
+  hasher.WriteBool (false);
+
+  EXPECT_DEATH (hasher.WriteFixedBytes ("ab"), "Invalid data size for bytes3");
+  hasher.WriteFixedBytes ("abc");
+
+  std::string expected = t.GetTypeHash ();
+  expected += std::string (31, '\0') + "\xFF";
+  expected += std::string (30, '\xFF') + std::string ("\x80\x00", 2);
+  expected += std::string (24, '\0') + std::string (8, '\xFF');
+  expected += std::string (24, '\xFF') + "\x80" + std::string (7, '\0');
+  expected += std::string (12, '\0')
+                + std::string (addr.GetBinary ().begin (),
+                               addr.GetBinary ().end ());
+  expected += std::string (32, '\xAB');
+  expected += std::string (32, '\0');
+  expected += "abc" + std::string (29, '\0');
+
+  EXPECT_EQ (hasher.Finish (), Keccak256 (expected));
+}
+
+TEST_F (Eip712Tests, SignAndVerify)
+{
+  ECDSA ec;
+  const auto key = ec.SecretKey (Keccak256 ("cow"));
+  ASSERT_TRUE (key);
+  EXPECT_EQ (key.GetAddress (),
+             Address ("0xCD2a3d9F938E13CD947Ec05AbC7FE734Df8DD826"));
+
+  const auto domain = ExampleDomain ();
+  const std::string hash = HashExampleMail ();
+  const std::string sgn = domain.Sign (ec, key, hash);
+  EXPECT_EQ ("0x" + Hexlify (sgn), "0x"
+      "4355c47d63924e8a72e509b65029052eb6c299d53a04e167c5775fd466751c9d"
+      "07299936d304c153f6443dfa05f40ff007d72911b6f72307f996231605b91562"
+      "1c");
+
+  EXPECT_EQ (domain.Verify (ec, hash, sgn), key.GetAddress ());
+
+  const Eip712Domain other("Ether Mail", "2", 1,
+      Address ("0xCcCCccccCCCCcCCCCCCcCcCccCcCCCcCcccccccC"));
+  EXPECT_NE (other.Verify (ec, hash, sgn), key.GetAddress ());
+
+  const Eip712Domain fromSeparator(domain.GetSeparator ());
+  EXPECT_EQ (fromSeparator.Verify (ec, hash, sgn), key.GetAddress ());
+
+  /* EIP-2098 compact signatures are only accepted if enabled.  */
+  const std::string compact = ECDSA::CompactSignature (sgn);
+  ASSERT_EQ (compact.size (), 64);
+  EXPECT_FALSE (domain.Verify (ec, hash, compact));
+  EXPECT_EQ (domain.Verify (ec, hash, compact, true), key.GetAddress ());
+}
+
+} // anonymous namespace
+} // namespace ethutils
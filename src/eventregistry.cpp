@@ -0,0 +1,284 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "eventregistry.hpp"
+
+#include "keccak.hpp"
+#include "parallel.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace ethutils
+{
+
+namespace
+{
+
+/**
+ * Strips spaces from both ends of a string.
+ */
+std::string_view
+Trim (std::string_view str)
+{
+  while (!str.empty () && str.front () == ' ')
+    str.remove_prefix (1);
+  while (!str.empty () && str.back () == ' ')
+    str.remove_suffix (1);
+  return str;
+}
+
+/**
+ * Splits a parameter list at the commas that are not inside a tuple type.
+ */
+std::vector<std::string_view>
+SplitParams (const std::string_view str)
+{
+  std::vector<std::string_view> res;
+  if (Trim (str).empty ())
+    return res;
+
+  int depth = 0;
+  size_t start = 0;
+  for (size_t i = 0; i < str.size (); ++i)
+    switch (str[i])
+      {
+      case '(':
+        ++depth;
+        break;
+      case ')':
+        --depth;
+        break;
+      case ',':
+        if (depth == 0)
+          {
+            res.push_back (Trim (str.substr (start, i - start)));
+            start = i + 1;
+          }
+        break;
+      default:
+        break;
+      }
+  res.push_back (Trim (str.substr (start)));
+
+  return res;
+}
+
+/**
+ * Splits a parameter declaration into its space-separated words.
+ */
+std::vector<std::string_view>
+SplitWords (std::string_view str)
+{
+  std::vector<std::string_view> res;
+  while (true)
+    {
+      str = Trim (str);
+      if (str.empty ())
+        return res;
+
+      const size_t end = std::min (str.find (' '), str.size ());
+      res.push_back (str.substr (0, end));
+      str.remove_prefix (end);
+    }
+}
+
+} // anonymous namespace
+
+size_t
+EventRegistry::RegisterInternal (const std::string& declaration, Key key)
+{
+  const size_t open = declaration.find ('(');
+  CHECK (open != std::string::npos && open > 0 && declaration.back () == ')')
+      << "Invalid event declaration: " << declaration;
+  const std::string_view decl(declaration);
+  const std::string_view name = decl.substr (0, open);
+  const std::string_view params
+      = decl.substr (open + 1, decl.size () - open - 2);
+
+  EventType ev;
+  ev.signature = std::string (name) + "(";
+  ev.numIndexed = 0;
+  std::string dataType = "(";
+
+  bool first = true;
+  bool firstData = true;
+  for (const auto param : SplitParams (params))
+    {
+      const auto words = SplitWords (param);
+      CHECK (!words.empty () && words.size () <= 3)
+          << "Invalid event parameter '" << param << "' in " << declaration;
+
+      AbiType type;
+      CHECK (AbiType::Parse (words[0], type))
+          << "Invalid type '" << words[0] << "' in " << declaration;
+      const bool indexed = (words.size () >= 2 && words[1] == "indexed");
+      CHECK (words.size () < 3 || indexed)
+          << "Invalid event parameter '" << param << "' in " << declaration;
+
+      const std::string canonical = type.ToString ();
+      if (!first)
+        ev.signature += ",";
+      ev.signature += canonical;
+      first = false;
+
+      if (indexed)
+        ++ev.numIndexed;
+      else
+        {
+          if (!firstData)
+            dataType += ",";
+          dataType += canonical;
+          firstData = false;
+        }
+    }
+  ev.signature += ")";
+  dataType += ")";
+
+  ev.topic0 = Keccak256 (ev.signature);
+  CHECK_EQ (ev.topic0.size (), key.topic0.size ());
+  std::memcpy (key.topic0.data (), ev.topic0.data (), key.topic0.size ());
+
+  AbiType data;
+  CHECK (AbiType::Parse (dataType, data));
+  ev.plan = std::make_unique<AbiDecodePlan> (data);
+
+  key.id = events.size ();
+  const auto pos = std::lower_bound (table.begin (), table.end (), key);
+  CHECK (pos == table.end () || key < *pos)
+      << "Event " << ev.signature << " is already registered";
+
+  table.insert (pos, key);
+  events.push_back (std::move (ev));
+
+  return key.id;
+}
+
+size_t
+EventRegistry::Register (const std::string& declaration)
+{
+  Key key;
+  key.anyContract = true;
+  key.contract = {};
+
+  return RegisterInternal (declaration, std::move (key));
+}
+
+size_t
+EventRegistry::Register (const std::string& declaration,
+                         const Address& contract)
+{
+  Key key;
+  key.anyContract = false;
+  key.contract = contract.GetBinary ();
+
+  return RegisterInternal (declaration, std::move (key));
+}
+
+const std::string&
+EventRegistry::GetSignature (const size_t id) const
+{
+  CHECK_LT (id, events.size ());
+  return events[id].signature;
+}
+
+const std::string&
+EventRegistry::GetTopic0 (const size_t id) const
+{
+  CHECK_LT (id, events.size ());
+  return events[id].topic0;
+}
+
+size_t
+EventRegistry::Lookup (const std::string_view topic0,
+                       const Address::Binary& contract) const
+{
+  Key probe;
+  if (topic0.size () != probe.topic0.size ())
+    return NOT_FOUND;
+  std::memcpy (probe.topic0.data (), topic0.data (), probe.topic0.size ());
+
+  /* First look for an entry for the specific contract, and then for
+     one that matches any contract.  */
+
+  probe.anyContract = false;
+  probe.contract = contract;
+  auto it = std::lower_bound (table.begin (), table.end (), probe);
+  if (it != table.end () && it->topic0 == probe.topic0 && !it->anyContract
+        && it->contract == contract)
+    return it->id;
+
+  probe.anyContract = true;
+  probe.contract = {};
+  it = std::lower_bound (it, table.end (), probe);
+  if (it != table.end () && it->topic0 == probe.topic0 && it->anyContract)
+    return it->id;
+
+  return NOT_FOUND;
+}
+
+bool
+EventRegistry::Decode (const Log& log, size_t& id, Event& out) const
+{
+  id = NOT_FOUND;
+  if (log.topics.empty ())
+    return false;
+
+  id = Lookup (log.topics[0], log.address);
+  if (id == NOT_FOUND)
+    return false;
+
+  const EventType& ev = events[id];
+  if (log.topics.size () != 1 + ev.numIndexed)
+    return false;
+
+  out.indexed.clear ();
+  for (size_t i = 1; i < log.topics.size (); ++i)
+    {
+      if (log.topics[i].size () != ev.topic0.size ())
+        return false;
+      out.indexed.emplace_back (log.topics[i]);
+    }
+
+  return ev.plan->Decode (log.data, out.data);
+}
+
+EventRegistry::BatchResult
+EventRegistry::DecodeBatch (const std::vector<Log>& logs,
+                            const unsigned threads) const
+{
+  const size_t n = logs.size ();
+  std::vector<size_t> ids(n);
+  std::vector<Event> decoded(n);
+  std::vector<char> ok(n);
+
+  ParallelFor (n, threads, [&] (const size_t begin, const size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+        ok[i] = Decode (logs[i], ids[i], decoded[i]);
+    });
+
+  /* Distributing the events by ID is cheap (they are only moved),
+     and done sequentially so that each list keeps the order of logs.  */
+  BatchResult res;
+  res.events.resize (events.size ());
+  for (size_t i = 0; i < n; ++i)
+    {
+      if (ids[i] == NOT_FOUND)
+        res.unmatched.push_back (i);
+      else if (!ok[i])
+        res.invalid.push_back (i);
+      else
+        {
+          decoded[i].log = i;
+          res.events[ids[i]].push_back (std::move (decoded[i]));
+        }
+    }
+
+  return res;
+}
+
+} // namespace ethutils
@@ -0,0 +1,239 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ETHUTILS_EVENTREGISTRY_HPP
+#define ETHUTILS_EVENTREGISTRY_HPP
+
+#include "abiplan.hpp"
+#include "address.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace ethutils
+{
+
+/**
+ * A registry of event types, which dispatches logs to the matching event
+ * based on their topic0 and contract address, and decodes them.  This is
+ * meant for indexers that process the mixed logs of many contracts.
+ *
+ * Events are registered with a declaration such as
+ * "Transfer(address indexed from, address indexed to, uint256 value)",
+ * either for any contract or for a specific one.  A registration for
+ * a specific contract takes precedence over one for any contract, so that
+ * events with the same signature but different indexing (like the ERC-20
+ * and ERC-721 Transfer events) can be told apart.  Anonymous events
+ * (without topic0) are not supported.
+ *
+ * Registering events is not thread-safe, but all decoding methods are
+ * const and can be used concurrently.
+ */
+class EventRegistry
+{
+
+public:
+
+  /** ID returned for logs that do not match any registered event.  */
+  static constexpr size_t NOT_FOUND = SIZE_MAX;
+
+  /** A log to decode, with all data in binary form.  */
+  struct Log
+  {
+
+    /** The contract that emitted the log.  */
+    Address::Binary address;
+
+    /** The topics (including topic0), each 32 bytes.  */
+    std::vector<std::string> topics;
+
+    /** The log's data.  */
+    std::string data;
+
+  };
+
+  /**
+   * A decoded event.  It references the data of the log it was decoded
+   * from, which must outlive it.
+   */
+  struct Event
+  {
+
+    /** The index of the log in the batch it was decoded from.  */
+    size_t log;
+
+    /**
+     * The topics of the indexed parameters, in order.  These are the raw
+     * 32-byte words, i.e. the values of value types, or the hashes of
+     * reference types.
+     */
+    std::vector<std::string_view> indexed;
+
+    /** The tuple of non-indexed parameters, decoded from the data.  */
+    AbiValue data;
+
+  };
+
+  /** The result of decoding a batch of logs.  */
+  struct BatchResult
+  {
+
+    /**
+     * The decoded events for each registered event ID, in the order of
+     * the logs.
+     */
+    std::vector<std::vector<Event>> events;
+
+    /** Indices of logs that did not match any registered event.  */
+    std::vector<size_t> unmatched;
+
+    /**
+     * Indices of logs that matched an event, but had the wrong number
+     * of topics or invalid data.
+     */
+    std::vector<size_t> invalid;
+
+  };
+
+private:
+
+  /** Data about a registered event.  */
+  struct EventType
+  {
+
+    /** The canonical signature, e.g. "Transfer(address,address,uint256)".  */
+    std::string signature;
+
+    /** The event's topic0 (hash of the signature).  */
+    std::string topic0;
+
+    /** The number of indexed parameters.  */
+    size_t numIndexed;
+
+    /** The decode plan for the tuple of non-indexed parameters.  */
+    std::unique_ptr<AbiDecodePlan> plan;
+
+  };
+
+  /** Type for topic0 in the dispatch table.  */
+  using Topic = std::array<unsigned char, 32>;
+
+  /** An entry of the dispatch table.  */
+  struct Key
+  {
+
+    /** The topic0 of the event.  */
+    Topic topic0;
+
+    /** Whether this entry matches logs from any contract.  */
+    bool anyContract;
+
+    /** The contract this entry matches, if not anyContract.  */
+    Address::Binary contract;
+
+    /** The ID of the event.  */
+    size_t id;
+
+    /**
+     * Orders keys by topic0, with contract-specific entries before
+     * the one for any contract.
+     */
+    friend bool
+    operator< (const Key& a, const Key& b)
+    {
+      return std::tie (a.topic0, a.anyContract, a.contract)
+                < std::tie (b.topic0, b.anyContract, b.contract);
+    }
+
+  };
+
+  /** All registered events, indexed by ID.  */
+  std::vector<EventType> events;
+
+  /** The dispatch table, sorted for lookups with binary search.  */
+  std::vector<Key> table;
+
+  /**
+   * Registers an event with the given dispatch key, whose topic0
+   * and ID fields are filled in by this method.
+   */
+  size_t RegisterInternal (const std::string& declaration, Key key);
+
+public:
+
+  EventRegistry () = default;
+
+  EventRegistry (const EventRegistry&) = delete;
+  void operator= (const EventRegistry&) = delete;
+
+  /**
+   * Registers an event for logs from any contract.  The declaration lists
+   * the parameters with their type (in canonical form, without spaces),
+   * an optional "indexed" keyword and an optional name.  Returns the ID
+   * of the new event, which is its index into BatchResult::events.
+   *
+   * CHECK-fails if the declaration is invalid, or if the same event
+   * has already been registered for any contract.
+   */
+  size_t Register (const std::string& declaration);
+
+  /**
+   * Registers an event only for logs from the given contract.
+   */
+  size_t Register (const std::string& declaration, const Address& contract);
+
+  /**
+   * Returns the number of registered events.
+   */
+  size_t
+  GetNumEvents () const
+  {
+    return events.size ();
+  }
+
+  /**
+   * Returns the canonical signature of a registered event.
+   */
+  const std::string& GetSignature (size_t id) const;
+
+  /**
+   * Returns the 32-byte topic0 of a registered event.
+   */
+  const std::string& GetTopic0 (size_t id) const;
+
+  /**
+   * Looks up the event for a given topic0 and contract, and returns
+   * its ID (or NOT_FOUND).
+   */
+  size_t Lookup (std::string_view topic0,
+                 const Address::Binary& contract) const;
+
+  /**
+   * Decodes a single log.  The ID of the matching event (or NOT_FOUND)
+   * is returned in id.  Returns true if the log matched and was decoded
+   * successfully.  The log field of out is not touched.
+   */
+  bool Decode (const Log& log, size_t& id, Event& out) const;
+
+  /**
+   * Decodes a batch of logs (e.g. all logs of a block).  The work is split
+   * across up to the given number of threads (zero means to use the
+   * hardware concurrency).  The work for each log is bounded by the size
+   * of its data (see AbiDecodePlan::Decode), so that crafted logs cannot
+   * hold up the threads.
+   */
+  BatchResult DecodeBatch (const std::vector<Log>& logs,
+                           unsigned threads = 0) const;
+
+};
+
+} // namespace ethutils
+
+#endif // ETHUTILS_EVENTREGISTRY_HPP
@@ -0,0 +1,352 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "eventregistry.hpp"
+
+#include "hexutils.hpp"
+#include "uint256.hpp"
+
+#include <gtest/gtest.h>
+
+#include <glog/logging.h>
+
+namespace ethutils
+{
+namespace
+{
+
+/**
+ * Converts hex data without 0x prefix to binary.
+ */
+std::string
+Bin (const std::string& hex)
+{
+  std::string res;
+  CHECK (Unhexlify (hex, res)) << hex;
+  return res;
+}
+
+/**
+ * Returns a 32-byte topic for an address (left-padded with zeros).
+ */
+std::string
+AddressTopic (const Address& addr)
+{
+  const auto& bin = addr.GetBinary ();
+  return std::string (32 - bin.size (), '\0')
+            + std::string (bin.begin (), bin.end ());
+}
+
+class EventRegistryTests : public testing::Test
+{
+
+protected:
+
+  const Address alice{"0x14e663e1531e0f438840952d18720c74c28d4f20"};
+  const Address bob{"0xf0534cc8f4c22972d31105c7ac7b656b581a3a8e"};
+
+  /** A token contract, for which we register an ERC-721 Transfer.  */
+  const Address nft{"0xd9145cce52d386f254917e481eb44e9943f39138"};
+
+  /** Some other (ERC-20) contract.  */
+  const Address token{"0x1111111111111111111111111111111111111111"};
+
+  EventRegistry registry;
+
+  size_t erc20;
+  size_t erc721;
+  size_t move;
+
+  EventRegistryTests ()
+  {
+    erc20 = registry.Register (
+        "Transfer(address indexed from, address indexed to, uint256 value)");
+    erc721 = registry.Register (
+        "Transfer(address indexed, address indexed, uint256 indexed id)",
+        nft);
+    move = registry.Register (
+        "Move(string ns, string name, string mv,"
+        " uint256 nonce, address mover, uint256 amount, address receiver)");
+  }
+
+  /**
+   * Constructs a log with the given topic0 (as event ID), extra topics
+   * and data.
+   */
+  EventRegistry::Log
+  MakeLog (const Address& addr, const size_t id,
+           const std::vector<std::string>& topics,
+           const std::string& data) const
+  {
+    EventRegistry::Log res;
+    res.address = addr.GetBinary ();
+    res.topics.push_back (registry.GetTopic0 (id));
+    for (const auto& t : topics)
+      res.topics.push_back (t);
+    res.data = data;
+    return res;
+  }
+
+  /**
+   * Returns an ERC-20 transfer log from alice to bob.
+   */
+  EventRegistry::Log
+  Erc20Transfer (const Address& addr, const uint64_t value) const
+  {
+    return MakeLog (addr, erc20, {AddressTopic (alice), AddressTopic (bob)},
+                    Uint256 (value).ToBinary ());
+  }
+
+  /**
+   * Returns an ERC-721 transfer log from alice to bob.
+   */
+  EventRegistry::Log
+  Erc721Transfer (const uint64_t id) const
+  {
+    return MakeLog (nft, erc721,
+                    {AddressTopic (alice), AddressTopic (bob),
+                     Uint256 (id).ToBinary ()},
+                    "");
+  }
+
+};
+
+TEST_F (EventRegistryTests, Signatures)
+{
+  EXPECT_EQ (registry.GetNumEvents (), 3);
+  EXPECT_EQ (erc20, 0);
+  EXPECT_EQ (erc721, 1);
+  EXPECT_EQ (move, 2);
+
+  EXPECT_EQ (registry.GetSignature (erc20),
+             "Transfer(address,address,uint256)");
+  EXPECT_EQ (registry.GetSignature (erc721),
+             "Transfer(address,address,uint256)");
+  EXPECT_EQ (registry.GetSignature (move),
+             "Move(string,string,string,uint256,address,uint256,address)");
+
+  EXPECT_EQ (Hexlify (registry.GetTopic0 (erc20)),
+             "ddf252ad1be2c89b69c2b068fc378daa"
+             "952ba7f163c4a11628f55a4df523b3ef");
+  EXPECT_EQ (registry.GetTopic0 (erc721), registry.GetTopic0 (erc20));
+}
+
+TEST_F (EventRegistryTests, Lookup)
+{
+  const std::string& transfer = registry.GetTopic0 (erc20);
+  EXPECT_EQ (registry.Lookup (transfer, token.GetBinary ()), erc20);
+  EXPECT_EQ (registry.Lookup (transfer, nft.GetBinary ()), erc721);
+  EXPECT_EQ (registry.Lookup (registry.GetTopic0 (move), nft.GetBinary ()),
+             move);
+
+  EXPECT_EQ (registry.Lookup (std::string (32, '\0'), nft.GetBinary ()),
+             EventRegistry::NOT_FOUND);
+  EXPECT_EQ (registry.Lookup ("foo", nft.GetBinary ()),
+             EventRegistry::NOT_FOUND);
+
+  /* An event only registered for a specific contract does not match
+     logs from other contracts.  */
+  const Address other("0x2222222222222222222222222222222222222222");
+  const size_t specific = registry.Register ("Specific(uint256)", other);
+  const std::string& topic = registry.GetTopic0 (specific);
+  EXPECT_EQ (registry.Lookup (topic, other.GetBinary ()), specific);
+  EXPECT_EQ (registry.Lookup (topic, nft.GetBinary ()),
+             EventRegistry::NOT_FOUND);
+}
+
+TEST_F (EventRegistryTests, DecodeSingle)
+{
+  size_t id;
+  EventRegistry::Event ev;
+
+  const auto erc20Log = Erc20Transfer (token, 42);
+  ASSERT_TRUE (registry.Decode (erc20Log, id, ev));
+  EXPECT_EQ (id, erc20);
+  ASSERT_EQ (ev.indexed.size (), 2);
+  EXPECT_EQ (ev.indexed[0], AddressTopic (alice));
+  EXPECT_EQ (ev.indexed[1], AddressTopic (bob));
+  ASSERT_EQ (ev.data.elements.size (), 1);
+  EXPECT_EQ (ev.data.elements[0].GetUint64 (), 42);
+
+  /* The same log from the NFT contract does not match the ERC-721
+     event's number of topics.  */
+  auto wrongTopics = erc20Log;
+  wrongTopics.address = nft.GetBinary ();
+  EXPECT_FALSE (registry.Decode (wrongTopics, id, ev));
+  EXPECT_EQ (id, erc721);
+
+  const auto erc721Log = Erc721Transfer (1234);
+  ASSERT_TRUE (registry.Decode (erc721Log, id, ev));
+  EXPECT_EQ (id, erc721);
+  ASSERT_EQ (ev.indexed.size (), 3);
+  EXPECT_EQ (Uint256::FromBinary (ev.indexed[2]), Uint256 (1234));
+  EXPECT_TRUE (ev.data.elements.empty ());
+
+  /* This is the move event data from AbiDecoderTests.DecodeMoveEvent.  */
+  const auto moveLog = MakeLog (token, move, {}, Bin (
+      "00000000000000000000000000000000000000000000000000000000000000e0"
+      "0000000000000000000000000000000000000000000000000000000000000120"
+      "0000000000000000000000000000000000000000000000000000000000000160"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "00000000000000000000000014e663e1531e0f438840952d18720c74c28d4f20"
+      "00000000000000000000000000000000000000000000000000000000000004d2"
+      "000000000000000000000000f0534cc8f4c22972d31105c7ac7b656b581a3a8e"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "7000000000000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000005"
+      "646f6d6f62000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000002"
+      "7b7d000000000000000000000000000000000000000000000000000000000000"));
+  ASSERT_TRUE (registry.Decode (moveLog, id, ev));
+  EXPECT_EQ (id, move);
+  EXPECT_TRUE (ev.indexed.empty ());
+  ASSERT_EQ (ev.data.elements.size (), 7);
+  EXPECT_EQ (ev.data.elements[0].data, "p");
+  EXPECT_EQ (ev.data.elements[1].data, "domob");
+  EXPECT_EQ (ev.data.elements[2].data, "{}");
+  EXPECT_EQ (ev.data.elements[3].GetUint64 (), 2);
+  EXPECT_EQ (ev.data.elements[4].GetAddress (), alice);
+  EXPECT_EQ (ev.data.elements[5].GetUint64 (), 1234);
+  EXPECT_EQ (ev.data.elements[6].GetAddress (), bob);
+
+  auto truncated = moveLog;
+  truncated.data.resize (truncated.data.size () - 32);
+  EXPECT_FALSE (registry.Decode (truncated, id, ev));
+  EXPECT_EQ (id, move);
+
+  EventRegistry::Log anonymous;
+  anonymous.address = token.GetBinary ();
+  EXPECT_FALSE (registry.Decode (anonymous, id, ev));
+  EXPECT_EQ (id, EventRegistry::NOT_FOUND);
+}
+
+TEST_F (EventRegistryTests, DecodeBatch)
+{
+  std::vector<EventRegistry::Log> logs;
+  for (unsigned i = 0; i < 100; ++i)
+    switch (i % 5)
+      {
+      case 0:
+        logs.push_back (Erc20Transfer (token, i));
+        break;
+      case 1:
+        logs.push_back (Erc721Transfer (i));
+        break;
+      case 2:
+        {
+          /* Unknown topic0.  */
+          auto log = Erc20Transfer (token, i);
+          log.topics[0] = std::string (32, 'x');
+          logs.push_back (log);
+          break;
+        }
+      case 3:
+        {
+          /* Invalid data.  */
+          auto log = Erc20Transfer (token, i);
+          log.data.pop_back ();
+          logs.push_back (log);
+          break;
+        }
+      case 4:
+        logs.push_back (Erc20Transfer (nft, i));
+        break;
+      }
+
+  for (const unsigned threads : {1, 4})
+    {
+      const auto res = registry.DecodeBatch (logs, threads);
+      ASSERT_EQ (res.events.size (), registry.GetNumEvents ());
+
+      ASSERT_EQ (res.events[erc20].size (), 20);
+      for (size_t i = 0; i < 20; ++i)
+        {
+          const auto& ev = res.events[erc20][i];
+          EXPECT_EQ (ev.log, 5 * i);
+          EXPECT_EQ (ev.data.elements[0].GetUint64 (), 5 * i);
+        }
+
+      ASSERT_EQ (res.events[erc721].size (), 20);
+      for (size_t i = 0; i < 20; ++i)
+        {
+          const auto& ev = res.events[erc721][i];
+          EXPECT_EQ (ev.log, 5 * i + 1);
+          EXPECT_EQ (Uint256::FromBinary (ev.indexed[2]), Uint256 (5 * i + 1));
+        }
+
+      EXPECT_TRUE (res.events[move].empty ());
+
+      ASSERT_EQ (res.unmatched.size (), 20);
+      ASSERT_EQ (res.invalid.size (), 40);
+      for (size_t i = 0; i < 20; ++i)
+        {
+          EXPECT_EQ (res.unmatched[i], 5 * i + 2);
+          EXPECT_EQ (res.invalid[2 * i], 5 * i + 3);
+          EXPECT_EQ (res.invalid[2 * i + 1], 5 * i + 4);
+        }
+    }
+
+  const auto empty = registry.DecodeBatch ({});
+  EXPECT_EQ (empty.events.size (), registry.GetNumEvents ());
+  EXPECT_TRUE (empty.unmatched.empty ());
+  EXPECT_TRUE (empty.invalid.empty ());
+}
+
+TEST_F (EventRegistryTests, DecodeBatchAliasedData)
+{
+  const size_t nested = registry.Register ("Nested(uint256[][][] values)");
+
+  /* All offsets in each array point to the same child array, so that this
+     would expand to a million values from less than 10 KiB of data.  */
+  const auto word = [] (const uint64_t val)
+    {
+      return Uint256 (val).ToBinary ();
+    };
+  const size_t n = 100;
+  std::string data = word (32);
+  for (unsigned level = 0; level < 3; ++level)
+    {
+      data += word (n);
+      for (size_t i = 0; i < n; ++i)
+        data += word (level < 2 ? 32 * n : i);
+    }
+
+  const std::vector<EventRegistry::Log> logs = {
+    MakeLog (token, nested, {}, data),
+    Erc20Transfer (token, 42),
+  };
+
+  for (const unsigned threads : {1, 4})
+    {
+      const auto res = registry.DecodeBatch (logs, threads);
+      EXPECT_TRUE (res.events[nested].empty ());
+      ASSERT_EQ (res.events[erc20].size (), 1);
+      EXPECT_EQ (res.events[erc20][0].log, 1);
+      EXPECT_EQ (res.invalid, std::vector<size_t> ({0}));
+    }
+}
+
+TEST_F (EventRegistryTests, InvalidRegistrations)
+{
+  EXPECT_DEATH (registry.Register ("Transfer(address,address,uint256)"),
+                "already registered");
+  EXPECT_DEATH (registry.Register ("Transfer(address,address,uint256)", nft),
+                "already registered");
+  EXPECT_DEATH (registry.Register ("Foo"), "Invalid event declaration");
+  EXPECT_DEATH (registry.Register ("(uint256)"), "Invalid event declaration");
+  EXPECT_DEATH (registry.Register ("Foo(uint257)"), "Invalid type");
+  EXPECT_DEATH (registry.Register ("Foo(uint256 a b)"),
+                "Invalid event parameter");
+  EXPECT_DEATH (registry.Register ("Foo(uint256,)"), "Invalid event parameter");
+
+  /* Tuples are split correctly, and the same event can be registered
+     for different specific contracts.  */
+  const size_t id = registry.Register ("Foo((uint64,bool)[] indexed, bool)");
+  EXPECT_EQ (registry.GetSignature (id), "Foo((uint64,bool)[],bool)");
+  registry.Register ("Transfer(address,address,uint256)", token);
+  EXPECT_EQ (registry.GetNumEvents (), 5);
+}
+
+} // anonymous namespace
+} // namespace ethutils
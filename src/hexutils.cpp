@@ -1,4 +1,4 @@
-// Copyright (C) 2021 The Xaya developers
+// Copyright (C) 2021-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -6,56 +6,96 @@
 
 #include <glog/logging.h>
 
-#include <sstream>
-
 namespace ethutils
 {
 
 std::string
 Hexlify (const std::string& bin)
 {
-  std::ostringstream out;
-  out << std::hex;
-  for (const char c : bin)
+  std::string res(2 * bin.size (), '\0');
+  Hexlify (reinterpret_cast<const unsigned char*> (bin.data ()), bin.size (),
+           &res[0]);
+  return res;
+}
+
+void
+Hexlify (const unsigned char* bin, const size_t len, char* out)
+{
+  static const char digits[] = "0123456789abcdef";
+  for (size_t i = 0; i < len; ++i)
     {
-      const int val = static_cast<int> (static_cast<uint8_t> (c));
-      CHECK_GE (val, 0);
-      CHECK_LE (val, 0xFF);
-      if (val < 0x10)
-        out << '0';
-      out << val;
+      out[2 * i] = digits[bin[i] >> 4];
+      out[2 * i + 1] = digits[bin[i] & 0x0F];
     }
-  return out.str ();
 }
 
+namespace
+{
+
+/**
+ * Returns the value of a hex digit, or -1 if the character is not one.
+ * Upper-case digits are only accepted if anyCase is set; otherwise they
+ * are rejected, so that each binary string has exactly one valid hex form.
+ */
+inline int
+HexDigitValue (const char c, const bool anyCase)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (anyCase && c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+/**
+ * Decodes hex into binary, without logging.  Returns false if the input
+ * is not valid.
+ */
 bool
-Unhexlify (const std::string& hex, std::string& bin)
+DecodeHex (const std::string_view hex, const bool anyCase, std::string& bin)
 {
   if (hex.size () % 2 != 0)
+    return false;
+
+  bin.resize (hex.size () / 2);
+  for (size_t i = 0; i < bin.size (); ++i)
     {
-      LOG (WARNING) << "Hex string has size " << hex.size ();
-      return false;
+      const int hi = HexDigitValue (hex[2 * i], anyCase);
+      const int lo = HexDigitValue (hex[2 * i + 1], anyCase);
+      if (hi < 0 || lo < 0)
+        return false;
+      bin[i] = static_cast<char> ((hi << 4) | lo);
     }
 
-  bin.clear ();
-  for (size_t i = 0; i < hex.size (); i += 2)
+  return true;
+}
+
+} // anonymous namespace
+
+bool
+Unhexlify (const std::string_view hex, std::string& bin)
+{
+  if (hex.size () % 2 != 0)
     {
-      std::istringstream in(hex.substr (i, 2));
-      int val;
-      in >> std::hex >> val;
-      bin.push_back (static_cast<char> (val));
+      LOG (WARNING) << "Hex string has size " << hex.size ();
+      return false;
     }
 
-  const std::string rehex = Hexlify (bin);
-  if (hex != rehex)
+  if (!DecodeHex (hex, false, bin))
     {
-      LOG (WARNING)
-          << "Mismatch between parsed string in hex and input:\n"
-          << rehex << "\n" << hex;
+      LOG (WARNING) << "Invalid hex string: " << hex;
       return false;
     }
 
   return true;
 }
 
+bool
+UnhexlifyAnyCase (const std::string_view hex, std::string& bin)
+{
+  return DecodeHex (hex, true, bin);
+}
+
 } // namespace ethutils
@@ -1,11 +1,13 @@
-// Copyright (C) 2021 The Xaya developers
+// Copyright (C) 2021-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #ifndef ETHUTILS_HEXUTILS_HPP
 #define ETHUTILS_HEXUTILS_HPP
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 
 namespace ethutils
 {
@@ -15,11 +17,24 @@ namespace ethutils
  */
 std::string Hexlify (const std::string& bin);
 
+/**
+ * Converts a raw binary buffer of len bytes to hex, writing the 2 * len
+ * resulting characters to out.  This does not allocate.
+ */
+void Hexlify (const unsigned char* bin, size_t len, char* out);
+
 /**
  * Converts a hex string into a binary string.  Returns false if the input
  * string is not valid hex.
  */
-bool Unhexlify (const std::string& hex, std::string& bin);
+bool Unhexlify (std::string_view hex, std::string& bin);
+
+/**
+ * Converts a hex string into a binary string like Unhexlify, but accepts
+ * both lower- and upper-case digits.  It also does not log anything on
+ * invalid input, so it is suitable for untrusted data.
+ */
+bool UnhexlifyAnyCase (std::string_view hex, std::string& bin);
 
 } // namespace ethutils
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2021 The Xaya developers
+// Copyright (C) 2021-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -32,6 +32,14 @@ TEST_F (HexlifyTests, ValidRoundtrip)
   EXPECT_EQ (Hexlify (actual), "");
 }
 
+TEST_F (HexlifyTests, RawBuffer)
+{
+  const unsigned char bin[] = {0x00, 0xff, 0x20, 0x0f, 0xa0};
+  std::string out(2 * sizeof (bin), 'x');
+  Hexlify (bin, sizeof (bin), &out[0]);
+  EXPECT_EQ (out, "00ff200fa0");
+}
+
 TEST_F (HexlifyTests, UnhexlifyWrongSize)
 {
   std::string actual;
@@ -42,6 +50,21 @@ TEST_F (HexlifyTests, UnhexlifyInvalidHex)
 {
   std::string actual;
   EXPECT_FALSE (Unhexlify ("20x1", actual));
+  EXPECT_FALSE (Unhexlify ("0A", actual));
+  EXPECT_FALSE (Unhexlify ("g0", actual));
+}
+
+TEST_F (HexlifyTests, UnhexlifyAnyCase)
+{
+  std::string actual;
+  ASSERT_TRUE (UnhexlifyAnyCase ("0aFf", actual));
+  EXPECT_EQ (actual, "\x0A\xFF");
+  ASSERT_TRUE (UnhexlifyAnyCase ("", actual));
+  EXPECT_EQ (actual, "");
+
+  EXPECT_FALSE (UnhexlifyAnyCase ("a", actual));
+  EXPECT_FALSE (UnhexlifyAnyCase ("0G", actual));
+  EXPECT_FALSE (UnhexlifyAnyCase ("0x", actual));
 }
 
 } // anonymous namespace
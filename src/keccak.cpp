@@ -1,4 +1,4 @@
-// Copyright (C) 2021 The Xaya developers
+// Copyright (C) 2021-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -8,6 +8,10 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
 namespace ethutils
 {
 
@@ -15,11 +19,310 @@ std::string
 Keccak256 (const std::string& data)
 {
   std::string res(32, '\0');
-  const int ret = sha3_256 (reinterpret_cast<uint8_t*> (&res[0]), res.size (),
-                            reinterpret_cast<const uint8_t*> (data.data ()),
-                            data.size ());
+  Keccak256 (reinterpret_cast<const unsigned char*> (data.data ()),
+             data.size (), reinterpret_cast<unsigned char*> (&res[0]));
+  return res;
+}
+
+void
+Keccak256 (const unsigned char* data, const size_t len, unsigned char* out)
+{
+  const int ret = sha3_256 (out, 32, data, len);
   CHECK_EQ (ret, 0) << "Keccak implementation failed";
+}
+
+/* ************************************************************************** */
+
+namespace
+{
+
+/** The rate of Keccak-256 in bytes.  */
+constexpr size_t RATE = 200 - 2 * 32;
+
+/** Number of inputs hashed together by Keccak256Batch.  */
+constexpr size_t LANES = 4;
+
+/** Round constants of Keccak-f[1600].  */
+constexpr uint64_t ROUND_CONSTANTS[24] = {
+  0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+  0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+  0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+  0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+  0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+  0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+  0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+  0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+
+/** Rotation offsets of the rho step, indexed by word (x + 5 y).  */
+constexpr unsigned RHO[25] = {
+  0, 1, 62, 28, 27,
+  36, 44, 6, 55, 20,
+  3, 10, 43, 25, 39,
+  41, 45, 15, 21, 8,
+  18, 2, 61, 56, 14,
+};
+
+/** Target word of the pi step for each word (x + 5 y).  */
+constexpr unsigned PI[25] = {
+  0, 10, 20, 5, 15,
+  16, 1, 11, 21, 6,
+  7, 17, 2, 12, 22,
+  23, 8, 18, 3, 13,
+  14, 24, 9, 19, 4,
+};
+
+/**
+ * One word of the Keccak state for N lanes.  The permutation below
+ * is written in terms of operations on these, which are simple loops over
+ * the lanes that the compiler can vectorise.  With a single lane, this is
+ * the plain permutation (as used by Keccak256Hasher).
+ */
+template <size_t N>
+  struct LaneWord
+{
+  uint64_t v[N];
+};
+
+template <size_t N>
+  inline LaneWord<N>
+  operator^ (const LaneWord<N>& a, const LaneWord<N>& b)
+{
+  LaneWord<N> res;
+  for (size_t l = 0; l < N; ++l)
+    res.v[l] = a.v[l] ^ b.v[l];
   return res;
 }
 
+/**
+ * Computes (~a & b) for each lane.
+ */
+template <size_t N>
+  inline LaneWord<N>
+  AndNot (const LaneWord<N>& a, const LaneWord<N>& b)
+{
+  LaneWord<N> res;
+  for (size_t l = 0; l < N; ++l)
+    res.v[l] = ~a.v[l] & b.v[l];
+  return res;
+}
+
+template <size_t N>
+  inline LaneWord<N>
+  Rotl (const LaneWord<N>& a, const unsigned s)
+{
+  LaneWord<N> res;
+  for (size_t l = 0; l < N; ++l)
+    res.v[l] = (a.v[l] << s) | (a.v[l] >> ((64 - s) & 63));
+  return res;
+}
+
+/** Keccak state for N inputs (interleaved by word).  */
+template <size_t N>
+  using LaneState = LaneWord<N>[25];
+
+/*
+ * The steps of the permutation are expanded over index sequences, so that
+ * all word indices are compile-time constants.  This lets the compiler keep
+ * the state in (vector) registers instead of going through indexed memory,
+ * which is what makes the interleaved version faster than hashing inputs
+ * one by one.
+ */
+
+template <size_t N, size_t... X>
+  inline void
+  Theta (const LaneState<N>& st, LaneWord<N>* d, std::index_sequence<X...>)
+{
+  const LaneWord<N> c[5] = {
+    (st[X] ^ st[X + 5] ^ st[X + 10] ^ st[X + 15] ^ st[X + 20])...
+  };
+  ((d[X] = c[(X + 4) % 5] ^ Rotl (c[(X + 1) % 5], 1)), ...);
+}
+
+template <size_t N, size_t... I>
+  inline void
+  RhoPi (const LaneState<N>& st, const LaneWord<N>* d, LaneState<N>& b,
+         std::index_sequence<I...>)
+{
+  ((b[PI[I]] = Rotl (st[I] ^ d[I % 5], RHO[I])), ...);
+}
+
+template <size_t N, size_t... I>
+  inline void
+  Chi (LaneState<N>& st, const LaneState<N>& b, std::index_sequence<I...>)
+{
+  ((st[I] = b[I] ^ AndNot (b[I - I % 5 + (I + 1) % 5],
+                           b[I - I % 5 + (I + 2) % 5])), ...);
+}
+
+/**
+ * Applies the Keccak-f[1600] permutation to all lanes of the state.
+ */
+template <size_t N>
+  void
+  KeccakF1600Lanes (LaneState<N>& st)
+{
+  for (const uint64_t rc : ROUND_CONSTANTS)
+    {
+      LaneWord<N> d[5];
+      LaneState<N> b;
+
+      Theta (st, d, std::make_index_sequence<5> ());
+      RhoPi (st, d, b, std::make_index_sequence<25> ());
+      Chi (st, b, std::make_index_sequence<25> ());
+
+      for (size_t l = 0; l < N; ++l)
+        st[0].v[l] ^= rc;
+    }
+}
+
+/**
+ * XORs a byte into the given lane of the state, at the given byte
+ * position of the (little-endian) sponge.
+ */
+inline void
+XorByte (LaneState<LANES>& st, const size_t lane, const size_t pos,
+         const unsigned char b)
+{
+  st[pos / 8].v[lane] ^= static_cast<uint64_t> (b) << (8 * (pos % 8));
+}
+
+/**
+ * Reads a little-endian 64-bit word.
+ */
+inline uint64_t
+LoadWord (const unsigned char* data)
+{
+  uint64_t res = 0;
+  for (size_t b = 0; b < 8; ++b)
+    res |= static_cast<uint64_t> (data[b]) << (8 * b);
+  return res;
+}
+
+/**
+ * Applies the Keccak-f[1600] permutation to a single state, given as
+ * its 25 words.
+ */
+void
+KeccakF1600 (uint64_t* words)
+{
+  LaneState<1> st;
+  for (size_t w = 0; w < 25; ++w)
+    st[w].v[0] = words[w];
+
+  KeccakF1600Lanes (st);
+
+  for (size_t w = 0; w < 25; ++w)
+    words[w] = st[w].v[0];
+}
+
+/**
+ * Hashes exactly LANES inputs of the given length with the interleaved
+ * state, and writes their hashes to out.
+ */
+void
+Keccak256Lanes (const unsigned char* data, const size_t len,
+                unsigned char* out)
+{
+  LaneState<LANES> st = {};
+
+  size_t offset = 0;
+  for (; offset + RATE <= len; offset += RATE)
+    {
+      for (size_t l = 0; l < LANES; ++l)
+        {
+          const unsigned char* block = data + l * len + offset;
+          for (size_t w = 0; w < RATE / 8; ++w)
+            st[w].v[l] ^= LoadWord (block + 8 * w);
+        }
+      KeccakF1600Lanes (st);
+    }
+
+  const size_t rest = len - offset;
+  for (size_t l = 0; l < LANES; ++l)
+    {
+      const unsigned char* block = data + l * len + offset;
+      size_t b = 0;
+      for (; b + 8 <= rest; b += 8)
+        st[b / 8].v[l] ^= LoadWord (block + b);
+      for (; b < rest; ++b)
+        XorByte (st, l, b, block[b]);
+      XorByte (st, l, rest, 0x01);
+      XorByte (st, l, RATE - 1, 0x80);
+    }
+  KeccakF1600Lanes (st);
+
+  for (size_t l = 0; l < LANES; ++l)
+    for (size_t b = 0; b < 32; ++b)
+      out[32 * l + b] = (st[b / 8].v[l] >> (8 * (b % 8))) & 0xFF;
+}
+
+} // anonymous namespace
+
+void
+Keccak256Batch (const unsigned char* data, const size_t len, const size_t n,
+                unsigned char* out)
+{
+  size_t i = 0;
+  for (; i + LANES <= n; i += LANES)
+    Keccak256Lanes (data + i * len, len, out + 32 * i);
+
+  for (; i < n; ++i)
+    Keccak256 (data + i * len, len, out + 32 * i);
+}
+
+/* ************************************************************************** */
+
+Keccak256Hasher::Keccak256Hasher ()
+  : pos(0)
+{
+  std::fill (state, state + 25, 0);
+}
+
+Keccak256Hasher&
+Keccak256Hasher::Update (const unsigned char* data, size_t len)
+{
+  while (len > 0)
+    {
+      const size_t n = std::min (len, RATE - pos);
+
+      /* Absorb full words directly where the position is word-aligned,
+         and the remaining bytes one by one.  */
+      size_t i = 0;
+      if (pos % 8 == 0)
+        for (; i + 8 <= n; i += 8)
+          state[(pos + i) / 8] ^= LoadWord (data + i);
+      for (; i < n; ++i)
+        state[(pos + i) / 8]
+            ^= static_cast<uint64_t> (data[i]) << (8 * ((pos + i) % 8));
+
+      pos += n;
+      data += n;
+      len -= n;
+
+      if (pos == RATE)
+        {
+          KeccakF1600 (state);
+          pos = 0;
+        }
+    }
+
+  return *this;
+}
+
+void
+Keccak256Hasher::Finish (unsigned char* out)
+{
+  /* This is the original Keccak padding (as used by Ethereum), which differs
+     from the final SHA-3 standard only in the domain separation byte.  */
+  state[pos / 8] ^= static_cast<uint64_t> (0x01) << (8 * (pos % 8));
+  state[(RATE - 1) / 8] ^= static_cast<uint64_t> (0x80) << 56;
+  KeccakF1600 (state);
+
+  for (size_t b = 0; b < 32; ++b)
+    out[b] = (state[b / 8] >> (8 * (b % 8))) & 0xFF;
+}
+
+/* ************************************************************************** */
+
 } // namespace ethutils
@@ -1,11 +1,14 @@
-// Copyright (C) 2021 The Xaya developers
+// Copyright (C) 2021-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #ifndef ETHUTILS_KECCAK_HPP
 #define ETHUTILS_KECCAK_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 namespace ethutils
 {
@@ -17,6 +20,64 @@ namespace ethutils
  */
 std::string Keccak256 (const std::string& data);
 
+/**
+ * Computes the Keccak-256 hash of a raw buffer of the given length, and writes
+ * the 32-byte result to out.  This avoids any allocations.
+ */
+void Keccak256 (const unsigned char* data, size_t len, unsigned char* out);
+
+/**
+ * Computes the Keccak-256 hashes of n inputs that all have the same length
+ * and are stored one after the other in data (input i starts at
+ * data + i * len).  The hashes are written to out, with hash i starting
+ * at out + 32 * i.
+ *
+ * Multiple inputs are processed together with an interleaved state, so that
+ * the permutation can make use of SIMD instructions.  This is faster than
+ * hashing them one by one, e.g. for deriving many addresses from pubkeys.
+ */
+void Keccak256Batch (const unsigned char* data, size_t len, size_t n,
+                     unsigned char* out);
+
+/**
+ * Incremental Keccak-256 hasher.  This can be used to hash data that is
+ * not contiguous in memory, without copying it together first.
+ */
+class Keccak256Hasher
+{
+
+private:
+
+  /** The sponge state as 25 little-endian 64-bit words.  */
+  uint64_t state[25];
+
+  /** Number of bytes already absorbed into the current block.  */
+  size_t pos;
+
+public:
+
+  Keccak256Hasher ();
+
+  /**
+   * Adds more data to the hash.
+   */
+  Keccak256Hasher& Update (const unsigned char* data, size_t len);
+
+  Keccak256Hasher&
+  Update (const std::string_view data)
+  {
+    return Update (reinterpret_cast<const unsigned char*> (data.data ()),
+                   data.size ());
+  }
+
+  /**
+   * Finishes the hash and writes the 32-byte result to out.  The instance
+   * must not be used anymore afterwards.
+   */
+  void Finish (unsigned char* out);
+
+};
+
 } // namespace ethutils
 
 #endif // ETHUTILS_KECCAK_HPP
@@ -1,4 +1,4 @@
-// Copyright (C) 2021 The Xaya developers
+// Copyright (C) 2021-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -42,5 +42,55 @@ TEST_F (KeccakTests, Works)
       "0x36782afd471b2fcfd6b549502cf385072800fa99bdef3ebb9d525bd010084d17");
 }
 
+TEST_F (KeccakTests, RawBuffer)
+{
+  const std::string data = "hello, world";
+  std::string hash(32, '\0');
+  Keccak256 (reinterpret_cast<const unsigned char*> (data.data ()),
+             data.size (), reinterpret_cast<unsigned char*> (&hash[0]));
+  EXPECT_EQ (hash, Keccak256 (data));
+}
+
+TEST_F (KeccakTests, Incremental)
+{
+  std::string data;
+  for (unsigned i = 0; i < 1'000; ++i)
+    data.push_back (static_cast<char> (i * 7));
+
+  for (const size_t len : {0u, 1u, 135u, 136u, 137u, 272u, 500u, 1'000u})
+    for (const size_t chunk : {1u, 3u, 64u, 136u, 999u})
+      {
+        const std::string part = data.substr (0, len);
+
+        Keccak256Hasher hasher;
+        for (size_t i = 0; i < part.size (); i += chunk)
+          hasher.Update (std::string_view (part).substr (i, chunk));
+
+        std::string hash(32, '\0');
+        hasher.Finish (reinterpret_cast<unsigned char*> (&hash[0]));
+        EXPECT_EQ (hash, Keccak256 (part)) << len << " " << chunk;
+      }
+}
+
+TEST_F (KeccakTests, Batch)
+{
+  std::string data;
+  for (unsigned i = 0; i < 10'000; ++i)
+    data.push_back (static_cast<char> (i * 13 + i / 7));
+
+  for (const size_t len : {0u, 1u, 64u, 135u, 136u, 137u, 300u})
+    for (const size_t n : {0u, 1u, 3u, 4u, 5u, 8u, 11u})
+      {
+        std::string hashes(32 * n, '\0');
+        Keccak256Batch (reinterpret_cast<const unsigned char*> (data.data ()),
+                        len, n, reinterpret_cast<unsigned char*> (&hashes[0]));
+
+        for (size_t i = 0; i < n; ++i)
+          EXPECT_EQ (hashes.substr (32 * i, 32),
+                     Keccak256 (data.substr (i * len, len)))
+              << len << " " << n << " " << i;
+      }
+}
+
 } // anonymous namespace
 } // namespace ethutils
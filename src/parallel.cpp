@@ -0,0 +1,61 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace ethutils
+{
+
+unsigned
+NumThreads (const unsigned requested)
+{
+  if (requested > 0)
+    return requested;
+
+  return std::max (1u, std::thread::hardware_concurrency ());
+}
+
+void
+ParallelFor (const size_t n, const unsigned threads,
+             const std::function<void (size_t, size_t)>& fcn)
+{
+  if (n == 0)
+    return;
+
+  const size_t numThreads = std::min<size_t> (NumThreads (threads), n);
+  if (numThreads == 1)
+    {
+      fcn (0, n);
+      return;
+    }
+
+  /* The first (n % numThreads) chunks get one extra element, so that
+     all chunks are as equal in size as possible.  The last chunk is
+     processed on the calling thread.  */
+  const size_t chunk = n / numThreads;
+  const size_t extra = n % numThreads;
+
+  std::vector<std::thread> workers;
+  workers.reserve (numThreads - 1);
+
+  size_t begin = 0;
+  for (size_t i = 0; i < numThreads; ++i)
+    {
+      const size_t end = begin + chunk + (i < extra ? 1 : 0);
+      if (i + 1 == numThreads)
+        fcn (begin, end);
+      else
+        workers.emplace_back (fcn, begin, end);
+      begin = end;
+    }
+
+  for (auto& w : workers)
+    w.join ();
+}
+
+} // namespace ethutils
@@ -0,0 +1,35 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ETHUTILS_PARALLEL_HPP
+#define ETHUTILS_PARALLEL_HPP
+
+#include <cstddef>
+#include <functional>
+
+namespace ethutils
+{
+
+/**
+ * Returns the number of worker threads to actually use for a given
+ * requested number.  Zero means to use the hardware concurrency.
+ */
+unsigned NumThreads (unsigned requested);
+
+/**
+ * Processes the index range [0, n) in parallel.  The range is split into
+ * contiguous chunks, and fcn(begin, end) is called for each chunk on one
+ * of up to the given number of threads (zero means to use the hardware
+ * concurrency).  This blocks until all chunks have been processed.
+ *
+ * This is used for the various batch operations of the library, including
+ * templates like AbiArrayView::ParallelDecode (which is why the header
+ * is installed).
+ */
+void ParallelFor (size_t n, unsigned threads,
+                  const std::function<void (size_t, size_t)>& fcn);
+
+} // namespace ethutils
+
+#endif // ETHUTILS_PARALLEL_HPP
@@ -0,0 +1,59 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "parallel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace ethutils
+{
+namespace
+{
+
+using ParallelTests = testing::Test;
+
+TEST_F (ParallelTests, NumThreads)
+{
+  EXPECT_EQ (NumThreads (3), 3);
+  EXPECT_GE (NumThreads (0), 1);
+}
+
+TEST_F (ParallelTests, EmptyRange)
+{
+  bool called = false;
+  ParallelFor (0, 4, [&] (size_t, size_t) { called = true; });
+  EXPECT_FALSE (called);
+}
+
+TEST_F (ParallelTests, CoversRangeExactlyOnce)
+{
+  for (const unsigned threads : {0u, 1u, 2u, 3u, 7u, 100u})
+    for (const size_t n : {1u, 2u, 10u, 99u, 1'000u})
+      {
+        std::vector<std::atomic<int>> counts(n);
+        std::mutex mut;
+        size_t chunks = 0;
+        ParallelFor (n, threads, [&] (const size_t begin, const size_t end)
+          {
+            ASSERT_LT (begin, end);
+            ASSERT_LE (end, n);
+            for (size_t i = begin; i < end; ++i)
+              ++counts[i];
+
+            std::lock_guard<std::mutex> lock(mut);
+            ++chunks;
+          });
+
+        for (const auto& c : counts)
+          EXPECT_EQ (c, 1);
+        EXPECT_LE (chunks, NumThreads (threads));
+      }
+}
+
+} // anonymous namespace
+} // namespace ethutils
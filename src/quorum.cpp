@@ -0,0 +1,137 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "quorum.hpp"
+
+#include "hexutils.hpp"
+#include "parallel.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+namespace ethutils
+{
+
+QuorumVerifier::QuorumVerifier (const ECDSA& e, const std::vector<Address>& s,
+                                const size_t t, const bool compact)
+  : ec(e), threshold(t), allowCompact(compact)
+{
+  signers.reserve (s.size ());
+  for (const auto& addr : s)
+    {
+      CHECK (addr) << "Authorised signer address is invalid";
+      signers.push_back (addr.GetBinary ());
+    }
+
+  std::sort (signers.begin (), signers.end ());
+  CHECK (std::adjacent_find (signers.begin (), signers.end ())
+            == signers.end ())
+      << "Authorised signers must be distinct";
+
+  CHECK_GT (threshold, 0) << "Threshold must be positive";
+  CHECK_LE (threshold, signers.size ())
+      << "Threshold exceeds the number of signers";
+}
+
+QuorumVerifier::Result
+QuorumVerifier::Run (const std::string& hash,
+                     const std::vector<std::string>& sgns, const bool hex,
+                     const unsigned threads) const
+{
+  Result res;
+
+  /* The state below is shared between the workers and protected by mut.
+     Only the recovery itself, which is the expensive part, runs without
+     holding the lock.  */
+  std::mutex mut;
+  std::vector<bool> seen(signers.size (), false);
+  size_t pending = sgns.size ();
+  std::atomic<bool> done(false);
+
+  /* Checks if the outcome is certain, and sets done if so.  This must
+     be called with mut held.  */
+  const auto checkDone = [&] ()
+    {
+      if (res.approvals >= threshold)
+        {
+          res.reached = true;
+          done = true;
+        }
+      else if (res.approvals + pending < threshold)
+        done = true;
+    };
+
+  {
+    std::lock_guard<std::mutex> lock(mut);
+    checkDone ();
+  }
+
+  ParallelFor (sgns.size (), threads, [&] (const size_t begin, const size_t end)
+    {
+      std::string sgnBin;
+      Address::Binary signer;
+
+      for (size_t i = begin; i < end && !done; ++i)
+        {
+          bool valid;
+          if (hex)
+            valid = sgns[i].substr (0, 2) == "0x"
+                      && Unhexlify (sgns[i].substr (2), sgnBin)
+                      && ec.RecoverSigner (hash, sgnBin, signer,
+                                           allowCompact);
+          else
+            valid = ec.RecoverSigner (hash, sgns[i], signer, allowCompact);
+
+          std::lock_guard<std::mutex> lock(mut);
+          --pending;
+
+          if (!valid)
+            ++res.invalid;
+          else
+            {
+              const auto it = std::lower_bound (signers.begin (),
+                                                signers.end (), signer);
+              if (it == signers.end () || *it != signer)
+                ++res.unauthorised;
+              else
+                {
+                  const size_t idx = it - signers.begin ();
+                  if (seen[idx])
+                    ++res.duplicates;
+                  else
+                    {
+                      seen[idx] = true;
+                      ++res.approvals;
+                    }
+                }
+            }
+
+          checkDone ();
+        }
+    });
+
+  return res;
+}
+
+QuorumVerifier::Result
+QuorumVerifier::VerifyMessage (const std::string& msg,
+                               const std::vector<std::string>& sgnHex,
+                               const unsigned threads) const
+{
+  return Run (ECDSA::MessageHash (msg), sgnHex, true, threads);
+}
+
+QuorumVerifier::Result
+QuorumVerifier::VerifyHash (const std::string& hash,
+                            const std::vector<std::string>& sgnBin,
+                            const unsigned threads) const
+{
+  CHECK_EQ (hash.size (), 32) << "Signed hash must be 32 bytes";
+  return Run (hash, sgnBin, false, threads);
+}
+
+} // namespace ethutils
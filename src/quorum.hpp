@@ -0,0 +1,111 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ETHUTILS_QUORUM_HPP
+#define ETHUTILS_QUORUM_HPP
+
+#include "address.hpp"
+#include "ecdsa.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ethutils
+{
+
+/**
+ * Verifier for M-of-N signatures on the same message, e.g. approvals of
+ * a set of validators.  The message hash is computed only once, signers
+ * are matched in binary form against the authorised set, and verification
+ * stops as soon as the outcome is certain.
+ */
+class QuorumVerifier
+{
+
+public:
+
+  /**
+   * The outcome of verifying a set of signatures.  Since verification stops
+   * early once the outcome is certain, the counters only reflect the
+   * signatures that have actually been processed.
+   */
+  struct Result
+  {
+
+    /** True if enough distinct authorised signers have signed.  */
+    bool reached = false;
+
+    /** Number of distinct authorised signers found.  */
+    size_t approvals = 0;
+
+    /** Number of signatures by an authorised signer already counted.  */
+    size_t duplicates = 0;
+
+    /** Number of signatures by a signer not in the authorised set.  */
+    size_t unauthorised = 0;
+
+    /** Number of signatures that are malformed or invalid.  */
+    size_t invalid = 0;
+
+  };
+
+private:
+
+  /** The ECDSA instance used for recovering signers.  */
+  const ECDSA& ec;
+
+  /** The authorised signers, sorted for binary search.  */
+  std::vector<Address::Binary> signers;
+
+  /** Number of distinct signers required.  */
+  size_t threshold;
+
+  /** Whether or not EIP-2098 compact signatures are accepted.  */
+  bool allowCompact;
+
+  /**
+   * Runs verification of the given signatures (hex or binary) against
+   * the 32-byte hash.
+   */
+  Result Run (const std::string& hash, const std::vector<std::string>& sgns,
+              bool hex, unsigned threads) const;
+
+public:
+
+  /**
+   * Constructs the verifier for a given set of authorised signers, of which
+   * threshold many have to sign.  The signers must be valid and distinct,
+   * and the threshold must be between one and their number.  If compact
+   * is set, signatures may also be given in the compact form of EIP-2098.
+   */
+  explicit QuorumVerifier (const ECDSA& e, const std::vector<Address>& s,
+                           size_t t, bool compact = false);
+
+  QuorumVerifier (const QuorumVerifier&) = delete;
+  void operator= (const QuorumVerifier&) = delete;
+
+  /**
+   * Verifies signatures (as hex strings with 0x prefix, see
+   * ECDSA::VerifyMessage) on a message with the legacy message encoding.
+   * The signers are recovered on up to the given number of threads (zero
+   * means the hardware concurrency).
+   */
+  Result VerifyMessage (const std::string& msg,
+                        const std::vector<std::string>& sgnHex,
+                        unsigned threads = 1) const;
+
+  /**
+   * Verifies raw binary signatures (65 bytes, or compact if enabled) made
+   * directly on the given 32-byte hash.
+   */
+  Result VerifyHash (const std::string& hash,
+                     const std::vector<std::string>& sgnBin,
+                     unsigned threads = 1) const;
+
+};
+
+} // namespace ethutils
+
+#endif // ETHUTILS_QUORUM_HPP
@@ -0,0 +1,191 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "quorum.hpp"
+
+#include "keccak.hpp"
+
+#include <gtest/gtest.h>
+
+#include <glog/logging.h>
+
+namespace ethutils
+{
+namespace
+{
+
+class QuorumTests : public testing::Test
+{
+
+protected:
+
+  /** The message that is signed in the tests.  */
+  static constexpr const char* MSG = "bridge payload";
+
+  ECDSA ec;
+
+  /** Keys of the authorised signers.  */
+  std::vector<ECDSA::Key> keys;
+
+  /** A key that is not authorised.  */
+  ECDSA::Key outsider;
+
+  /** The authorised signer addresses.  */
+  std::vector<Address> signers;
+
+  QuorumTests ()
+  {
+    for (unsigned i = 1; i <= 5; ++i)
+      {
+        const std::string secret(32, static_cast<char> (i));
+        keys.push_back (ec.SecretKey (secret));
+        signers.push_back (keys.back ().GetAddress ());
+      }
+
+    outsider = ec.SecretKey (std::string (32, '\x42'));
+  }
+
+  /**
+   * Returns the signature of MSG by the given key.
+   */
+  std::string
+  Sign (const ECDSA::Key& key) const
+  {
+    return ec.SignMessage (MSG, key);
+  }
+
+};
+
+TEST_F (QuorumTests, Reached)
+{
+  const QuorumVerifier v(ec, signers, 3);
+
+  const auto res = v.VerifyMessage (MSG, {
+    Sign (keys[4]), Sign (keys[0]), Sign (keys[2]),
+  });
+  EXPECT_TRUE (res.reached);
+  EXPECT_EQ (res.approvals, 3);
+  EXPECT_EQ (res.duplicates, 0);
+  EXPECT_EQ (res.unauthorised, 0);
+  EXPECT_EQ (res.invalid, 0);
+
+  EXPECT_FALSE (v.VerifyMessage ("other message", {
+    Sign (keys[4]), Sign (keys[0]), Sign (keys[2]),
+  }).reached);
+}
+
+TEST_F (QuorumTests, Duplicates)
+{
+  const QuorumVerifier v(ec, signers, 3);
+
+  const auto res = v.VerifyMessage (MSG, {
+    Sign (keys[1]), Sign (keys[1]), Sign (keys[2]), Sign (keys[1]),
+  });
+  EXPECT_FALSE (res.reached);
+  EXPECT_EQ (res.approvals, 2);
+  EXPECT_EQ (res.duplicates, 2);
+}
+
+TEST_F (QuorumTests, UnauthorisedAndInvalid)
+{
+  const QuorumVerifier v(ec, signers, 2);
+
+  const auto res = v.VerifyMessage (MSG, {
+    Sign (outsider), "0x1234", Sign (keys[0]).substr (2), Sign (keys[3]),
+    Sign (keys[0]),
+  });
+  EXPECT_TRUE (res.reached);
+  EXPECT_EQ (res.approvals, 2);
+  EXPECT_EQ (res.unauthorised, 1);
+  EXPECT_EQ (res.invalid, 2);
+}
+
+TEST_F (QuorumTests, EarlyExitWhenReached)
+{
+  const QuorumVerifier v(ec, signers, 2);
+
+  const auto res = v.VerifyMessage (MSG, {
+    Sign (keys[0]), Sign (keys[1]), "invalid", Sign (outsider),
+  });
+  EXPECT_TRUE (res.reached);
+  EXPECT_EQ (res.approvals, 2);
+  EXPECT_EQ (res.invalid, 0);
+  EXPECT_EQ (res.unauthorised, 0);
+}
+
+TEST_F (QuorumTests, EarlyExitWhenImpossible)
+{
+  const QuorumVerifier v(ec, signers, 3);
+
+  const auto res = v.VerifyMessage (MSG, {
+    "invalid", Sign (outsider), Sign (keys[0]), Sign (keys[1]),
+  });
+  EXPECT_FALSE (res.reached);
+  EXPECT_EQ (res.approvals, 0);
+  EXPECT_EQ (res.invalid, 1);
+  EXPECT_EQ (res.unauthorised, 1);
+
+  const auto tooFew = v.VerifyMessage (MSG, {Sign (keys[0]), Sign (keys[1])});
+  EXPECT_FALSE (tooFew.reached);
+  EXPECT_EQ (tooFew.approvals, 0);
+
+  EXPECT_FALSE (v.VerifyMessage (MSG, {}).reached);
+}
+
+TEST_F (QuorumTests, Hash)
+{
+  const QuorumVerifier v(ec, signers, 2, true);
+  const std::string hash = Keccak256 ("data");
+
+  const std::string compact = ECDSA::CompactSignature (
+      ec.SignHash (hash, keys[3]));
+  const auto res = v.VerifyHash (hash, {
+    ec.SignHash (hash, keys[2]), compact,
+  });
+  EXPECT_TRUE (res.reached);
+  EXPECT_EQ (res.approvals, 2);
+
+  const QuorumVerifier strict(ec, signers, 2);
+  const auto strictRes = strict.VerifyHash (hash, {
+    ec.SignHash (hash, keys[2]), compact,
+  });
+  EXPECT_FALSE (strictRes.reached);
+  EXPECT_EQ (strictRes.approvals, 1);
+  EXPECT_EQ (strictRes.invalid, 1);
+
+  EXPECT_DEATH (v.VerifyHash ("foo", {}), "32 bytes");
+}
+
+TEST_F (QuorumTests, Parallel)
+{
+  const QuorumVerifier v(ec, signers, 4);
+
+  std::vector<std::string> sgns;
+  for (unsigned i = 0; i < 20; ++i)
+    sgns.push_back (Sign (i % 3 == 0 ? outsider : keys[i % keys.size ()]));
+
+  for (const unsigned threads : {1u, 4u, 0u})
+    {
+      const auto res = v.VerifyMessage (MSG, sgns, threads);
+      EXPECT_TRUE (res.reached);
+      EXPECT_GE (res.approvals, 4);
+    }
+
+  /* With only outsider signatures, the quorum cannot be reached.  */
+  std::vector<std::string> outsiders(20, Sign (outsider));
+  outsiders.push_back (Sign (keys[0]));
+  for (const unsigned threads : {1u, 4u, 0u})
+    EXPECT_FALSE (v.VerifyMessage (MSG, outsiders, threads).reached);
+}
+
+TEST_F (QuorumTests, InvalidSetup)
+{
+  EXPECT_DEATH (QuorumVerifier (ec, signers, 0), "positive");
+  EXPECT_DEATH (QuorumVerifier (ec, signers, 6), "exceeds");
+  EXPECT_DEATH (QuorumVerifier (ec, {signers[0], signers[0]}, 1), "distinct");
+  EXPECT_DEATH (QuorumVerifier (ec, {Address ()}, 1), "invalid");
+}
+
+} // anonymous namespace
+} // namespace ethutils
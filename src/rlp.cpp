@@ -0,0 +1,150 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "rlp.hpp"
+
+#include <glog/logging.h>
+
+namespace ethutils
+{
+
+namespace
+{
+
+/** Maximum payload length that uses the short header form.  */
+constexpr size_t SHORT_MAX = 55;
+
+/**
+ * Reads a big-endian length of the given number of bytes.  Returns false
+ * if it has leading zeros or does not fit.
+ */
+bool
+ReadLength (const std::string_view data, size_t& len)
+{
+  if (data.empty () || data.size () > sizeof (size_t) || data[0] == '\0')
+    return false;
+
+  len = 0;
+  for (const char c : data)
+    len = (len << 8) | static_cast<unsigned char> (c);
+
+  return true;
+}
+
+} // anonymous namespace
+
+bool
+RlpDecode (const std::string_view data, RlpItem& item, std::string_view& rest)
+{
+  if (data.empty ())
+    return false;
+
+  const unsigned char first = data[0];
+  size_t headerLen;
+  size_t payloadLen;
+
+  if (first < 0x80)
+    {
+      item.isList = false;
+      headerLen = 0;
+      payloadLen = 1;
+    }
+  else if (first < 0xC0)
+    {
+      item.isList = false;
+      if (first <= 0x80 + SHORT_MAX)
+        {
+          headerLen = 1;
+          payloadLen = first - 0x80;
+        }
+      else
+        {
+          const size_t lenLen = first - 0x80 - SHORT_MAX;
+          if (data.size () < 1 + lenLen
+                || !ReadLength (data.substr (1, lenLen), payloadLen)
+                || payloadLen <= SHORT_MAX)
+            return false;
+          headerLen = 1 + lenLen;
+        }
+    }
+  else
+    {
+      item.isList = true;
+      if (first <= 0xC0 + SHORT_MAX)
+        {
+          headerLen = 1;
+          payloadLen = first - 0xC0;
+        }
+      else
+        {
+          const size_t lenLen = first - 0xC0 - SHORT_MAX;
+          if (data.size () < 1 + lenLen
+                || !ReadLength (data.substr (1, lenLen), payloadLen)
+                || payloadLen <= SHORT_MAX)
+            return false;
+          headerLen = 1 + lenLen;
+        }
+    }
+
+  if (data.size () - headerLen < payloadLen)
+    return false;
+
+  item.payload = data.substr (headerLen, payloadLen);
+  item.encoded = data.substr (0, headerLen + payloadLen);
+  rest = data.substr (headerLen + payloadLen);
+
+  /* A single byte below 0x80 must be encoded as itself.  */
+  if (!item.isList && headerLen == 1 && payloadLen == 1
+        && static_cast<unsigned char> (item.payload[0]) < 0x80)
+    return false;
+
+  return true;
+}
+
+bool
+RlpDecodeList (std::string_view payload, std::vector<RlpItem>& items)
+{
+  items.clear ();
+  while (!payload.empty ())
+    {
+      RlpItem cur;
+      if (!RlpDecode (payload, cur, payload))
+        return false;
+      items.push_back (cur);
+    }
+
+  return true;
+}
+
+bool
+RlpDecodeUint (const RlpItem& item, uint64_t& val)
+{
+  if (item.isList || item.payload.size () > sizeof (val))
+    return false;
+  if (!item.payload.empty () && item.payload[0] == '\0')
+    return false;
+
+  val = 0;
+  for (const char c : item.payload)
+    val = (val << 8) | static_cast<unsigned char> (c);
+
+  return true;
+}
+
+std::string
+RlpHeader (const size_t len, const bool isList)
+{
+  const unsigned char base = isList ? 0xC0 : 0x80;
+
+  if (len <= SHORT_MAX)
+    return std::string (1, static_cast<char> (base + len));
+
+  std::string lenBytes;
+  for (size_t rem = len; rem > 0; rem >>= 8)
+    lenBytes.insert (lenBytes.begin (), static_cast<char> (rem & 0xFF));
+
+  return static_cast<char> (base + SHORT_MAX + lenBytes.size ()) + lenBytes;
+}
+
+} // namespace ethutils
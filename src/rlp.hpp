@@ -0,0 +1,68 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ETHUTILS_RLP_HPP
+#define ETHUTILS_RLP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ethutils
+{
+
+/**
+ * A single RLP-encoded item (byte string or list), referring to the
+ * underlying buffer without copying any data.
+ */
+struct RlpItem
+{
+
+  /** True if this is a list, false if it is a byte string.  */
+  bool isList = false;
+
+  /**
+   * The payload of the item.  For byte strings, this is the string itself.
+   * For lists, it is the concatenated encodings of all elements.
+   */
+  std::string_view payload;
+
+  /** The full encoding of the item, including its header.  */
+  std::string_view encoded;
+
+};
+
+/**
+ * Decodes the first RLP item from the given data.  On success, returns
+ * true and sets item, and rest to the data following the item.  Returns
+ * false if the data does not start with a valid (canonical) RLP item.
+ */
+bool RlpDecode (std::string_view data, RlpItem& item, std::string_view& rest);
+
+/**
+ * Decodes all elements of a list payload.  Returns false if the payload
+ * is not a valid concatenation of RLP items.
+ */
+bool RlpDecodeList (std::string_view payload, std::vector<RlpItem>& items);
+
+/**
+ * Decodes a byte string item as unsigned integer (big-endian without
+ * leading zeros).  Returns false if the item is a list, not canonical,
+ * or does not fit into 64 bits.
+ */
+bool RlpDecodeUint (const RlpItem& item, uint64_t& val);
+
+/**
+ * Returns the header (prefix) that is put before a payload of the given
+ * length when RLP-encoding a byte string or a list.  This does not
+ * include the special case of single bytes below 0x80 (which have no
+ * header).
+ */
+std::string RlpHeader (size_t len, bool isList);
+
+} // namespace ethutils
+
+#endif // ETHUTILS_RLP_HPP
@@ -0,0 +1,152 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "rlp.hpp"
+
+#include "hexutils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <glog/logging.h>
+
+namespace ethutils
+{
+namespace
+{
+
+class RlpTests : public testing::Test
+{
+
+protected:
+
+  /**
+   * Converts a hex string (without 0x) to binary.
+   */
+  static std::string
+  Bin (const std::string& hex)
+  {
+    std::string res;
+    CHECK (Unhexlify (hex, res));
+    return res;
+  }
+
+  /**
+   * Decodes a single item that must span the full data.
+   */
+  static bool
+  DecodeSingle (const std::string& data, RlpItem& item)
+  {
+    std::string_view rest;
+    return RlpDecode (data, item, rest) && rest.empty ();
+  }
+
+};
+
+TEST_F (RlpTests, Strings)
+{
+  /* The decoded views point into the data, so it has to outlive them.  */
+  RlpItem item;
+
+  const std::string single = Bin ("00");
+  ASSERT_TRUE (DecodeSingle (single, item));
+  EXPECT_FALSE (item.isList);
+  EXPECT_EQ (item.payload, single);
+
+  const std::string empty = Bin ("80");
+  ASSERT_TRUE (DecodeSingle (empty, item));
+  EXPECT_EQ (item.payload, "");
+
+  const std::string dog = Bin ("83") + "dog";
+  ASSERT_TRUE (DecodeSingle (dog, item));
+  EXPECT_EQ (item.payload, "dog");
+  EXPECT_EQ (item.encoded, dog);
+
+  const std::string longStr(60, 'x');
+  const std::string longEncoded = Bin ("b83c") + longStr;
+  ASSERT_TRUE (DecodeSingle (longEncoded, item));
+  EXPECT_EQ (item.payload, longStr);
+}
+
+TEST_F (RlpTests, Lists)
+{
+  const std::string data = Bin ("c88363617483646f67");
+  RlpItem item;
+  ASSERT_TRUE (DecodeSingle (data, item));
+  EXPECT_TRUE (item.isList);
+
+  std::vector<RlpItem> elements;
+  ASSERT_TRUE (RlpDecodeList (item.payload, elements));
+  ASSERT_EQ (elements.size (), 2);
+  EXPECT_EQ (elements[0].payload, "cat");
+  EXPECT_EQ (elements[1].payload, "dog");
+
+  const std::string empty = Bin ("c0");
+  ASSERT_TRUE (DecodeSingle (empty, item));
+  EXPECT_TRUE (item.isList);
+  ASSERT_TRUE (RlpDecodeList (item.payload, elements));
+  EXPECT_TRUE (elements.empty ());
+}
+
+TEST_F (RlpTests, Rest)
+{
+  const std::string data = Bin ("8363617483646f67");
+  RlpItem item;
+  std::string_view rest;
+  ASSERT_TRUE (RlpDecode (data, item, rest));
+  EXPECT_EQ (item.payload, "cat");
+  EXPECT_EQ (rest, Bin ("83646f67"));
+}
+
+TEST_F (RlpTests, Invalid)
+{
+  RlpItem item;
+  std::string_view rest;
+
+  EXPECT_FALSE (RlpDecode ("", item, rest));
+  /* Truncated payloads.  */
+  EXPECT_FALSE (RlpDecode (Bin ("83") + "do", item, rest));
+  EXPECT_FALSE (RlpDecode (Bin ("c3") + "ab", item, rest));
+  EXPECT_FALSE (RlpDecode (Bin ("b8"), item, rest));
+  /* Non-canonical encodings.  */
+  EXPECT_FALSE (RlpDecode (Bin ("8100"), item, rest));
+  EXPECT_FALSE (RlpDecode (Bin ("b803") + "dog", item, rest));
+  EXPECT_FALSE (RlpDecode (Bin ("b9003c") + std::string (60, 'x'),
+                           item, rest));
+
+  std::vector<RlpItem> elements;
+  EXPECT_FALSE (RlpDecodeList (Bin ("8363617483"), elements));
+}
+
+TEST_F (RlpTests, DecodeUint)
+{
+  const auto decode = [] (const std::string& hex, uint64_t& val)
+    {
+      const std::string data = Bin (hex);
+      RlpItem item;
+      CHECK (DecodeSingle (data, item));
+      return RlpDecodeUint (item, val);
+    };
+
+  uint64_t val;
+  ASSERT_TRUE (decode ("80", val));
+  EXPECT_EQ (val, 0);
+  ASSERT_TRUE (decode ("820400", val));
+  EXPECT_EQ (val, 1'024);
+
+  EXPECT_FALSE (decode ("820004", val));
+  EXPECT_FALSE (decode ("89010000000000000000", val));
+  EXPECT_FALSE (decode ("c0", val));
+}
+
+TEST_F (RlpTests, Header)
+{
+  EXPECT_EQ (RlpHeader (0, false), Bin ("80"));
+  EXPECT_EQ (RlpHeader (3, false), Bin ("83"));
+  EXPECT_EQ (RlpHeader (55, true), Bin ("f7"));
+  EXPECT_EQ (RlpHeader (56, false), Bin ("b838"));
+  EXPECT_EQ (RlpHeader (1'024, true), Bin ("f90400"));
+}
+
+} // anonymous namespace
+} // namespace ethutils
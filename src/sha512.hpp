@@ -0,0 +1,66 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ETHUTILS_SHA512_HPP
+#define ETHUTILS_SHA512_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ethutils
+{
+
+/**
+ * Incremental SHA-512 hasher.  This is used internally for the HMAC-SHA512
+ * needed by BIP-32 key derivation.
+ */
+class Sha512Hasher
+{
+
+private:
+
+  /** The hash state.  */
+  uint64_t state[8];
+
+  /** Buffer for the current (incomplete) block.  */
+  unsigned char block[128];
+
+  /** Number of bytes in the current block.  */
+  size_t pos;
+
+  /** Total number of bytes hashed so far.  */
+  uint64_t total;
+
+  /**
+   * Processes the full block in the buffer.
+   */
+  void Compress ();
+
+public:
+
+  Sha512Hasher ();
+
+  /**
+   * Adds more data to the hash.
+   */
+  Sha512Hasher& Update (const unsigned char* data, size_t len);
+
+  /**
+   * Finishes the hash and writes the 64-byte result to out.  The instance
+   * must not be used anymore afterwards.
+   */
+  void Finish (unsigned char* out);
+
+};
+
+/**
+ * Computes HMAC-SHA512 of the given data with the given key, and writes
+ * the 64-byte result to out.
+ */
+void HmacSha512 (const unsigned char* key, size_t keyLen,
+                 const unsigned char* data, size_t len, unsigned char* out);
+
+} // namespace ethutils
+
+#endif // ETHUTILS_SHA512_HPP
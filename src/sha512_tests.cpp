@@ -0,0 +1,86 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "sha512.hpp"
+
+#include "hexutils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace ethutils
+{
+namespace
+{
+
+class Sha512Tests : public testing::Test
+{
+
+protected:
+
+  /**
+   * Hashes the data (in chunks of the given size) and returns the
+   * hash as hex.
+   */
+  static std::string
+  Hash (const std::string& data, const size_t chunk = 1'000)
+  {
+    Sha512Hasher hasher;
+    for (size_t i = 0; i < data.size (); i += chunk)
+      {
+        const std::string part = data.substr (i, chunk);
+        hasher.Update (reinterpret_cast<const unsigned char*> (part.data ()),
+                       part.size ());
+      }
+
+    std::string res(64, '\0');
+    hasher.Finish (reinterpret_cast<unsigned char*> (&res[0]));
+    return Hexlify (res);
+  }
+
+  static std::string
+  Hmac (const std::string& key, const std::string& data)
+  {
+    std::string res(64, '\0');
+    HmacSha512 (reinterpret_cast<const unsigned char*> (key.data ()),
+                key.size (),
+                reinterpret_cast<const unsigned char*> (data.data ()),
+                data.size (), reinterpret_cast<unsigned char*> (&res[0]));
+    return Hexlify (res);
+  }
+
+};
+
+TEST_F (Sha512Tests, Hash)
+{
+  EXPECT_EQ (Hash (""),
+      "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce"
+      "47d0d13c5d85f2b0ff8318d2877eec2f63b931bd47417a81a538327af927da3e");
+  EXPECT_EQ (Hash ("abc"),
+      "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+      "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f");
+
+  const std::string long1k(1'000, 'a');
+  const std::string expected =
+      "67ba5535a46e3f86dbfbed8cbbaf0125c76ed549ff8b0b9e03e0c88cf90fa634"
+      "fa7b12b47d77b694de488ace8d9a65967dc96df599727d3292a8d9d447709c97";
+  for (const size_t chunk : {1u, 111u, 128u, 1'000u})
+    EXPECT_EQ (Hash (long1k, chunk), expected) << chunk;
+}
+
+TEST_F (Sha512Tests, Hmac)
+{
+  /* Test vectors from RFC 4231.  */
+  EXPECT_EQ (Hmac (std::string (20, '\x0b'), "Hi There"),
+      "87aa7cdea5ef619d4ff0b4241a1d6cb02379f4e2ce4ec2787ad0b30545e17cde"
+      "daa833b7d6b8a702038b274eaea3f4e4be9d914eeb61f1702e696c203a126854");
+  EXPECT_EQ (Hmac (std::string (131, '\xaa'),
+                   "Test Using Larger Than Block-Size Key - Hash Key First"),
+      "80b24263c7c1a3ebb71493c1dd7be8b49b46d1f41b4aeec1121b013783f8f352"
+      "6b56d037e05f2598bd0fd2215d6a1e5295e64f73f63f0aec8b915a985d786598");
+}
+
+} // anonymous namespace
+} // namespace ethutils
@@ -0,0 +1,607 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "siwe.hpp"
+
+#include "hexutils.hpp"
+#include "parallel.hpp"
+
+#include <glog/logging.h>
+
+#include <random>
+
+namespace ethutils
+{
+
+namespace
+{
+
+/** The fixed part of the first line of a SIWE message.  */
+constexpr std::string_view HEADER_SUFFIX
+    = " wants you to sign in with your Ethereum account:";
+
+/** Minimum length of nonces.  */
+constexpr size_t MIN_NONCE_LENGTH = 8;
+
+/** Length of nonces generated by MemoryNonceStore.  */
+constexpr size_t ISSUED_NONCE_LENGTH = 17;
+
+constexpr std::string_view ALPHANUMERIC
+    = "0123456789"
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+      "abcdefghijklmnopqrstuvwxyz";
+
+/**
+ * Helper class to split the message text into lines.
+ */
+class LineReader
+{
+
+private:
+
+  /** The remaining text.  */
+  std::string_view rest;
+
+  /** Set when the last line has been returned.  */
+  bool atEnd = false;
+
+public:
+
+  explicit LineReader (const std::string_view text)
+    : rest(text)
+  {}
+
+  /**
+   * Returns the next line (without its LF) in line, or false if there
+   * are no more lines.  A trailing LF yields a final empty line.
+   */
+  bool
+  Next (std::string_view& line)
+  {
+    if (atEnd)
+      return false;
+
+    const size_t pos = rest.find ('\n');
+    if (pos == std::string_view::npos)
+      {
+        line = rest;
+        atEnd = true;
+        return true;
+      }
+
+    line = rest.substr (0, pos);
+    rest = rest.substr (pos + 1);
+    return true;
+  }
+
+};
+
+bool
+StartsWith (const std::string_view str, const std::string_view prefix)
+{
+  return str.substr (0, prefix.size ()) == prefix;
+}
+
+/**
+ * If line starts with the given field prefix, sets value to the rest and
+ * returns true.
+ */
+bool
+ReadField (const std::string_view line, const std::string_view prefix,
+           std::string_view& value)
+{
+  if (!StartsWith (line, prefix))
+    return false;
+
+  value = line.substr (prefix.size ());
+  return true;
+}
+
+bool
+IsDigit (const char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+bool
+IsAlpha (const char c)
+{
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+bool
+IsHexDigit (const char c)
+{
+  return IsDigit (c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+/**
+ * Checks that a string is non-empty and has no whitespace, which is what
+ * we require for the domain and URIs.
+ */
+bool
+IsToken (const std::string_view str)
+{
+  if (str.empty ())
+    return false;
+
+  for (const char c : str)
+    if (c == ' ' || c == '\t' || c == '\r')
+      return false;
+
+  return true;
+}
+
+/**
+ * Checks a URI scheme (ALPHA *( ALPHA / DIGIT / "+" / "-" / "." )).
+ */
+bool
+IsScheme (const std::string_view str)
+{
+  if (str.empty () || !IsAlpha (str[0]))
+    return false;
+
+  for (const char c : str)
+    if (!IsAlpha (c) && !IsDigit (c) && c != '+' && c != '-' && c != '.')
+      return false;
+
+  return true;
+}
+
+/**
+ * Checks that a string looks like an absolute URI, i.e. is a token
+ * starting with a scheme and colon.  The rest is not validated further.
+ */
+bool
+IsUri (const std::string_view str)
+{
+  const size_t colon = str.find (':');
+  return colon != std::string_view::npos && IsScheme (str.substr (0, colon))
+            && IsToken (str);
+}
+
+bool
+IsAddress (const std::string_view str)
+{
+  if (str.size () != 2 + 2 * Address::BINARY_SIZE || !StartsWith (str, "0x"))
+    return false;
+
+  for (const char c : str.substr (2))
+    if (!IsHexDigit (c))
+      return false;
+
+  return true;
+}
+
+bool
+IsNonce (const std::string_view str)
+{
+  if (str.size () < MIN_NONCE_LENGTH)
+    return false;
+
+  for (const char c : str)
+    if (!IsAlpha (c) && !IsDigit (c))
+      return false;
+
+  return true;
+}
+
+/**
+ * Parses a non-negative decimal number.  Returns false if the string is
+ * empty, not a number or overflows.
+ */
+bool
+ParseDecimal (const std::string_view str, uint64_t& val)
+{
+  if (str.empty ())
+    return false;
+
+  val = 0;
+  for (const char c : str)
+    {
+      if (!IsDigit (c))
+        return false;
+
+      const uint64_t digit = c - '0';
+      if (val > (UINT64_MAX - digit) / 10)
+        return false;
+      val = 10 * val + digit;
+    }
+
+  return true;
+}
+
+/**
+ * Parses a fixed-width decimal number of the given number of digits.
+ */
+bool
+ParseFixed (const std::string_view str, const size_t pos, const size_t digits,
+            int& val)
+{
+  if (pos + digits > str.size ())
+    return false;
+
+  val = 0;
+  for (size_t i = pos; i < pos + digits; ++i)
+    {
+      if (!IsDigit (str[i]))
+        return false;
+      val = 10 * val + (str[i] - '0');
+    }
+
+  return true;
+}
+
+bool
+IsLeapYear (const int y)
+{
+  return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+int
+DaysInMonth (const int y, const int m)
+{
+  static constexpr int DAYS[12] = {31, 28, 31, 30, 31, 30,
+                                   31, 31, 30, 31, 30, 31};
+  if (m == 2 && IsLeapYear (y))
+    return 29;
+  return DAYS[m - 1];
+}
+
+/**
+ * Returns the number of days since 1970-01-01 for a date in the
+ * proleptic Gregorian calendar.
+ */
+int64_t
+DaysFromCivil (int64_t y, const int m, const int d)
+{
+  if (m <= 2)
+    --y;
+
+  const int64_t era = (y >= 0 ? y : y - 399) / 400;
+  const int64_t yoe = y - era * 400;
+  const int64_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+  return era * 146097 + doe - 719468;
+}
+
+/**
+ * Parses an optional timestamp field, setting the flag, string and
+ * time value if it is present.  Returns false if the field is present
+ * but invalid.
+ */
+bool
+ReadTimeField (const std::string_view line, const std::string_view prefix,
+               bool& has, std::string_view& str, int64_t& time)
+{
+  if (!ReadField (line, prefix, str))
+    return true;
+
+  has = true;
+  return ParseRfc3339 (str, time);
+}
+
+} // anonymous namespace
+
+bool
+ParseRfc3339 (const std::string_view str, int64_t& time)
+{
+  /* The format is YYYY-MM-DDTHH:MM:SS[.frac](Z|+HH:MM|-HH:MM).  */
+
+  int year, month, day, hour, minute, second;
+  if (!ParseFixed (str, 0, 4, year) || str.size () < 19 || str[4] != '-'
+        || !ParseFixed (str, 5, 2, month) || str[7] != '-'
+        || !ParseFixed (str, 8, 2, day)
+        || (str[10] != 'T' && str[10] != 't')
+        || !ParseFixed (str, 11, 2, hour) || str[13] != ':'
+        || !ParseFixed (str, 14, 2, minute) || str[16] != ':'
+        || !ParseFixed (str, 17, 2, second))
+    return false;
+
+  if (month < 1 || month > 12 || day < 1 || day > DaysInMonth (year, month)
+        || hour > 23 || minute > 59 || second > 60)
+    return false;
+
+  size_t pos = 19;
+  if (pos < str.size () && str[pos] == '.')
+    {
+      ++pos;
+      const size_t fracStart = pos;
+      while (pos < str.size () && IsDigit (str[pos]))
+        ++pos;
+      if (pos == fracStart)
+        return false;
+    }
+
+  int64_t offset;
+  const std::string_view zone = str.substr (pos);
+  if (zone == "Z" || zone == "z")
+    offset = 0;
+  else
+    {
+      int offHour, offMinute;
+      if (zone.size () != 6 || (zone[0] != '+' && zone[0] != '-')
+            || !ParseFixed (zone, 1, 2, offHour) || zone[3] != ':'
+            || !ParseFixed (zone, 4, 2, offMinute)
+            || offHour > 23 || offMinute > 59)
+        return false;
+
+      offset = 60 * (60 * offHour + offMinute);
+      if (zone[0] == '-')
+        offset = -offset;
+    }
+
+  /* A leap second is mapped to the following second, as Unix time
+     does not represent them.  */
+  time = DaysFromCivil (year, month, day) * 86400
+            + 3600 * hour + 60 * minute + second - offset;
+  return true;
+}
+
+bool
+ParseSiweMessage (const std::string_view text, SiweMessage& msg)
+{
+  msg = SiweMessage ();
+
+  LineReader reader(text);
+  std::string_view line;
+
+  /* Header line with the optional scheme and the domain.  */
+  if (!reader.Next (line) || line.size () < HEADER_SUFFIX.size ()
+        || line.substr (line.size () - HEADER_SUFFIX.size ()) != HEADER_SUFFIX)
+    return false;
+  msg.domain = line.substr (0, line.size () - HEADER_SUFFIX.size ());
+  const size_t schemeEnd = msg.domain.find ("://");
+  if (schemeEnd != std::string_view::npos)
+    {
+      msg.scheme = msg.domain.substr (0, schemeEnd);
+      msg.domain = msg.domain.substr (schemeEnd + 3);
+      if (!IsScheme (msg.scheme))
+        return false;
+    }
+  if (!IsToken (msg.domain))
+    return false;
+
+  /* Address followed by an empty line.  */
+  if (!reader.Next (msg.address) || !IsAddress (msg.address))
+    return false;
+  if (!reader.Next (line) || !line.empty ())
+    return false;
+
+  /* Optional statement, followed by another empty line.  */
+  if (!reader.Next (line))
+    return false;
+  if (!line.empty ())
+    {
+      msg.statement = line;
+      if (!reader.Next (line) || !line.empty ())
+        return false;
+    }
+
+  /* The required fields.  */
+  std::string_view value;
+  if (!reader.Next (line) || !ReadField (line, "URI: ", msg.uri)
+        || !IsUri (msg.uri))
+    return false;
+  if (!reader.Next (line) || !ReadField (line, "Version: ", msg.version)
+        || msg.version != "1")
+    return false;
+  if (!reader.Next (line) || !ReadField (line, "Chain ID: ", value)
+        || !ParseDecimal (value, msg.chainId))
+    return false;
+  if (!reader.Next (line) || !ReadField (line, "Nonce: ", msg.nonce)
+        || !IsNonce (msg.nonce))
+    return false;
+  if (!reader.Next (line) || !ReadField (line, "Issued At: ", msg.issuedAt)
+        || !ParseRfc3339 (msg.issuedAt, msg.issuedAtUnix))
+    return false;
+
+  /* The optional fields, which have to appear in this order if present.
+     have is true while line holds a line that has not been consumed.  */
+  bool have = reader.Next (line);
+
+  if (have)
+    {
+      if (!ReadTimeField (line, "Expiration Time: ", msg.hasExpirationTime,
+                          msg.expirationTime, msg.expirationUnix))
+        return false;
+      if (msg.hasExpirationTime)
+        have = reader.Next (line);
+    }
+
+  if (have)
+    {
+      if (!ReadTimeField (line, "Not Before: ", msg.hasNotBefore,
+                          msg.notBefore, msg.notBeforeUnix))
+        return false;
+      if (msg.hasNotBefore)
+        have = reader.Next (line);
+    }
+
+  if (have && ReadField (line, "Request ID: ", msg.requestId))
+    have = reader.Next (line);
+
+  if (have && line == "Resources:")
+    {
+      const char* begin = nullptr;
+      const char* end = nullptr;
+      while ((have = reader.Next (line)) && StartsWith (line, "- "))
+        {
+          if (!IsUri (line.substr (2)))
+            return false;
+          if (begin == nullptr)
+            begin = line.data ();
+          end = line.data () + line.size ();
+        }
+      if (begin != nullptr)
+        msg.resources = std::string_view (begin, end - begin);
+    }
+
+  /* There must be nothing else after the fields.  */
+  return !have;
+}
+
+std::vector<std::string_view>
+SiweMessage::GetResources () const
+{
+  std::vector<std::string_view> res;
+
+  LineReader reader(resources);
+  std::string_view line;
+  if (!resources.empty ())
+    while (reader.Next (line))
+      res.push_back (line.substr (2));
+
+  return res;
+}
+
+/* ************************************************************************** */
+
+MemoryNonceStore::MemoryNonceStore (const size_t maxN)
+  : maxNonces(maxN)
+{
+  CHECK_GT (maxNonces, 0);
+}
+
+bool
+MemoryNonceStore::Insert (const std::string& nonce)
+{
+  const auto ins = issued.emplace (nonce, nextSeq);
+  if (!ins.second)
+    return false;
+  byAge.emplace (nextSeq, ins.first->first);
+  ++nextSeq;
+
+  if (issued.size () > maxNonces)
+    {
+      auto oldest = byAge.begin ();
+      issued.erase (issued.find (oldest->second));
+      byAge.erase (oldest);
+    }
+
+  return true;
+}
+
+std::string
+MemoryNonceStore::Issue ()
+{
+  std::random_device rnd;
+  std::uniform_int_distribution<size_t> dist(0, ALPHANUMERIC.size () - 1);
+
+  std::lock_guard<std::mutex> lock(mut);
+  while (true)
+    {
+      std::string nonce(ISSUED_NONCE_LENGTH, '\0');
+      for (auto& c : nonce)
+        c = ALPHANUMERIC[dist (rnd)];
+
+      if (Insert (nonce))
+        return nonce;
+    }
+}
+
+void
+MemoryNonceStore::Add (const std::string& nonce)
+{
+  std::lock_guard<std::mutex> lock(mut);
+  Insert (nonce);
+}
+
+bool
+MemoryNonceStore::Consume (const std::string_view nonce)
+{
+  std::lock_guard<std::mutex> lock(mut);
+
+  auto mit = issued.find (nonce);
+  if (mit == issued.end ())
+    return false;
+
+  byAge.erase (mit->second);
+  issued.erase (mit);
+  return true;
+}
+
+/* ************************************************************************** */
+
+SiweVerifier::SiweVerifier (const ECDSA& e, const Options& o)
+  : ec(e), options(o)
+{}
+
+SiweVerifier::Result
+SiweVerifier::Verify (const std::string_view text,
+                      const std::string_view sgnHex, const int64_t now,
+                      SiweMessage& msg, std::string& sgnBin) const
+{
+  if (!ParseSiweMessage (text, msg))
+    {
+      /* The text is untrusted and may be large, so it is not logged.  */
+      VLOG (1) << "Malformed SIWE message of " << text.size () << " bytes";
+      return Result::MALFORMED;
+    }
+
+  if (!options.domain.empty () && msg.domain != options.domain)
+    return Result::WRONG_DOMAIN;
+  if (options.chainId != 0 && msg.chainId != options.chainId)
+    return Result::WRONG_CHAIN;
+
+  if (msg.hasExpirationTime && now >= msg.expirationUnix)
+    return Result::EXPIRED;
+  if (msg.hasNotBefore && now < msg.notBeforeUnix)
+    return Result::NOT_YET_VALID;
+
+  if (!StartsWith (sgnHex, "0x") || !UnhexlifyAnyCase (sgnHex.substr (2), sgnBin))
+    return Result::INVALID_SIGNATURE;
+
+  Address::Binary signer;
+  if (!ec.RecoverSigner (ECDSA::MessageHash (text), sgnBin, signer,
+                         options.allowCompact))
+    return Result::INVALID_SIGNATURE;
+
+  /* Comparing the checksummed form against the message also enforces that
+     the address is given with a correct EIP-55 checksum.  */
+  char signerHex[2 * Address::BINARY_SIZE];
+  Address::FormatChecksummed (signer, signerHex);
+  const std::string_view expected(signerHex, sizeof (signerHex));
+  if (msg.address.substr (2) != expected)
+    return Result::INVALID_SIGNATURE;
+
+  /* The nonce is only consumed once everything else has been verified,
+     so that invalid attempts cannot burn nonces.  */
+  if (options.nonces != nullptr && !options.nonces->Consume (msg.nonce))
+    return Result::INVALID_NONCE;
+
+  return Result::VALID;
+}
+
+SiweVerifier::Result
+SiweVerifier::Verify (const std::string_view text,
+                      const std::string_view sgnHex, const int64_t now,
+                      SiweMessage& msg) const
+{
+  std::string sgnBin;
+  return Verify (text, sgnHex, now, msg, sgnBin);
+}
+
+std::vector<SiweVerifier::Result>
+SiweVerifier::VerifyBatch (const std::vector<Request>& reqs, const int64_t now,
+                           const unsigned threads) const
+{
+  std::vector<Result> res(reqs.size ());
+
+  ParallelFor (reqs.size (), threads, [&] (const size_t begin, const size_t end)
+    {
+      SiweMessage msg;
+      std::string sgnBin;
+
+      for (size_t i = begin; i < end; ++i)
+        res[i] = Verify (reqs[i].message, reqs[i].signature, now, msg, sgnBin);
+    });
+
+  return res;
+}
+
+/* ************************************************************************** */
+
+} // namespace ethutils
@@ -0,0 +1,268 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ETHUTILS_SIWE_HPP
+#define ETHUTILS_SIWE_HPP
+
+#include "ecdsa.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ethutils
+{
+
+/**
+ * A Sign-In with Ethereum message (EIP-4361) as parsed from its text.
+ * All string fields are views into the text, which must outlive the
+ * instance.  Optional fields that are not present are empty.
+ */
+struct SiweMessage
+{
+
+  /** The URI scheme before the domain (if present).  */
+  std::string_view scheme;
+
+  /** The domain requesting the sign-in.  */
+  std::string_view domain;
+
+  /** The signing address as given in the message (with 0x prefix).  */
+  std::string_view address;
+
+  /** The statement (optional).  */
+  std::string_view statement;
+
+  std::string_view uri;
+  std::string_view version;
+  uint64_t chainId = 0;
+  std::string_view nonce;
+
+  /** The issued-at time as string and as Unix timestamp.  */
+  std::string_view issuedAt;
+  int64_t issuedAtUnix = 0;
+
+  /** The expiration time (if hasExpirationTime).  */
+  bool hasExpirationTime = false;
+  std::string_view expirationTime;
+  int64_t expirationUnix = 0;
+
+  /** The not-before time (if hasNotBefore).  */
+  bool hasNotBefore = false;
+  std::string_view notBefore;
+  int64_t notBeforeUnix = 0;
+
+  std::string_view requestId;
+
+  /**
+   * The lines of the resources list, including their "- " prefixes
+   * and separated by newlines.  Use GetResources to split them.
+   */
+  std::string_view resources;
+
+  /**
+   * Returns the individual resource URIs.
+   */
+  std::vector<std::string_view> GetResources () const;
+
+};
+
+/**
+ * Parses a SIWE message.  Returns false if it does not follow the
+ * format of EIP-4361.  Parsing does not allocate memory.  The address is
+ * only checked to be 40 hex characters here, and its checksum is verified
+ * against the signer by SiweVerifier.
+ */
+bool ParseSiweMessage (std::string_view text, SiweMessage& msg);
+
+/**
+ * Parses an RFC 3339 timestamp (as used in SIWE messages) into a Unix
+ * timestamp in seconds (fractional seconds are ignored).  Returns false
+ * if the string is invalid.
+ */
+bool ParseRfc3339 (std::string_view str, int64_t& time);
+
+/**
+ * Interface for checking and consuming the nonces of SIWE messages, which
+ * prevents replaying sign-ins.  Implementations must be thread-safe.
+ */
+class SiweNonceStore
+{
+
+public:
+
+  virtual ~SiweNonceStore () = default;
+
+  /**
+   * Checks if the nonce is valid (i.e. it has been issued and not yet used)
+   * and marks it as used.  Returns false if the nonce is invalid.
+   */
+  virtual bool Consume (std::string_view nonce) = 0;
+
+};
+
+/**
+ * Simple nonce store that keeps the issued nonces in memory.  The number of
+ * outstanding nonces is capped, and when the limit is reached, the oldest
+ * ones are dropped (so that nonces issued for sign-ins that are never
+ * completed do not accumulate forever).
+ */
+class MemoryNonceStore : public SiweNonceStore
+{
+
+private:
+
+  /** Lock for the set of nonces.  */
+  std::mutex mut;
+
+  /** Maximum number of outstanding nonces.  */
+  const size_t maxNonces;
+
+  /**
+   * The nonces that have been issued and not yet consumed, with the
+   * sequence number of when they were added.  The comparator is
+   * transparent, so that they can be looked up by std::string_view.
+   */
+  std::map<std::string, uint64_t, std::less<>> issued;
+
+  /** The issued nonces by their sequence number, i.e. oldest first.  */
+  std::map<uint64_t, std::string_view> byAge;
+
+  /** Sequence number for the next nonce.  */
+  uint64_t nextSeq = 0;
+
+  /**
+   * Adds a nonce to the set (with the lock held), dropping the oldest one
+   * if the limit is exceeded.  Returns false if it is already present.
+   */
+  bool Insert (const std::string& nonce);
+
+public:
+
+  /** Default limit for the number of outstanding nonces.  */
+  static constexpr size_t DEFAULT_MAX_NONCES = 100'000;
+
+  explicit MemoryNonceStore (size_t maxN = DEFAULT_MAX_NONCES);
+
+  MemoryNonceStore (const MemoryNonceStore&) = delete;
+  void operator= (const MemoryNonceStore&) = delete;
+
+  /**
+   * Generates a new random nonce and marks it as issued.
+   */
+  std::string Issue ();
+
+  /**
+   * Marks the given nonce as issued.
+   */
+  void Add (const std::string& nonce);
+
+  bool Consume (std::string_view nonce) override;
+
+};
+
+/**
+ * Verifier for SIWE sign-ins.  It checks the message format, that it is meant
+ * for the expected domain and chain and currently valid, and that the
+ * signature has been made by the address in the message.  Finally, the
+ * nonce is consumed in the nonce store (if one is used).
+ */
+class SiweVerifier
+{
+
+public:
+
+  /** The possible outcomes of verifying a sign-in.  */
+  enum class Result
+  {
+    VALID,
+    /** The message is not a valid SIWE message.  */
+    MALFORMED,
+    /** The domain or chain ID does not match the expected ones.  */
+    WRONG_DOMAIN,
+    WRONG_CHAIN,
+    /** The message is expired or not yet valid.  */
+    EXPIRED,
+    NOT_YET_VALID,
+    /** The signature is invalid or not by the address in the message.  */
+    INVALID_SIGNATURE,
+    /** The nonce store rejected the nonce.  */
+    INVALID_NONCE,
+  };
+
+  /**
+   * Settings for the verifier.
+   */
+  struct Options
+  {
+
+    /** The expected domain.  If empty, the domain is not checked.  */
+    std::string domain;
+
+    /** The expected chain ID.  If zero, the chain is not checked.  */
+    uint64_t chainId = 0;
+
+    /**
+     * The nonce store to use (not owned).  If null, nonces are not checked
+     * and the caller must take care of replay protection itself.
+     */
+    SiweNonceStore* nonces = nullptr;
+
+    /** Whether or not EIP-2098 compact signatures are accepted.  */
+    bool allowCompact = false;
+
+  };
+
+  /** A sign-in to verify in a batch.  */
+  struct Request
+  {
+    std::string_view message;
+    /** The signature as hex with 0x prefix.  */
+    std::string_view signature;
+  };
+
+private:
+
+  const ECDSA& ec;
+  const Options options;
+
+  /**
+   * Verifies a sign-in, using the given string as buffer for the decoded
+   * signature (so that it can be reused in batches).
+   */
+  Result Verify (std::string_view text, std::string_view sgnHex, int64_t now,
+                 SiweMessage& msg, std::string& sgnBin) const;
+
+public:
+
+  explicit SiweVerifier (const ECDSA& e, const Options& o);
+
+  SiweVerifier (const SiweVerifier&) = delete;
+  void operator= (const SiweVerifier&) = delete;
+
+  /**
+   * Verifies a sign-in message with its signature (as hex with 0x prefix,
+   * see Options::allowCompact) at the given current Unix time.  The parsed message
+   * is returned in msg, whose fields refer to text.
+   */
+  Result Verify (std::string_view text, std::string_view sgnHex, int64_t now,
+                 SiweMessage& msg) const;
+
+  /**
+   * Verifies a batch of sign-ins at the given time, split across up to
+   * the given number of threads (zero means the hardware concurrency).
+   */
+  std::vector<Result> VerifyBatch (const std::vector<Request>& reqs,
+                                   int64_t now, unsigned threads = 0) const;
+
+};
+
+} // namespace ethutils
+
+#endif // ETHUTILS_SIWE_HPP
@@ -0,0 +1,405 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "siwe.hpp"
+
+#include <gtest/gtest.h>
+
+#include <glog/logging.h>
+
+#include <cctype>
+
+namespace ethutils
+{
+namespace
+{
+
+/** Example message from EIP-4361 with all optional fields.  */
+constexpr std::string_view FULL_MESSAGE =
+    "https://example.com wants you to sign in with your Ethereum account:\n"
+    "0xC02aaA39b223FE8D0A0e5C4F27eAD9083C756Cc2\n"
+    "\n"
+    "I accept the ExampleOrg Terms of Service: https://example.com/tos\n"
+    "\n"
+    "URI: https://example.com/login\n"
+    "Version: 1\n"
+    "Chain ID: 1\n"
+    "Nonce: 32891756\n"
+    "Issued At: 2021-09-30T16:25:24Z\n"
+    "Expiration Time: 2021-10-01T16:25:24.123+02:00\n"
+    "Not Before: 2021-09-30T16:00:00Z\n"
+    "Request ID: some-request\n"
+    "Resources:\n"
+    "- ipfs://bafybeiemxf5abjwjbikoz4mc3a3dla6ual3jsgpdr4cjr3oz3evfyavhwq/\n"
+    "- https://example.com/my-web2-claim.json";
+
+/** A message with only the required fields.  */
+constexpr std::string_view MINIMAL_MESSAGE =
+    "example.com wants you to sign in with your Ethereum account:\n"
+    "0xC02aaA39b223FE8D0A0e5C4F27eAD9083C756Cc2\n"
+    "\n"
+    "\n"
+    "URI: https://example.com/login\n"
+    "Version: 1\n"
+    "Chain ID: 137\n"
+    "Nonce: abcdEFGH1234\n"
+    "Issued At: 2021-09-30T16:25:24Z";
+
+TEST (SiweParsingTests, FullMessage)
+{
+  SiweMessage msg;
+  ASSERT_TRUE (ParseSiweMessage (FULL_MESSAGE, msg));
+
+  EXPECT_EQ (msg.scheme, "https");
+  EXPECT_EQ (msg.domain, "example.com");
+  EXPECT_EQ (msg.address, "0xC02aaA39b223FE8D0A0e5C4F27eAD9083C756Cc2");
+  EXPECT_EQ (msg.statement,
+             "I accept the ExampleOrg Terms of Service: "
+             "https://example.com/tos");
+  EXPECT_EQ (msg.uri, "https://example.com/login");
+  EXPECT_EQ (msg.version, "1");
+  EXPECT_EQ (msg.chainId, 1);
+  EXPECT_EQ (msg.nonce, "32891756");
+  EXPECT_EQ (msg.issuedAt, "2021-09-30T16:25:24Z");
+  EXPECT_EQ (msg.issuedAtUnix, 1633019124);
+  EXPECT_TRUE (msg.hasExpirationTime);
+  EXPECT_EQ (msg.expirationUnix, 1633019124 + 86400 - 7200);
+  EXPECT_TRUE (msg.hasNotBefore);
+  EXPECT_EQ (msg.notBeforeUnix, 1633017600);
+  EXPECT_EQ (msg.requestId, "some-request");
+
+  const auto resources = msg.GetResources ();
+  ASSERT_EQ (resources.size (), 2);
+  EXPECT_EQ (resources[0],
+             "ipfs://bafybeiemxf5abjwjbikoz4mc3a3dla6ual3jsgpdr4cjr3oz3evf"
+             "yavhwq/");
+  EXPECT_EQ (resources[1], "https://example.com/my-web2-claim.json");
+}
+
+TEST (SiweParsingTests, MinimalMessage)
+{
+  SiweMessage msg;
+  ASSERT_TRUE (ParseSiweMessage (MINIMAL_MESSAGE, msg));
+
+  EXPECT_EQ (msg.scheme, "");
+  EXPECT_EQ (msg.domain, "example.com");
+  EXPECT_EQ (msg.statement, "");
+  EXPECT_EQ (msg.chainId, 137);
+  EXPECT_FALSE (msg.hasExpirationTime);
+  EXPECT_FALSE (msg.hasNotBefore);
+  EXPECT_EQ (msg.requestId, "");
+  EXPECT_TRUE (msg.GetResources ().empty ());
+}
+
+TEST (SiweParsingTests, Invalid)
+{
+  const std::string minimal(MINIMAL_MESSAGE);
+  const auto replaced = [&minimal] (const std::string& from,
+                                    const std::string& to)
+    {
+      std::string res = minimal;
+      const size_t pos = res.find (from);
+      CHECK_NE (pos, std::string::npos);
+      res.replace (pos, from.size (), to);
+      return res;
+    };
+
+  for (const std::string& str : {
+          std::string (""),
+          minimal + "\n",
+          minimal + "\nfoo",
+          replaced ("example.com wants", "1x://example.com wants"),
+          replaced ("example.com wants", " wants"),
+          replaced ("account:", "account"),
+          replaced ("0xC02a", "C02a"),
+          replaced ("Cc2", "Cc"),
+          replaced ("Cc2", "Cx2"),
+          replaced ("\n\n\n", "\n\n"),
+          replaced ("\n\n\n", "\n\nfoo\nURI"),
+          replaced ("URI: https", "URI: "),
+          replaced ("Version: 1", "Version: 2"),
+          replaced ("Chain ID: 137", "Chain ID: "),
+          replaced ("Chain ID: 137", "Chain ID: 1x"),
+          replaced ("Chain ID: 137", "Chain ID: 99999999999999999999"),
+          replaced ("abcdEFGH1234", "abc123"),
+          replaced ("abcdEFGH1234", "abcd-EFGH1234"),
+          replaced ("2021-09-30T", "2021-02-29T"),
+          replaced ("16:25:24Z", "16:25:24"),
+          replaced ("Nonce", "Nonce:"),
+          replaced ("Version: 1\nChain ID: 137", "Chain ID: 137\nVersion: 1"),
+        })
+    {
+      SiweMessage msg;
+      EXPECT_FALSE (ParseSiweMessage (str, msg)) << str;
+    }
+
+  /* Optional fields out of order.  */
+  SiweMessage msg;
+  EXPECT_FALSE (ParseSiweMessage (
+      minimal + "\nRequest ID: foo\nExpiration Time: 2021-10-01T00:00:00Z",
+      msg));
+  EXPECT_FALSE (ParseSiweMessage (minimal + "\nResources:\n- a:b\nfoo", msg));
+  EXPECT_TRUE (ParseSiweMessage (minimal + "\nResources:", msg));
+}
+
+TEST (SiweParsingTests, Rfc3339)
+{
+  int64_t time;
+
+  ASSERT_TRUE (ParseRfc3339 ("1970-01-01T00:00:00Z", time));
+  EXPECT_EQ (time, 0);
+  ASSERT_TRUE (ParseRfc3339 ("2000-02-29t12:00:00.5z", time));
+  EXPECT_EQ (time, 951825600);
+  ASSERT_TRUE (ParseRfc3339 ("1969-12-31T19:00:00-05:00", time));
+  EXPECT_EQ (time, 0);
+
+  for (const char* str : {"", "1970-01-01", "1970-01-01 00:00:00Z",
+                                "1970-13-01T00:00:00Z",
+                                "1970-01-01T24:00:00Z",
+                                "1970-01-01T00:00:00.Z",
+                                "1970-01-01T00:00:00+0100",
+                                "1900-02-29T00:00:00Z"})
+    EXPECT_FALSE (ParseRfc3339 (str, time)) << str;
+}
+
+TEST (MemoryNonceStoreTests, IssueAndConsume)
+{
+  MemoryNonceStore store;
+
+  const std::string a = store.Issue ();
+  const std::string b = store.Issue ();
+  EXPECT_NE (a, b);
+  EXPECT_GE (a.size (), 8);
+
+  store.Add ("manualnonce");
+
+  EXPECT_FALSE (store.Consume ("unknown1"));
+  EXPECT_TRUE (store.Consume (a));
+  EXPECT_FALSE (store.Consume (a));
+  EXPECT_TRUE (store.Consume ("manualnonce"));
+  EXPECT_TRUE (store.Consume (b));
+}
+
+TEST (MemoryNonceStoreTests, LimitDropsOldest)
+{
+  MemoryNonceStore store(3);
+
+  store.Add ("nonce001");
+  store.Add ("nonce002");
+  store.Add ("nonce003");
+  EXPECT_TRUE (store.Consume ("nonce002"));
+
+  store.Add ("nonce004");
+  store.Add ("nonce005");
+
+  EXPECT_FALSE (store.Consume ("nonce001"));
+  EXPECT_TRUE (store.Consume ("nonce003"));
+  EXPECT_TRUE (store.Consume ("nonce004"));
+  EXPECT_TRUE (store.Consume ("nonce005"));
+
+  /* Adding a nonce again does not refresh it.  */
+  store.Add ("nonce006");
+  store.Add ("nonce007");
+  store.Add ("nonce006");
+  store.Add ("nonce008");
+  store.Add ("nonce009");
+  EXPECT_FALSE (store.Consume ("nonce006"));
+  EXPECT_TRUE (store.Consume ("nonce007"));
+}
+
+class SiweVerifierTests : public testing::Test
+{
+
+protected:
+
+  /** Issued-at time of the messages in the tests.  */
+  static constexpr int64_t NOW = 1633019124;
+
+  ECDSA ec;
+  ECDSA::Key key;
+
+  MemoryNonceStore nonces;
+
+  SiweVerifierTests ()
+  {
+    key = ec.SecretKey (std::string (32, '\x01'));
+  }
+
+  /**
+   * Builds a message for the given address and nonce, with an expiration
+   * time one hour after NOW.
+   */
+  static std::string
+  BuildMessage (const std::string& addr, const std::string& nonce,
+                const uint64_t chainId = 1)
+  {
+    return "example.com wants you to sign in with your Ethereum account:\n"
+           + addr + "\n"
+           "\n"
+           "Sign in to the game.\n"
+           "\n"
+           "URI: https://example.com\n"
+           "Version: 1\n"
+           "Chain ID: " + std::to_string (chainId) + "\n"
+           "Nonce: " + nonce + "\n"
+           "Issued At: 2021-09-30T16:25:24Z\n"
+           "Expiration Time: 2021-09-30T17:25:24Z";
+  }
+
+  SiweVerifier::Options
+  GetOptions ()
+  {
+    SiweVerifier::Options opt;
+    opt.domain = "example.com";
+    opt.chainId = 1;
+    opt.nonces = &nonces;
+    return opt;
+  }
+
+};
+
+TEST_F (SiweVerifierTests, Valid)
+{
+  const SiweVerifier v(ec, GetOptions ());
+
+  const std::string nonce = nonces.Issue ();
+  const std::string text
+      = BuildMessage (key.GetAddress ().GetChecksummed (), nonce);
+  const std::string sgn = ec.SignMessage (text, key);
+
+  SiweMessage msg;
+  EXPECT_EQ (v.Verify (text, sgn, NOW, msg), SiweVerifier::Result::VALID);
+  EXPECT_EQ (msg.nonce, nonce);
+
+  /* The nonce cannot be reused.  */
+  EXPECT_EQ (v.Verify (text, sgn, NOW, msg),
+             SiweVerifier::Result::INVALID_NONCE);
+}
+
+TEST_F (SiweVerifierTests, CompactSignature)
+{
+  const std::string text
+      = BuildMessage (key.GetAddress ().GetChecksummed (), nonces.Issue ());
+  const std::string sgn
+      = ec.SignMessage (text, key, ECDSA::SignatureFormat::COMPACT_HEX);
+  SiweMessage msg;
+
+  const SiweVerifier strict(ec, GetOptions ());
+  EXPECT_EQ (strict.Verify (text, sgn, NOW, msg),
+             SiweVerifier::Result::INVALID_SIGNATURE);
+
+  auto opt = GetOptions ();
+  opt.allowCompact = true;
+  const SiweVerifier v(ec, opt);
+  EXPECT_EQ (v.Verify (text, sgn, NOW, msg), SiweVerifier::Result::VALID);
+}
+
+TEST_F (SiweVerifierTests, Failures)
+{
+  const SiweVerifier v(ec, GetOptions ());
+  const std::string addr = key.GetAddress ().GetChecksummed ();
+  const std::string nonce = nonces.Issue ();
+  SiweMessage msg;
+
+  const std::string text = BuildMessage (addr, nonce);
+  const std::string sgn = ec.SignMessage (text, key);
+
+  EXPECT_EQ (v.Verify ("foo", sgn, NOW, msg),
+             SiweVerifier::Result::MALFORMED);
+  EXPECT_EQ (v.Verify (text, sgn, NOW + 3600, msg),
+             SiweVerifier::Result::EXPIRED);
+  EXPECT_EQ (v.Verify (text, "0x1234", NOW, msg),
+             SiweVerifier::Result::INVALID_SIGNATURE);
+  EXPECT_EQ (v.Verify (text, "0x" + std::string (130, 'z'), NOW, msg),
+             SiweVerifier::Result::INVALID_SIGNATURE);
+
+  const std::string otherChain = BuildMessage (addr, nonce, 5);
+  EXPECT_EQ (v.Verify (otherChain, ec.SignMessage (otherChain, key), NOW, msg),
+             SiweVerifier::Result::WRONG_CHAIN);
+
+  std::string otherDomain = text;
+  otherDomain.insert (0, "evil.");
+  EXPECT_EQ (v.Verify (otherDomain, ec.SignMessage (otherDomain, key), NOW,
+                       msg),
+             SiweVerifier::Result::WRONG_DOMAIN);
+
+  /* Signed by another key than the address in the message.  */
+  const auto other = ec.SecretKey (std::string (32, '\x02'));
+  EXPECT_EQ (v.Verify (text, ec.SignMessage (text, other), NOW, msg),
+             SiweVerifier::Result::INVALID_SIGNATURE);
+
+  /* The address must use the checksum.  */
+  const std::string lower = BuildMessage (key.GetAddress ().GetLowerCase (),
+                                          nonce);
+  EXPECT_EQ (v.Verify (lower, ec.SignMessage (lower, key), NOW, msg),
+             SiweVerifier::Result::INVALID_SIGNATURE);
+
+  /* The nonce is still available after all the failed attempts.  */
+  EXPECT_EQ (v.Verify (text, sgn, NOW, msg), SiweVerifier::Result::VALID);
+
+  /* The signature hex may use upper-case digits.  */
+  const std::string otherNonce = nonces.Issue ();
+  const std::string upperText = BuildMessage (addr, otherNonce);
+  std::string upper = ec.SignMessage (upperText, key);
+  for (size_t i = 2; i < upper.size (); ++i)
+    upper[i] = std::toupper (upper[i]);
+  EXPECT_EQ (v.Verify (upperText, upper, NOW, msg),
+             SiweVerifier::Result::VALID);
+
+  const std::string unknown = BuildMessage (addr, "unknownNonce");
+  EXPECT_EQ (v.Verify (unknown, ec.SignMessage (unknown, key), NOW, msg),
+             SiweVerifier::Result::INVALID_NONCE);
+}
+
+TEST_F (SiweVerifierTests, NotBefore)
+{
+  SiweVerifier::Options opt;
+  const SiweVerifier v(ec, opt);
+
+  const std::string text
+      = BuildMessage (key.GetAddress ().GetChecksummed (), "abcdefgh")
+          + "\nNot Before: 2021-09-30T16:30:00Z";
+  const std::string sgn = ec.SignMessage (text, key);
+
+  SiweMessage msg;
+  EXPECT_EQ (v.Verify (text, sgn, NOW, msg),
+             SiweVerifier::Result::NOT_YET_VALID);
+  EXPECT_EQ (v.Verify (text, sgn, NOW + 600, msg),
+             SiweVerifier::Result::VALID);
+}
+
+TEST_F (SiweVerifierTests, Batch)
+{
+  const SiweVerifier v(ec, GetOptions ());
+  const std::string addr = key.GetAddress ().GetChecksummed ();
+
+  std::vector<std::string> texts, sgns;
+  for (unsigned i = 0; i < 20; ++i)
+    {
+      texts.push_back (BuildMessage (addr, nonces.Issue ()));
+      sgns.push_back (ec.SignMessage (texts.back (), key));
+    }
+  sgns[3] = sgns[4];
+  texts[7] = BuildMessage (addr, nonces.Issue (), 2);
+  sgns[7] = ec.SignMessage (texts[7], key);
+
+  std::vector<SiweVerifier::Request> reqs;
+  for (unsigned i = 0; i < texts.size (); ++i)
+    reqs.push_back ({texts[i], sgns[i]});
+
+  const auto res = v.VerifyBatch (reqs, NOW, 4);
+  ASSERT_EQ (res.size (), reqs.size ());
+  for (unsigned i = 0; i < res.size (); ++i)
+    {
+      auto expected = SiweVerifier::Result::VALID;
+      if (i == 3)
+        expected = SiweVerifier::Result::INVALID_SIGNATURE;
+      else if (i == 7)
+        expected = SiweVerifier::Result::WRONG_CHAIN;
+      EXPECT_EQ (res[i], expected) << i;
+    }
+}
+
+} // anonymous namespace
+} // namespace ethutils
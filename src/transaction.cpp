@@ -0,0 +1,498 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "transaction.hpp"
+
+#include "keccak.hpp"
+#include "parallel.hpp"
+#include "rlp.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <string>
+
+namespace ethutils
+{
+
+namespace
+{
+
+/**
+ * Half the order of the secp256k1 curve.  Since EIP-2, signatures with
+ * larger s values are invalid.
+ */
+constexpr unsigned char HALF_ORDER[32] = {
+  0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0x5D, 0x57, 0x6E, 0x73, 0x57, 0xA4, 0x50, 0x1D,
+  0xDF, 0xE9, 0x2F, 0x46, 0x68, 0x1B, 0x20, 0xA0,
+};
+
+/**
+ * Checks that an item is a canonical RLP scalar (byte string without leading
+ * zeros) of at most the given size.
+ */
+bool
+IsScalar (const RlpItem& item, const size_t maxBytes)
+{
+  if (item.isList || item.payload.size () > maxBytes)
+    return false;
+  return item.payload.empty () || item.payload[0] != '\0';
+}
+
+/**
+ * Checks that the s value of a signature (as scalar bytes) is at most
+ * half the curve order.
+ */
+bool
+IsLowS (const std::string_view s)
+{
+  unsigned char padded[32] = {};
+  std::copy (s.begin (), s.end (), padded + 32 - s.size ());
+  return !std::lexicographical_compare (HALF_ORDER, HALF_ORDER + 32,
+                                        padded, padded + 32);
+}
+
+/**
+ * Parses the common fields (starting at "nonce" for legacy and "chainId"
+ * for typed transactions) and the signature from the decoded list items.
+ */
+bool
+ParseFields (const std::vector<RlpItem>& items, Transaction& tx)
+{
+  /* Index of the first field of the tail part shared by all types:
+     gasLimit, to, value, data.  */
+  size_t common;
+  /* Index of the signature fields (v/yParity, r, s).  */
+  size_t sig;
+
+  switch (tx.type)
+    {
+    case Transaction::Type::LEGACY:
+      if (items.size () != 9)
+        return false;
+      tx.nonce = items[0].payload;
+      tx.gasPrice = items[1].payload;
+      common = 2;
+      sig = 6;
+      break;
+
+    case Transaction::Type::ACCESS_LIST:
+      if (items.size () != 11)
+        return false;
+      tx.nonce = items[1].payload;
+      tx.gasPrice = items[2].payload;
+      common = 3;
+      sig = 8;
+      break;
+
+    case Transaction::Type::DYNAMIC_FEE:
+      if (items.size () != 12)
+        return false;
+      tx.nonce = items[1].payload;
+      tx.maxPriorityFeePerGas = items[2].payload;
+      tx.maxFeePerGas = items[3].payload;
+      common = 4;
+      sig = 9;
+      break;
+
+    default:
+      return false;
+    }
+
+  for (size_t i = 0; i < sig; ++i)
+    {
+      const bool isData = (i == common + 3);
+      const bool isTo = (i == common + 1);
+      const bool isAccessList = (tx.type != Transaction::Type::LEGACY
+                                  && i == common + 4);
+      if (isAccessList)
+        {
+          if (!items[i].isList)
+            return false;
+        }
+      else if (isTo)
+        {
+          if (items[i].isList
+                || (!items[i].payload.empty ()
+                      && items[i].payload.size () != Address::BINARY_SIZE))
+            return false;
+        }
+      else if (isData)
+        {
+          if (items[i].isList)
+            return false;
+        }
+      else if (!IsScalar (items[i], 32))
+        return false;
+    }
+
+  tx.gasLimit = items[common].payload;
+  tx.to = items[common + 1].payload;
+  tx.value = items[common + 2].payload;
+  tx.data = items[common + 3].payload;
+  if (tx.type != Transaction::Type::LEGACY)
+    tx.accessList = items[common + 4].encoded;
+
+  if (!IsScalar (items[sig + 1], 32) || !IsScalar (items[sig + 2], 32))
+    return false;
+  tx.r = items[sig + 1].payload;
+  tx.s = items[sig + 2].payload;
+  if (!IsLowS (tx.s))
+    return false;
+
+  uint64_t v;
+  if (!RlpDecodeUint (items[sig], v))
+    return false;
+
+  if (tx.type == Transaction::Type::LEGACY)
+    {
+      if (v == 27 || v == 28)
+        {
+          tx.hasChainId = false;
+          tx.recoveryId = v - 27;
+        }
+      else if (v >= 35)
+        {
+          tx.hasChainId = true;
+          tx.chainId = (v - 35) / 2;
+          tx.recoveryId = (v - 35) % 2;
+        }
+      else
+        return false;
+    }
+  else
+    {
+      if (v > 1 || !RlpDecodeUint (items[0], tx.chainId))
+        return false;
+      tx.hasChainId = true;
+      tx.recoveryId = v;
+    }
+
+  return true;
+}
+
+/**
+ * Returns the given bytes with all leading zeros removed.
+ */
+std::string_view
+StripZeros (std::string_view bytes)
+{
+  while (!bytes.empty () && bytes[0] == '\0')
+    bytes.remove_prefix (1);
+  return bytes;
+}
+
+/**
+ * Appends the RLP encoding of a byte string to out.
+ */
+void
+AppendString (std::string& out, const std::string_view bytes)
+{
+  if (bytes.size () != 1 || static_cast<unsigned char> (bytes[0]) >= 0x80)
+    out += RlpHeader (bytes.size (), false);
+  out += bytes;
+}
+
+/**
+ * Appends the RLP encoding of an unsigned integer to out.
+ */
+void
+AppendUint (std::string& out, const uint64_t val)
+{
+  char bytes[sizeof (val)];
+  for (size_t i = 0; i < sizeof (val); ++i)
+    bytes[i] = static_cast<char> ((val >> (8 * (sizeof (val) - 1 - i))) & 0xFF);
+  AppendString (out, StripZeros (std::string_view (bytes, sizeof (val))));
+}
+
+/**
+ * Computes the signing hash of a transaction.  The signed payload consists
+ * of the unsigned fields, which are contiguous in the raw data.  They are
+ * hashed directly from there, with only the headers (and for EIP-155 the
+ * chain ID) added around them.
+ */
+void
+ComputeSigningHash (const std::vector<RlpItem>& items, Transaction& tx)
+{
+  const size_t numUnsigned = items.size () - 3;
+  const char* begin = items[0].encoded.data ();
+  const char* end = items[numUnsigned - 1].encoded.data ()
+                      + items[numUnsigned - 1].encoded.size ();
+  const std::string_view fields(begin, end - begin);
+
+  Keccak256Hasher hasher;
+
+  if (tx.type == Transaction::Type::LEGACY)
+    {
+      if (tx.hasChainId)
+        {
+          std::string extra;
+          AppendUint (extra, tx.chainId);
+          extra += "\x80\x80";
+          hasher.Update (RlpHeader (fields.size () + extra.size (), true));
+          hasher.Update (fields);
+          hasher.Update (extra);
+        }
+      else
+        {
+          hasher.Update (RlpHeader (fields.size (), true));
+          hasher.Update (fields);
+        }
+    }
+  else
+    {
+      const char typeByte = static_cast<char> (tx.type);
+      hasher.Update (std::string_view (&typeByte, 1));
+      hasher.Update (RlpHeader (fields.size (), true));
+      hasher.Update (fields);
+    }
+
+  hasher.Finish (tx.signingHash.data ());
+}
+
+/**
+ * Parses a transaction, using the given vector as temporary storage
+ * for the decoded list items (so it can be reused).
+ */
+bool
+ParseTransaction (const std::string_view raw, Transaction& tx,
+                  std::vector<RlpItem>& items)
+{
+  tx = Transaction ();
+  if (raw.empty ())
+    return false;
+
+  /* Typed transactions start with the type byte (below 0x7F), while
+     legacy transactions start directly with the RLP list.  */
+  std::string_view encoded = raw;
+  const unsigned char first = raw[0];
+  if (first >= 0xC0)
+    tx.type = Transaction::Type::LEGACY;
+  else if (first == 0x01 || first == 0x02)
+    {
+      tx.type = static_cast<Transaction::Type> (first);
+      encoded = raw.substr (1);
+    }
+  else
+    return false;
+
+  RlpItem list;
+  std::string_view rest;
+  if (!RlpDecode (encoded, list, rest) || !list.isList || !rest.empty ())
+    return false;
+
+  if (!RlpDecodeList (list.payload, items) || !ParseFields (items, tx))
+    return false;
+
+  ComputeSigningHash (items, tx);
+  return true;
+}
+
+/**
+ * Recovers the sender of a parsed transaction, using the given strings
+ * as buffers for the hash and signature (so that they can be reused).
+ */
+Address
+RecoverSender (const ECDSA& ec, const Transaction& tx,
+               std::string& hash, std::string& sgn)
+{
+  hash.assign (tx.signingHash.begin (), tx.signingHash.end ());
+
+  sgn.assign (65, '\0');
+  std::copy (tx.r.begin (), tx.r.end (), sgn.begin () + 32 - tx.r.size ());
+  std::copy (tx.s.begin (), tx.s.end (), sgn.begin () + 64 - tx.s.size ());
+  sgn[64] = static_cast<char> (27 + tx.recoveryId);
+
+  return ec.VerifyHash (hash, sgn);
+}
+
+/**
+ * Builds and signs a transaction with the given nonce (instead of the one
+ * in the request).  The unsigned fields are encoded into the fields buffer,
+ * which can be reused between calls.  The signed transaction is written
+ * to out, which is allocated just once with the final size.
+ */
+void
+SignTransaction (const ECDSA& ec, const ECDSA::Key& key,
+                 const TransactionRequest& req, const uint64_t nonce,
+                 std::string& fields, std::string& out)
+{
+  const bool typed = (req.type != Transaction::Type::LEGACY);
+  CHECK (typed || req.accessList.empty ())
+      << "Legacy transactions cannot have an access list";
+  CHECK (req.type == Transaction::Type::LEGACY
+          || req.type == Transaction::Type::ACCESS_LIST
+          || req.type == Transaction::Type::DYNAMIC_FEE)
+      << "Invalid transaction type: " << static_cast<int> (req.type);
+
+  const std::string_view value = StripZeros (req.value);
+  CHECK_LE (value.size (), 32) << "Transaction value is too large";
+
+  fields.clear ();
+  if (typed)
+    AppendUint (fields, req.chainId);
+  AppendUint (fields, nonce);
+  if (req.type == Transaction::Type::DYNAMIC_FEE)
+    {
+      AppendUint (fields, req.maxPriorityFeePerGas);
+      AppendUint (fields, req.maxFeePerGas);
+    }
+  else
+    AppendUint (fields, req.gasPrice);
+  AppendUint (fields, req.gasLimit);
+  if (req.to)
+    {
+      const auto& to = req.to.GetBinary ();
+      AppendString (fields, std::string_view (
+          reinterpret_cast<const char*> (to.data ()), to.size ()));
+    }
+  else
+    AppendString (fields, "");
+  AppendString (fields, value);
+  AppendString (fields, req.data);
+  if (typed)
+    {
+      if (req.accessList.empty ())
+        fields += static_cast<char> (0xC0);
+      else
+        {
+          RlpItem item;
+          std::string_view rest;
+          CHECK (RlpDecode (req.accessList, item, rest)
+                  && item.isList && rest.empty ())
+              << "Invalid access list";
+          fields += req.accessList;
+        }
+    }
+
+  Keccak256Hasher hasher;
+  const char typeByte = static_cast<char> (req.type);
+  if (typed)
+    {
+      hasher.Update (std::string_view (&typeByte, 1));
+      hasher.Update (RlpHeader (fields.size (), true));
+      hasher.Update (fields);
+    }
+  else if (req.chainId > 0)
+    {
+      std::string extra;
+      AppendUint (extra, req.chainId);
+      extra += "\x80\x80";
+      hasher.Update (RlpHeader (fields.size () + extra.size (), true));
+      hasher.Update (fields);
+      hasher.Update (extra);
+    }
+  else
+    {
+      hasher.Update (RlpHeader (fields.size (), true));
+      hasher.Update (fields);
+    }
+
+  std::string hash(32, '\0');
+  hasher.Finish (reinterpret_cast<unsigned char*> (&hash[0]));
+  const std::string sgn = ec.SignHash (hash, key);
+
+  /* libsecp256k1 always produces normalised (low s) signatures, so they
+     are valid with respect to EIP-2.  */
+  const uint64_t recoveryId = static_cast<unsigned char> (sgn[64]) - 27;
+  uint64_t v;
+  if (typed)
+    v = recoveryId;
+  else if (req.chainId > 0)
+    v = 35 + 2 * req.chainId + recoveryId;
+  else
+    v = 27 + recoveryId;
+
+  AppendUint (fields, v);
+  AppendString (fields, StripZeros (std::string_view (sgn).substr (0, 32)));
+  AppendString (fields, StripZeros (std::string_view (sgn).substr (32, 32)));
+
+  const std::string header = RlpHeader (fields.size (), true);
+  out.clear ();
+  out.reserve ((typed ? 1 : 0) + header.size () + fields.size ());
+  if (typed)
+    out += typeByte;
+  out += header;
+  out += fields;
+}
+
+} // anonymous namespace
+
+bool
+ParseTransaction (const std::string_view raw, Transaction& tx)
+{
+  std::vector<RlpItem> items;
+  return ParseTransaction (raw, tx, items);
+}
+
+Address
+RecoverSender (const ECDSA& ec, const Transaction& tx)
+{
+  std::string hash, sgn;
+  return RecoverSender (ec, tx, hash, sgn);
+}
+
+std::vector<Address>
+RecoverSenders (const ECDSA& ec, const std::vector<std::string_view>& raw,
+                const unsigned threads)
+{
+  std::vector<Address> res(raw.size ());
+
+  ParallelFor (raw.size (), threads, [&] (const size_t begin, const size_t end)
+    {
+      std::vector<RlpItem> items;
+      std::string hash, sgn;
+      Transaction tx;
+
+      for (size_t i = begin; i < end; ++i)
+        {
+          if (!ParseTransaction (raw[i], tx, items))
+            {
+              LOG (WARNING) << "Invalid raw transaction at index " << i;
+              continue;
+            }
+          res[i] = RecoverSender (ec, tx, hash, sgn);
+        }
+    });
+
+  return res;
+}
+
+void
+SignTransaction (const ECDSA& ec, const ECDSA::Key& key,
+                 const TransactionRequest& req, std::string& out)
+{
+  std::string fields;
+  SignTransaction (ec, key, req, req.nonce, fields, out);
+}
+
+std::string
+SignTransaction (const ECDSA& ec, const ECDSA::Key& key,
+                 const TransactionRequest& req)
+{
+  std::string res;
+  SignTransaction (ec, key, req, res);
+  return res;
+}
+
+std::vector<std::string>
+SignTransactions (const ECDSA& ec, const ECDSA::Key& key,
+                  const std::vector<TransactionRequest>& reqs,
+                  const uint64_t firstNonce, const unsigned threads)
+{
+  std::vector<std::string> res(reqs.size ());
+
+  ParallelFor (reqs.size (), threads, [&] (const size_t begin, const size_t end)
+    {
+      std::string fields;
+      for (size_t i = begin; i < end; ++i)
+        SignTransaction (ec, key, reqs[i], firstNonce + i, fields, res[i]);
+    });
+
+  return res;
+}
+
+} // namespace ethutils
@@ -0,0 +1,183 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ETHUTILS_TRANSACTION_HPP
+#define ETHUTILS_TRANSACTION_HPP
+
+#include "address.hpp"
+#include "ecdsa.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ethutils
+{
+
+/**
+ * A signed raw transaction as parsed from its binary encoding.  All fields
+ * are views into the raw data, which must outlive the instance.
+ *
+ * Integer fields are the big-endian bytes (without leading zeros) as they
+ * appear in the RLP encoding.  Fields that the transaction type does not
+ * have are left empty.
+ */
+struct Transaction
+{
+
+  /** The supported transaction types.  */
+  enum class Type
+  {
+    /** Legacy (untyped) transactions, with or without EIP-155.  */
+    LEGACY = 0,
+    /** EIP-2930 transactions with access list.  */
+    ACCESS_LIST = 1,
+    /** EIP-1559 transactions with dynamic fee.  */
+    DYNAMIC_FEE = 2,
+  };
+
+  Type type = Type::LEGACY;
+
+  /**
+   * True if the transaction is bound to a chain ID.  This is always the
+   * case for typed transactions, and for legacy ones using EIP-155.
+   */
+  bool hasChainId = false;
+
+  /** The chain ID (if hasChainId).  */
+  uint64_t chainId = 0;
+
+  std::string_view nonce;
+
+  /** Gas price for legacy and EIP-2930 transactions.  */
+  std::string_view gasPrice;
+
+  /** Fee fields of EIP-1559 transactions.  */
+  std::string_view maxPriorityFeePerGas;
+  std::string_view maxFeePerGas;
+
+  std::string_view gasLimit;
+
+  /** The recipient (20 bytes), or empty for contract creations.  */
+  std::string_view to;
+
+  std::string_view value;
+  std::string_view data;
+
+  /** The RLP-encoded access list (for typed transactions).  */
+  std::string_view accessList;
+
+  /** The signature's recovery ID (0 or 1) and the r and s values.  */
+  int recoveryId = 0;
+  std::string_view r;
+  std::string_view s;
+
+  /** The 32-byte hash that the sender signed.  */
+  std::array<unsigned char, 32> signingHash;
+
+};
+
+/**
+ * The data for building and signing a new transaction.  Fields that do not
+ * apply to the chosen type are ignored.
+ */
+struct TransactionRequest
+{
+
+  Transaction::Type type = Transaction::Type::DYNAMIC_FEE;
+
+  /**
+   * The chain ID.  For legacy transactions, zero means that the
+   * transaction is signed without EIP-155 replay protection.
+   */
+  uint64_t chainId = 0;
+
+  uint64_t nonce = 0;
+
+  /** Gas price for legacy and EIP-2930 transactions.  */
+  uint64_t gasPrice = 0;
+
+  /** Fee fields of EIP-1559 transactions.  */
+  uint64_t maxPriorityFeePerGas = 0;
+  uint64_t maxFeePerGas = 0;
+
+  uint64_t gasLimit = 0;
+
+  /** The recipient, or an invalid address for contract creations.  */
+  Address to;
+
+  /**
+   * The value in Wei, as big-endian bytes (up to 32).  Leading zero bytes
+   * are allowed and stripped when encoding.
+   */
+  std::string value;
+
+  std::string data;
+
+  /**
+   * The RLP-encoded access list for typed transactions.  If empty,
+   * an empty list is used.
+   */
+  std::string accessList;
+
+};
+
+/**
+ * Parses a raw signed transaction (legacy or typed) from its binary
+ * encoding.  This also computes the signing hash, but does not recover
+ * the sender yet.  Returns false if the data is invalid.
+ */
+bool ParseTransaction (std::string_view raw, Transaction& tx);
+
+/**
+ * Recovers the sender of a parsed transaction.  Returns an invalid address
+ * if the signature is invalid.
+ */
+Address RecoverSender (const ECDSA& ec, const Transaction& tx);
+
+/**
+ * Parses a batch of raw transactions (e.g. all transactions of a block)
+ * and recovers their senders, split across up to the given number of
+ * threads (zero means to use the hardware concurrency).  The result
+ * contains the sender for each transaction, in order, or an invalid
+ * address if the transaction could not be parsed or its signature
+ * is invalid.
+ */
+std::vector<Address> RecoverSenders (const ECDSA& ec,
+                                     const std::vector<std::string_view>& raw,
+                                     unsigned threads = 0);
+
+/**
+ * Builds and signs a transaction with the given key.  The raw signed
+ * transaction (as it would be sent to eth_sendRawTransaction, but in binary)
+ * is written into out, whose existing capacity is reused.  The key must be
+ * valid, and the request must be well-formed (or else this CHECK-fails).
+ */
+void SignTransaction (const ECDSA& ec, const ECDSA::Key& key,
+                      const TransactionRequest& req, std::string& out);
+
+/**
+ * Builds and signs a transaction, returning the raw signed transaction.
+ */
+std::string SignTransaction (const ECDSA& ec, const ECDSA::Key& key,
+                             const TransactionRequest& req);
+
+/**
+ * Builds and signs a batch of transactions from the same key, for instance
+ * to submit them all at once.  The nonce fields of the requests are
+ * ignored; instead, they get consecutive nonces starting at firstNonce.
+ * The work is split across up to the given number of threads (zero means
+ * to use the hardware concurrency).  Returns the raw signed transactions
+ * in the order of the requests.
+ */
+std::vector<std::string> SignTransactions (
+    const ECDSA& ec, const ECDSA::Key& key,
+    const std::vector<TransactionRequest>& reqs, uint64_t firstNonce,
+    unsigned threads = 0);
+
+} // namespace ethutils
+
+#endif // ETHUTILS_TRANSACTION_HPP
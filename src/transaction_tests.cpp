@@ -0,0 +1,345 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "transaction.hpp"
+
+#include "hexutils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <glog/logging.h>
+
+namespace ethutils
+{
+namespace
+{
+
+class TransactionTests : public testing::Test
+{
+
+protected:
+
+  /** The sender of all test transactions.  */
+  static const Address SENDER;
+
+  /**
+   * The example legacy transaction with EIP-155 from the EIP.
+   */
+  static const std::string LEGACY_155;
+
+  /** A legacy transaction without chain ID.  */
+  static const std::string LEGACY;
+
+  /** An EIP-2930 transaction (contract creation with access list).  */
+  static const std::string ACCESS_LIST;
+
+  /** An EIP-1559 transaction.  */
+  static const std::string DYNAMIC_FEE;
+
+  ECDSA ec;
+
+  /** The key used to sign all test transactions.  */
+  const ECDSA::Key key = ec.SecretKey (
+      "0x4646464646464646464646464646464646464646464646464646464646464646");
+
+  /** The recipient of the test transactions.  */
+  static const Address TO;
+
+  static std::string
+  Bin (const std::string& hex)
+  {
+    std::string res;
+    CHECK (Unhexlify (hex, res));
+    return res;
+  }
+
+  static std::string
+  Hex (const std::string_view bin)
+  {
+    return Hexlify (std::string (bin));
+  }
+
+  static std::string
+  Hex (const std::array<unsigned char, 32>& bin)
+  {
+    return Hexlify (std::string (bin.begin (), bin.end ()));
+  }
+
+};
+
+const Address TransactionTests::SENDER(
+    "0x9d8A62f656a8d1615C1294fd71e9CFb3E4855A4F");
+
+const Address TransactionTests::TO(
+    "0x3535353535353535353535353535353535353535");
+
+const std::string TransactionTests::LEGACY_155 = Bin (
+    "f86c098504a817c800825208943535353535353535353535353535353535353535880d"
+    "e0b6b3a76400008025a028ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1"
+    "590620aa636276a067cbe9d8997f761aecb703304b3800ccf555c9f3dc64214b297fb1"
+    "966a3b6d83");
+
+const std::string TransactionTests::LEGACY = Bin (
+    "f86803843b9aca00825208943535353535353535353535353535353535353535808568"
+    "656c6c6f1ba07114aa37cba6b2efec146b198be5b1da6411430989b82443f4f5becd81"
+    "69622aa00d4b0a3ae977a7b2a64bb0b0382e17eb6f67a2577f193a239a44103cf50c28"
+    "6a");
+
+const std::string TransactionTests::ACCESS_LIST = Bin (
+    "01f8b405078504a817c800830186a08080856060604052f85bf85994de0b295669a9fd"
+    "93d5f28d9ec85e40f4cb697baef842a000000000000000000000000000000000000000"
+    "00000000000000000000000003a0000000000000000000000000000000000000000000"
+    "000000000000000000000780a062162a428fa96a81fa4adad87728bc6dc598cdf4cd5f"
+    "069f8321ad9d18d1e5d7a07eb31b7b6d2fe00258de4c74591c84d9c2cb03b7efc07278"
+    "2d4cde759da461b3");
+
+const std::string TransactionTests::DYNAMIC_FEE = Bin (
+    "02f8730180843b9aca0085174876e800825208943535353535353535353535353535"
+    "353535353535880de0b6b3a764000080c001a084ee313a3aaca8747b7161e697dc4a"
+    "30dedd03a75597e835efb756823e98f9fea0633e6548426a2acdd295ee425a40cc62"
+    "60f3a16d836e9b845a56b9cadd0f004a");
+
+TEST_F (TransactionTests, Legacy155)
+{
+  Transaction tx;
+  ASSERT_TRUE (ParseTransaction (LEGACY_155, tx));
+
+  EXPECT_EQ (tx.type, Transaction::Type::LEGACY);
+  EXPECT_TRUE (tx.hasChainId);
+  EXPECT_EQ (tx.chainId, 1);
+  EXPECT_EQ (Hex (tx.nonce), "09");
+  EXPECT_EQ (Hex (tx.gasPrice), "04a817c800");
+  EXPECT_EQ (Hex (tx.gasLimit), "5208");
+  EXPECT_EQ (Hex (tx.to), "3535353535353535353535353535353535353535");
+  EXPECT_EQ (Hex (tx.value), "0de0b6b3a7640000");
+  EXPECT_EQ (tx.data, "");
+  EXPECT_EQ (tx.recoveryId, 0);
+  EXPECT_EQ (Hex (tx.signingHash),
+      "daf5a779ae972f972197303d7b574746c7ef83eadac0f2791ad23db92e4c8e53");
+
+  EXPECT_EQ (RecoverSender (ec, tx), SENDER);
+}
+
+TEST_F (TransactionTests, LegacyWithoutChainId)
+{
+  Transaction tx;
+  ASSERT_TRUE (ParseTransaction (LEGACY, tx));
+
+  EXPECT_EQ (tx.type, Transaction::Type::LEGACY);
+  EXPECT_FALSE (tx.hasChainId);
+  EXPECT_EQ (tx.data, "hello");
+  EXPECT_EQ (tx.value, "");
+  EXPECT_EQ (Hex (tx.signingHash),
+      "d4c56055b4cbaa996d486f0aa93c5dc70ffed77c40e7d027feff39ce09c46e53");
+
+  EXPECT_EQ (RecoverSender (ec, tx), SENDER);
+}
+
+TEST_F (TransactionTests, AccessList)
+{
+  Transaction tx;
+  ASSERT_TRUE (ParseTransaction (ACCESS_LIST, tx));
+
+  EXPECT_EQ (tx.type, Transaction::Type::ACCESS_LIST);
+  EXPECT_TRUE (tx.hasChainId);
+  EXPECT_EQ (tx.chainId, 5);
+  EXPECT_EQ (Hex (tx.nonce), "07");
+  EXPECT_EQ (tx.to, "");
+  EXPECT_EQ (Hex (tx.data), "6060604052");
+  EXPECT_EQ (tx.accessList.size (), 93);
+  EXPECT_EQ (Hex (tx.signingHash),
+      "0bcf667642f4c423f49f32ee7b7b8bf1717f46ddf79ff8177ff8d7fda3e8ed3d");
+
+  EXPECT_EQ (RecoverSender (ec, tx), SENDER);
+}
+
+TEST_F (TransactionTests, DynamicFee)
+{
+  Transaction tx;
+  ASSERT_TRUE (ParseTransaction (DYNAMIC_FEE, tx));
+
+  EXPECT_EQ (tx.type, Transaction::Type::DYNAMIC_FEE);
+  EXPECT_EQ (tx.chainId, 1);
+  EXPECT_EQ (tx.nonce, "");
+  EXPECT_EQ (tx.gasPrice, "");
+  EXPECT_EQ (Hex (tx.maxPriorityFeePerGas), "3b9aca00");
+  EXPECT_EQ (Hex (tx.maxFeePerGas), "174876e800");
+  EXPECT_EQ (tx.recoveryId, 1);
+  EXPECT_EQ (Hex (tx.signingHash),
+      "bfbcb21ef85794806120d9289a00de85b28dbd68e7ff8d4f9a7d057d9b3ce032");
+
+  EXPECT_EQ (RecoverSender (ec, tx), SENDER);
+}
+
+TEST_F (TransactionTests, Invalid)
+{
+  Transaction tx;
+  EXPECT_FALSE (ParseTransaction ("", tx));
+  EXPECT_FALSE (ParseTransaction (Bin ("03") + DYNAMIC_FEE.substr (1), tx));
+  EXPECT_FALSE (ParseTransaction (DYNAMIC_FEE.substr (1), tx));
+  EXPECT_FALSE (ParseTransaction (LEGACY_155 + "x", tx));
+  EXPECT_FALSE (ParseTransaction (
+      LEGACY_155.substr (0, LEGACY_155.size () - 1), tx));
+  EXPECT_FALSE (ParseTransaction (Bin ("c0"), tx));
+
+  /* Change v of the legacy transaction to an invalid value.  */
+  std::string modified = LEGACY_155;
+  ASSERT_EQ (modified[0x2b], '\x25');
+  modified[0x2b] = '\x1d';
+  EXPECT_FALSE (ParseTransaction (modified, tx));
+}
+
+TEST_F (TransactionTests, ModifiedSignature)
+{
+  /* Changing the value (without changing the length) results in a different
+     signing hash and thus a different recovered sender.  */
+  std::string modified = DYNAMIC_FEE;
+  const size_t pos = modified.find (Bin ("0de0b6b3a7640000"));
+  ASSERT_NE (pos, std::string::npos);
+  modified[pos] = '\x0e';
+
+  Transaction tx;
+  ASSERT_TRUE (ParseTransaction (modified, tx));
+  EXPECT_NE (RecoverSender (ec, tx), SENDER);
+}
+
+TEST_F (TransactionTests, Batch)
+{
+  const std::vector<std::string_view> raw =
+    {
+      LEGACY_155, LEGACY, "invalid", ACCESS_LIST, DYNAMIC_FEE,
+    };
+
+  for (const unsigned threads : {1u, 2u, 0u})
+    {
+      const auto senders = RecoverSenders (ec, raw, threads);
+      ASSERT_EQ (senders.size (), raw.size ());
+      for (size_t i = 0; i < raw.size (); ++i)
+        if (i == 2)
+          EXPECT_FALSE (senders[i]);
+        else
+          EXPECT_EQ (senders[i], SENDER);
+    }
+
+  EXPECT_TRUE (RecoverSenders (ec, {}).empty ());
+}
+
+TEST_F (TransactionTests, SignLegacy155)
+{
+  TransactionRequest req;
+  req.type = Transaction::Type::LEGACY;
+  req.chainId = 1;
+  req.nonce = 9;
+  req.gasPrice = 20'000'000'000;
+  req.gasLimit = 21'000;
+  req.to = TO;
+  req.value = Bin ("0de0b6b3a7640000");
+
+  EXPECT_EQ (Hex (SignTransaction (ec, key, req)), Hex (LEGACY_155));
+}
+
+TEST_F (TransactionTests, SignLegacy)
+{
+  TransactionRequest req;
+  req.type = Transaction::Type::LEGACY;
+  req.nonce = 3;
+  req.gasPrice = 1'000'000'000;
+  req.gasLimit = 21'000;
+  req.to = TO;
+  req.data = "hello";
+
+  EXPECT_EQ (Hex (SignTransaction (ec, key, req)), Hex (LEGACY));
+}
+
+TEST_F (TransactionTests, SignAccessList)
+{
+  Transaction parsed;
+  ASSERT_TRUE (ParseTransaction (ACCESS_LIST, parsed));
+
+  TransactionRequest req;
+  req.type = Transaction::Type::ACCESS_LIST;
+  req.chainId = 5;
+  req.nonce = 7;
+  req.gasPrice = 20'000'000'000;
+  req.gasLimit = 100'000;
+  req.value = Bin ("0000");
+  req.data = Bin ("6060604052");
+  req.accessList = std::string (parsed.accessList);
+
+  EXPECT_EQ (Hex (SignTransaction (ec, key, req)), Hex (ACCESS_LIST));
+}
+
+TEST_F (TransactionTests, SignDynamicFee)
+{
+  TransactionRequest req;
+  req.chainId = 1;
+  req.maxPriorityFeePerGas = 1'000'000'000;
+  req.maxFeePerGas = 100'000'000'000;
+  req.gasLimit = 21'000;
+  req.to = TO;
+  req.value = Bin ("0de0b6b3a7640000");
+
+  std::string out = "existing data";
+  SignTransaction (ec, key, req, out);
+  EXPECT_EQ (Hex (out), Hex (DYNAMIC_FEE));
+}
+
+TEST_F (TransactionTests, SignInvalid)
+{
+  TransactionRequest req;
+  req.type = Transaction::Type::LEGACY;
+  req.accessList = Bin ("c0");
+  EXPECT_DEATH (SignTransaction (ec, key, req), "access list");
+
+  req = TransactionRequest ();
+  req.accessList = Bin ("80");
+  EXPECT_DEATH (SignTransaction (ec, key, req), "Invalid access list");
+
+  req = TransactionRequest ();
+  req.value = std::string (33, '\xFF');
+  EXPECT_DEATH (SignTransaction (ec, key, req), "too large");
+
+  EXPECT_DEATH (SignTransaction (ec, ECDSA::Key (), TransactionRequest ()),
+                "must be valid");
+}
+
+TEST_F (TransactionTests, SignBatch)
+{
+  std::vector<TransactionRequest> reqs(10);
+  for (size_t i = 0; i < reqs.size (); ++i)
+    {
+      reqs[i].type = (i % 2 == 0 ? Transaction::Type::DYNAMIC_FEE
+                                 : Transaction::Type::LEGACY);
+      reqs[i].chainId = 1;
+      reqs[i].nonce = 1'000;
+      reqs[i].maxFeePerGas = 100 + i;
+      reqs[i].gasPrice = 100 + i;
+      reqs[i].gasLimit = 21'000;
+      reqs[i].to = TO;
+    }
+
+  for (const unsigned threads : {1u, 3u, 0u})
+    {
+      const auto signedTxs = SignTransactions (ec, key, reqs, 42, threads);
+      ASSERT_EQ (signedTxs.size (), reqs.size ());
+
+      for (size_t i = 0; i < reqs.size (); ++i)
+        {
+          Transaction tx;
+          ASSERT_TRUE (ParseTransaction (signedTxs[i], tx));
+          EXPECT_EQ (tx.type, reqs[i].type);
+          EXPECT_EQ (Hex (tx.nonce), Hex (std::string (1, 42 + i)));
+          EXPECT_EQ (RecoverSender (ec, tx), SENDER);
+
+          TransactionRequest single = reqs[i];
+          single.nonce = 42 + i;
+          EXPECT_EQ (signedTxs[i], SignTransaction (ec, key, single));
+        }
+    }
+
+  EXPECT_TRUE (SignTransactions (ec, key, {}, 0).empty ());
+}
+
+} // anonymous namespace
+} // namespace ethutils
@@ -0,0 +1,382 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "uint256.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+namespace ethutils
+{
+
+namespace
+{
+
+/* GCC and Clang provide a 128-bit integer type, which we use for the
+   carries of 64-bit limb multiplications and divisions.  */
+__extension__ typedef unsigned __int128 Uint128;
+
+using Limbs = std::array<uint64_t, 4>;
+
+/** Number of decimal digits that fit into one uint64_t chunk.  */
+constexpr unsigned DECIMAL_CHUNK = 19;
+
+/** 10^DECIMAL_CHUNK, the base for decimal chunks.  */
+constexpr uint64_t DECIMAL_BASE = 10'000'000'000'000'000'000ull;
+
+/**
+ * Divides the limbs by a 64-bit divisor in place, and returns
+ * the remainder.
+ */
+uint64_t
+DivSmall (Limbs& limbs, const uint64_t d)
+{
+  uint64_t rem = 0;
+  for (size_t i = limbs.size (); i > 0; --i)
+    {
+      const Uint128 cur = (static_cast<Uint128> (rem) << 64) | limbs[i - 1];
+      limbs[i - 1] = static_cast<uint64_t> (cur / d);
+      rem = static_cast<uint64_t> (cur % d);
+    }
+  return rem;
+}
+
+/**
+ * Computes limbs * m + a in place, and returns the carry out of the
+ * highest limb (which is non-zero if the result overflows).
+ */
+uint64_t
+MulSmallAdd (Limbs& limbs, const uint64_t m, const uint64_t a)
+{
+  uint64_t carry = a;
+  for (auto& l : limbs)
+    {
+      const Uint128 cur = static_cast<Uint128> (l) * m + carry;
+      l = static_cast<uint64_t> (cur);
+      carry = static_cast<uint64_t> (cur >> 64);
+    }
+  return carry;
+}
+
+/**
+ * Returns the number of significant bits in the limbs.
+ */
+unsigned
+BitLength (const Limbs& limbs)
+{
+  for (size_t i = limbs.size (); i > 0; --i)
+    if (limbs[i - 1] != 0)
+      return 64 * (i - 1) + 64 - __builtin_clzll (limbs[i - 1]);
+  return 0;
+}
+
+/**
+ * Shifts the limbs left by one bit and sets the lowest bit to the given
+ * value.  Returns the bit shifted out at the top.
+ */
+bool
+ShiftLeftOne (Limbs& limbs, const bool low)
+{
+  uint64_t carry = low ? 1 : 0;
+  for (auto& l : limbs)
+    {
+      const uint64_t next = l >> 63;
+      l = (l << 1) | carry;
+      carry = next;
+    }
+  return carry != 0;
+}
+
+/**
+ * Returns the value of a hex digit (either case), or -1 if the character
+ * is not a hex digit.
+ */
+int
+HexDigit (const char c)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+} // anonymous namespace
+
+/* ************************************************************************** */
+
+Uint256
+Uint256::FromBinary (const unsigned char* bin)
+{
+  Uint256 res;
+  for (size_t i = 0; i < BINARY_SIZE; ++i)
+    {
+      uint64_t& l = res.limbs[3 - i / 8];
+      l = (l << 8) | bin[i];
+    }
+  return res;
+}
+
+Uint256
+Uint256::FromBinary (const std::string_view bin)
+{
+  CHECK_EQ (bin.size (), BINARY_SIZE) << "Invalid binary size for Uint256";
+  return FromBinary (reinterpret_cast<const unsigned char*> (bin.data ()));
+}
+
+void
+Uint256::ToBinary (unsigned char* out) const
+{
+  for (size_t i = 0; i < BINARY_SIZE; ++i)
+    {
+      const unsigned shift = 56 - 8 * (i % 8);
+      out[i] = static_cast<unsigned char> (limbs[3 - i / 8] >> shift);
+    }
+}
+
+std::string
+Uint256::ToBinary () const
+{
+  std::string res(BINARY_SIZE, '\0');
+  ToBinary (reinterpret_cast<unsigned char*> (&res[0]));
+  return res;
+}
+
+bool
+Uint256::FromHex (const std::string_view str, Uint256& out)
+{
+  if (str.substr (0, 2) != "0x")
+    return false;
+
+  const std::string_view digits = str.substr (2);
+  if (digits.empty () || digits.size () > 2 * BINARY_SIZE)
+    return false;
+
+  Uint256 res;
+  for (size_t i = 0; i < digits.size (); ++i)
+    {
+      const int val = HexDigit (digits[i]);
+      if (val < 0)
+        return false;
+
+      /* Digit i counted from the right.  */
+      const size_t pos = digits.size () - 1 - i;
+      res.limbs[pos / 16] |= static_cast<uint64_t> (val) << (4 * (pos % 16));
+    }
+
+  out = res;
+  return true;
+}
+
+bool
+Uint256::FromDecimal (const std::string_view str, Uint256& out)
+{
+  if (str.empty ())
+    return false;
+
+  Uint256 res;
+  for (size_t start = 0; start < str.size (); start += DECIMAL_CHUNK)
+    {
+      const std::string_view chunk = str.substr (start, DECIMAL_CHUNK);
+
+      uint64_t val = 0;
+      uint64_t scale = 1;
+      for (const char c : chunk)
+        {
+          if (c < '0' || c > '9')
+            return false;
+          val = 10 * val + (c - '0');
+          scale *= 10;
+        }
+
+      if (MulSmallAdd (res.limbs, scale, val) != 0)
+        return false;
+    }
+
+  out = res;
+  return true;
+}
+
+bool
+Uint256::Parse (const std::string_view str, Uint256& out)
+{
+  if (str.substr (0, 2) == "0x")
+    return FromHex (str, out);
+  return FromDecimal (str, out);
+}
+
+std::string
+Uint256::ToHex () const
+{
+  static const char* const DIGITS = "0123456789abcdef";
+
+  const unsigned bits = BitLength (limbs);
+  const size_t numDigits = std::max<size_t> ((bits + 3) / 4, 1);
+
+  std::string res(2 + numDigits, '\0');
+  res[0] = '0';
+  res[1] = 'x';
+  for (size_t i = 0; i < numDigits; ++i)
+    {
+      const size_t pos = numDigits - 1 - i;
+      res[2 + i] = DIGITS[(limbs[pos / 16] >> (4 * (pos % 16))) & 0xF];
+    }
+
+  return res;
+}
+
+std::string
+Uint256::ToDecimal () const
+{
+  /* Split the number into chunks of DECIMAL_CHUNK digits (at most five
+     are needed for 78 digits), with the least significant first.  */
+  std::array<uint64_t, 5> chunks;
+  size_t numChunks = 0;
+  Limbs cur = limbs;
+  do
+    chunks[numChunks++] = DivSmall (cur, DECIMAL_BASE);
+  while (BitLength (cur) > 0);
+
+  std::string res = std::to_string (chunks[numChunks - 1]);
+  for (size_t i = numChunks - 1; i > 0; --i)
+    {
+      const std::string part = std::to_string (chunks[i - 1]);
+      res.append (DECIMAL_CHUNK - part.size (), '0');
+      res.append (part);
+    }
+
+  return res;
+}
+
+bool
+Uint256::FitsUint64 () const
+{
+  return (limbs[1] | limbs[2] | limbs[3]) == 0;
+}
+
+/* ************************************************************************** */
+
+void
+Uint256::DivMod (const Uint256& a, const Uint256& b,
+                 Uint256& quot, Uint256& rem)
+{
+  CHECK (!b.IsZero ()) << "Division by zero";
+
+  if (b.FitsUint64 ())
+    {
+      Uint256 q = a;
+      const uint64_t r = DivSmall (q.limbs, b.limbs[0]);
+      quot = q;
+      rem = Uint256 (r);
+      return;
+    }
+
+  /* For larger divisors, we do binary long division over the significant
+     bits of a.  The partial remainder is always less than b before
+     shifting in the next bit, so if the shift overflows 256 bits,
+     the true value is larger than b and subtracting b (with wrap-around)
+     yields the correct result.  */
+  Uint256 q, r;
+  for (unsigned i = BitLength (a.limbs); i > 0; --i)
+    {
+      const unsigned bit = i - 1;
+      const bool next = (a.limbs[bit / 64] >> (bit % 64)) & 1;
+      const bool overflow = ShiftLeftOne (r.limbs, next);
+      if (overflow || r >= b)
+        {
+          r -= b;
+          q.limbs[bit / 64] |= static_cast<uint64_t> (1) << (bit % 64);
+        }
+    }
+
+  quot = q;
+  rem = r;
+}
+
+Uint256&
+Uint256::operator+= (const Uint256& other)
+{
+  bool carry = false;
+  for (size_t i = 0; i < limbs.size (); ++i)
+    {
+      const uint64_t sum = limbs[i] + other.limbs[i];
+      const uint64_t res = sum + (carry ? 1 : 0);
+      carry = (sum < limbs[i]) || (res < sum);
+      limbs[i] = res;
+    }
+  return *this;
+}
+
+Uint256&
+Uint256::operator-= (const Uint256& other)
+{
+  bool borrow = false;
+  for (size_t i = 0; i < limbs.size (); ++i)
+    {
+      const uint64_t diff = limbs[i] - other.limbs[i];
+      const uint64_t res = diff - (borrow ? 1 : 0);
+      borrow = (limbs[i] < other.limbs[i]) || (diff < res);
+      limbs[i] = res;
+    }
+  return *this;
+}
+
+Uint256&
+Uint256::operator*= (const Uint256& other)
+{
+  Limbs res = {};
+  for (size_t i = 0; i < limbs.size (); ++i)
+    {
+      uint64_t carry = 0;
+      for (size_t j = 0; i + j < limbs.size (); ++j)
+        {
+          const Uint128 cur = static_cast<Uint128> (limbs[i]) * other.limbs[j]
+                                + res[i + j] + carry;
+          res[i + j] = static_cast<uint64_t> (cur);
+          carry = static_cast<uint64_t> (cur >> 64);
+        }
+    }
+
+  limbs = res;
+  return *this;
+}
+
+Uint256&
+Uint256::operator/= (const Uint256& other)
+{
+  Uint256 rem;
+  DivMod (*this, other, *this, rem);
+  return *this;
+}
+
+Uint256&
+Uint256::operator%= (const Uint256& other)
+{
+  Uint256 quot;
+  DivMod (*this, other, quot, *this);
+  return *this;
+}
+
+int
+Uint256::Compare (const Uint256& a, const Uint256& b)
+{
+  for (size_t i = a.limbs.size (); i > 0; --i)
+    if (a.limbs[i - 1] != b.limbs[i - 1])
+      return a.limbs[i - 1] < b.limbs[i - 1] ? -1 : 1;
+  return 0;
+}
+
+std::ostream&
+operator<< (std::ostream& out, const Uint256& val)
+{
+  out << val.ToDecimal ();
+  return out;
+}
+
+/* ************************************************************************** */
+
+} // namespace ethutils
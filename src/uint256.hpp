@@ -0,0 +1,220 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef ETHUTILS_UINT256_HPP
+#define ETHUTILS_UINT256_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace ethutils
+{
+
+/**
+ * An unsigned 256-bit integer, as used for token amounts and IDs in
+ * the ABI.  It is stored as four 64-bit limbs, and can be converted
+ * directly from and to 32-byte big-endian ABI words, so that such values
+ * do not have to pass through a textual representation.
+ *
+ * Arithmetic wraps around modulo 2^256, like unchecked arithmetic in
+ * Solidity.  Division by zero CHECK-fails.
+ */
+class Uint256
+{
+
+public:
+
+  /** Size of the value in raw binary form (an ABI word).  */
+  static constexpr size_t BINARY_SIZE = 32;
+
+private:
+
+  /** The limbs, least significant first.  */
+  std::array<uint64_t, 4> limbs = {};
+
+public:
+
+  /**
+   * Constructs the value zero.
+   */
+  constexpr Uint256 () = default;
+
+  /**
+   * Constructs a value from a 64-bit integer.
+   */
+  explicit constexpr Uint256 (const uint64_t val)
+    : limbs({val, 0, 0, 0})
+  {}
+
+  Uint256 (const Uint256&) = default;
+  Uint256& operator= (const Uint256&) = default;
+
+  /**
+   * Loads a value from BINARY_SIZE big-endian bytes.
+   */
+  static Uint256 FromBinary (const unsigned char* bin);
+
+  /**
+   * Loads a value from a big-endian binary string, which must be
+   * exactly BINARY_SIZE bytes long.
+   */
+  static Uint256 FromBinary (std::string_view bin);
+
+  /**
+   * Stores the value as BINARY_SIZE big-endian bytes to out.
+   */
+  void ToBinary (unsigned char* out) const;
+
+  /**
+   * Returns the value as big-endian binary string of BINARY_SIZE bytes.
+   */
+  std::string ToBinary () const;
+
+  /**
+   * Parses a hex string with 0x prefix (and at most 64 digits, which may
+   * be in upper or lower case).  Returns false if the string is invalid.
+   */
+  static bool FromHex (std::string_view str, Uint256& out);
+
+  /**
+   * Parses a decimal string.  Returns false if the string is invalid
+   * or the value does not fit into 256 bits.
+   */
+  static bool FromDecimal (std::string_view str, Uint256& out);
+
+  /**
+   * Parses a string either as hex (if it has the 0x prefix) or
+   * decimal otherwise.
+   */
+  static bool Parse (std::string_view str, Uint256& out);
+
+  /**
+   * Returns the value as lower-case hex string with 0x prefix and without
+   * leading zeros (e.g. 0x0 or 0x1f).
+   */
+  std::string ToHex () const;
+
+  /**
+   * Returns the value as decimal string.
+   */
+  std::string ToDecimal () const;
+
+  /**
+   * Returns true if the value fits into uint64_t.
+   */
+  bool FitsUint64 () const;
+
+  /**
+   * Returns the low 64 bits of the value.
+   */
+  uint64_t
+  GetLow64 () const
+  {
+    return limbs[0];
+  }
+
+  bool
+  IsZero () const
+  {
+    return (limbs[0] | limbs[1] | limbs[2] | limbs[3]) == 0;
+  }
+
+  /**
+   * Divides a by b, and returns the quotient and remainder.
+   */
+  static void DivMod (const Uint256& a, const Uint256& b,
+                      Uint256& quot, Uint256& rem);
+
+  Uint256& operator+= (const Uint256& other);
+  Uint256& operator-= (const Uint256& other);
+  Uint256& operator*= (const Uint256& other);
+  Uint256& operator/= (const Uint256& other);
+  Uint256& operator%= (const Uint256& other);
+
+  friend Uint256
+  operator+ (Uint256 a, const Uint256& b)
+  {
+    return a += b;
+  }
+
+  friend Uint256
+  operator- (Uint256 a, const Uint256& b)
+  {
+    return a -= b;
+  }
+
+  friend Uint256
+  operator* (Uint256 a, const Uint256& b)
+  {
+    return a *= b;
+  }
+
+  friend Uint256
+  operator/ (Uint256 a, const Uint256& b)
+  {
+    return a /= b;
+  }
+
+  friend Uint256
+  operator% (Uint256 a, const Uint256& b)
+  {
+    return a %= b;
+  }
+
+  /**
+   * Compares two values, returning a negative number, zero or a positive
+   * number if a is less than, equal to or greater than b.
+   */
+  static int Compare (const Uint256& a, const Uint256& b);
+
+  friend bool
+  operator== (const Uint256& a, const Uint256& b)
+  {
+    return a.limbs == b.limbs;
+  }
+
+  friend bool
+  operator!= (const Uint256& a, const Uint256& b)
+  {
+    return !(a == b);
+  }
+
+  friend bool
+  operator< (const Uint256& a, const Uint256& b)
+  {
+    return Compare (a, b) < 0;
+  }
+
+  friend bool
+  operator<= (const Uint256& a, const Uint256& b)
+  {
+    return Compare (a, b) <= 0;
+  }
+
+  friend bool
+  operator> (const Uint256& a, const Uint256& b)
+  {
+    return Compare (a, b) > 0;
+  }
+
+  friend bool
+  operator>= (const Uint256& a, const Uint256& b)
+  {
+    return Compare (a, b) >= 0;
+  }
+
+  /**
+   * Writes the value in decimal.
+   */
+  friend std::ostream& operator<< (std::ostream& out, const Uint256& val);
+
+};
+
+} // namespace ethutils
+
+#endif // ETHUTILS_UINT256_HPP
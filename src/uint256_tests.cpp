@@ -0,0 +1,192 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "uint256.hpp"
+
+#include "hexutils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <glog/logging.h>
+
+#include <sstream>
+#include <vector>
+
+namespace ethutils
+{
+namespace
+{
+
+/* Expected values in these tests have been computed with Python.  */
+
+/** 2^256 - 1 in decimal.  */
+const std::string MAX_DECIMAL
+    = "115792089237316195423570985008687907853"
+      "269984665640564039457584007913129639935";
+
+/**
+ * Parses a value in hex or decimal, which must be valid.
+ */
+Uint256
+Val (const std::string& str)
+{
+  Uint256 res;
+  CHECK (Uint256::Parse (str, res)) << str;
+  return res;
+}
+
+class Uint256Tests : public testing::Test
+{
+
+protected:
+
+  const Uint256 a = Val ("0xf0e1d2c3b4a5968778695a4b3c2d1e0f"
+                           "00112233445566778899aabbccddeeff");
+  const Uint256 b = Val ("0x1234567890abcdef1234567890abcdef12");
+
+};
+
+TEST_F (Uint256Tests, Binary)
+{
+  const std::string hex = "f0e1d2c3b4a5968778695a4b3c2d1e0f"
+                          "00112233445566778899aabbccddeeff";
+  std::string bin;
+  ASSERT_TRUE (Unhexlify (hex, bin));
+
+  EXPECT_EQ (Uint256::FromBinary (bin), a);
+  EXPECT_EQ (Hexlify (a.ToBinary ()), hex);
+
+  unsigned char buf[Uint256::BINARY_SIZE];
+  Uint256 (0x1234).ToBinary (buf);
+  EXPECT_EQ (Hexlify (std::string (reinterpret_cast<char*> (buf),
+                                   sizeof (buf))),
+             "00000000000000000000000000000000"
+             "00000000000000000000000000001234");
+  EXPECT_EQ (Uint256::FromBinary (buf), Uint256 (0x1234));
+
+  EXPECT_DEATH (Uint256::FromBinary (std::string_view ("abc")),
+                "Invalid binary size");
+}
+
+TEST_F (Uint256Tests, Hex)
+{
+  EXPECT_EQ (Uint256 ().ToHex (), "0x0");
+  EXPECT_EQ (Uint256 (0x1f).ToHex (), "0x1f");
+  EXPECT_EQ (Uint256 (0x100).ToHex (), "0x100");
+  EXPECT_EQ (b.ToHex (), "0x1234567890abcdef1234567890abcdef12");
+
+  Uint256 val;
+  ASSERT_TRUE (Uint256::FromHex ("0xABcd", val));
+  EXPECT_EQ (val, Uint256 (0xabcd));
+  ASSERT_TRUE (Uint256::FromHex ("0x00000000000000000000000000000000"
+                                 "000000000000000000000000000000FF", val));
+  EXPECT_EQ (val, Uint256 (0xff));
+  ASSERT_TRUE (Uint256::FromHex ("0x" + std::string (64, 'f'), val));
+  EXPECT_EQ (val.ToDecimal (), MAX_DECIMAL);
+
+  const std::vector<std::string> invalid
+      = {"", "0x", "12", "0xg", "0x 1", "0x1" + std::string (64, '0')};
+  for (const auto& str : invalid)
+    EXPECT_FALSE (Uint256::FromHex (str, val)) << str;
+}
+
+TEST_F (Uint256Tests, Decimal)
+{
+  EXPECT_EQ (Uint256 ().ToDecimal (), "0");
+  EXPECT_EQ (Uint256 (UINT64_MAX).ToDecimal (), "18446744073709551615");
+  EXPECT_EQ (Uint256 (10'000'000'000'000'000'000ull).ToDecimal (),
+             "10000000000000000000");
+  EXPECT_EQ (a.ToDecimal (),
+             "10895407889250582725092181034612179380"
+             "2419606317615676751788436839855481024255");
+  EXPECT_EQ (b.ToDecimal (), "6194651443238720698616183149936654544658");
+
+  std::ostringstream out;
+  out << b;
+  EXPECT_EQ (out.str (), b.ToDecimal ());
+
+  Uint256 val;
+  ASSERT_TRUE (Uint256::FromDecimal ("000123", val));
+  EXPECT_EQ (val, Uint256 (123));
+  ASSERT_TRUE (Uint256::FromDecimal (MAX_DECIMAL, val));
+  EXPECT_EQ (val.ToHex (), "0x" + std::string (64, 'f'));
+  ASSERT_TRUE (Uint256::FromDecimal (a.ToDecimal (), val));
+  EXPECT_EQ (val, a);
+
+  for (const char* str : {"", "-1", "1.5", "0x10", " 1",
+                          "115792089237316195423570985008687907853"
+                          "269984665640564039457584007913129639936"})
+    EXPECT_FALSE (Uint256::FromDecimal (str, val)) << str;
+}
+
+TEST_F (Uint256Tests, AddSub)
+{
+  EXPECT_EQ (a + a, Val ("0xe1c3a587694b2d0ef0d2b496785a3c1e"
+                           "0022446688aaccef1133557799bbddfe"));
+  EXPECT_EQ (a + a - a, a);
+  EXPECT_EQ (Uint256 (UINT64_MAX) + Uint256 (1), Val ("0x10000000000000000"));
+  EXPECT_EQ (Val (MAX_DECIMAL) + Uint256 (1), Uint256 ());
+  EXPECT_EQ (Uint256 () - Uint256 (1), Val (MAX_DECIMAL));
+  EXPECT_EQ (b - a,
+             Val ("68380103448103681726491746625661140"
+                  "57045029791263607986285330317994303160339"));
+
+  Uint256 val(5);
+  val += Uint256 (10);
+  val -= Uint256 (3);
+  EXPECT_EQ (val, Uint256 (12));
+}
+
+TEST_F (Uint256Tests, MulDiv)
+{
+  EXPECT_EQ (a * b, Val ("0x1d939464463daeddef4729db9f78cbc9"
+                           "63c467121ebbacbb95f6994450eddeee"));
+  EXPECT_EQ (Uint256 (UINT64_MAX) * Uint256 (UINT64_MAX),
+             Val ("0xfffffffffffffffe0000000000000001"));
+
+  EXPECT_EQ (a / b, Val ("17588411533860551605213162920964027305"));
+  EXPECT_EQ (a % b, Val ("3646781913935719306508023157092827137565"));
+  EXPECT_EQ (a / Uint256 (10),
+             Val ("10895407889250582725092181034612179380"
+                  "241960631761567675178843683985548102425"));
+  EXPECT_EQ (a % Uint256 (10), Uint256 (5));
+  EXPECT_EQ (b / a, Uint256 ());
+  EXPECT_EQ (b % a, b);
+  EXPECT_EQ (a / a, Uint256 (1));
+
+  /* Divisor with the top bit set, where the partial remainder overflows
+     256 bits during long division.  */
+  const Uint256 max = Val (MAX_DECIMAL);
+  const Uint256 top = Val ("0x8" + std::string (63, '0'));
+  EXPECT_EQ (max / top, Uint256 (1));
+  EXPECT_EQ (max % top, top - Uint256 (1));
+  EXPECT_EQ (max / (top + Uint256 (1)), Uint256 (1));
+
+  Uint256 quot, rem;
+  Uint256::DivMod (a, b, quot, rem);
+  EXPECT_EQ (quot * b + rem, a);
+
+  EXPECT_DEATH (a / Uint256 (), "Division by zero");
+}
+
+TEST_F (Uint256Tests, Compare)
+{
+  EXPECT_TRUE (b < a);
+  EXPECT_TRUE (b <= a);
+  EXPECT_TRUE (a > b);
+  EXPECT_TRUE (a >= a);
+  EXPECT_FALSE (a < a);
+  EXPECT_TRUE (Uint256 (1) < Val ("0x10000000000000000"));
+  EXPECT_NE (a, b);
+  EXPECT_EQ (Uint256::Compare (a, a), 0);
+
+  EXPECT_TRUE (Uint256 (UINT64_MAX).FitsUint64 ());
+  EXPECT_FALSE (b.FitsUint64 ());
+  EXPECT_EQ (b.GetLow64 (), 0x34567890abcdef12);
+  EXPECT_TRUE (Uint256 ().IsZero ());
+  EXPECT_FALSE (a.IsZero ());
+}
+
+} // anonymous namespace
+} // namespace ethutils